@@ -52,6 +52,7 @@ int main(int argc, const char* argv[]) {
         modChooser.AddMode("eval-metrics", mode_eval_metrics, "evaluate metrics for model");
         modChooser.AddMode("metadata", mode_metadata, "get/set/dump metainfo fields from model");
         modChooser.AddMode("model-sum", mode_model_sum, "sum model files");
+        modChooser.AddMode("quantize", mode_quantize, "quantize pool and save it in quantized pool format");
         modChooser.AddMode("run-worker", mode_run_worker, "run worker");
         modChooser.AddMode("roc", mode_roc, "evaluate data for roc curve");
         modChooser.DisableSvnRevisionOption();
@@ -2,6 +2,7 @@
 
 #include <catboost/libs/algo/plot.h>
 #include <catboost/libs/app_helpers/proceed_pool_in_blocks.h>
+#include <catboost/libs/data_util/line_data_reader.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/labels/label_converter.h>
 #include <catboost/libs/labels/label_helper_builder.h>
@@ -156,6 +157,12 @@ int mode_eval_metrics(int argc, const char* argv[]) {
         metrics
     );
 
+    CB_ENSURE(
+        !(plotCalcer.HasNonAdditiveMetric() && calcOnParts) || !IsSinglePassPath(params.InputPath),
+        "--calc-on-parts with non-additive metrics needs several passes over input data, but data from "
+        << params.InputPath << " can be read only once"
+    );
+
     TVector<TProcessedDataProvider> datasetParts;
     if (plotCalcer.HasAdditiveMetric()) {
         ReadAndProceedPoolInBlocks(params, plotParams.ReadBlockSize, [&](TDataProviderPtr datasetPart) {
@@ -0,0 +1,201 @@
+#include "modes.h"
+
+#include <catboost/libs/data_new/borders_io.h>
+#include <catboost/libs/data_new/load_data.h>
+#include <catboost/libs/data_new/quantization.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/restorable_rng.h>
+#include <catboost/libs/logging/logging.h>
+#include <catboost/libs/model/model.h>
+#include <catboost/libs/options/analytical_mode_params.h>
+#include <catboost/libs/options/binarization_options.h>
+#include <catboost/libs/options/system_options.h>
+#include <catboost/libs/quantized_pool/quantized.h>
+#include <catboost/libs/quantized_pool/serialization.h>
+
+#include <library/getopt/small/last_getopt.h>
+
+#include <util/generic/maybe.h>
+#include <util/generic/serialized_enum.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+#include <util/string/iterator.h>
+#include <util/string/join.h>
+#include <util/system/info.h>
+
+
+using namespace NCB;
+
+
+struct TQuantizeParams {
+    TPathWithScheme InputPath;
+    NCatboostOptions::TDsvPoolFormatParams DsvPoolFormatParams;
+    TString OutputPath;
+    TVector<ui32> IgnoredFeatures;
+    NCatboostOptions::TBinarizationOptions FloatFeaturesBinarization{EBorderSelectionType::GreedyLogSum, 254, ENanMode::Min};
+    TString InputBordersFile;
+    TString ModelFileName;
+    EModelType ModelFormat = EModelType::CatboostBinary;
+    TString UsedRamLimit;
+    TMaybe<ui32> BordersSampleSize;
+    ui64 RandomSeed = 0;
+    int ThreadCount = NSystemInfo::CachedNumberOfCpus();
+
+    void BindParserOpts(NLastGetopt::TOpts& parser) {
+        parser.AddLongOption('f', "input-path", "input pool path")
+            .RequiredArgument("[SCHEME://]PATH")
+            .Required()
+            .Handler1T<TStringBuf>([this](const TStringBuf& str) {
+                InputPath = TPathWithScheme(str, "dsv");
+            });
+        BindDsvPoolFormatParams(&parser, &DsvPoolFormatParams);
+        parser.AddLongOption('o', "output-path", "output quantized pool path")
+            .RequiredArgument("PATH")
+            .StoreResult(&OutputPath)
+            .DefaultValue("pool.quantized");
+        parser.AddLongOption('I', "ignore-features", "don't use the specified features. Example: -I 4:78-89:312")
+            .RequiredArgument("INDEXES")
+            .Handler1T<TStringBuf>([this](const TStringBuf& str) {
+                for (const auto& range : StringSplitter(str).Split(':')) {
+                    const auto token = range.Token();
+                    const ui32 begin = FromString<ui32>(token.Before('-'));
+                    const ui32 end = FromString<ui32>(token.After('-')) + 1;
+                    for (ui32 featureIdx = begin; featureIdx < end; ++featureIdx) {
+                        IgnoredFeatures.push_back(featureIdx);
+                    }
+                }
+            });
+        parser.AddLongOption('x', "border-count", "count of borders per float feature. Should be in range [1, 255]")
+            .RequiredArgument("int")
+            .Handler1T<ui32>([this](ui32 count) {
+                FloatFeaturesBinarization.BorderCount = count;
+            });
+        parser.AddLongOption("feature-border-type", TString::Join("Must be one of: ", GetEnumAllNames<EBorderSelectionType>()))
+            .RequiredArgument("border-type")
+            .Handler1T<EBorderSelectionType>([this](const auto type) {
+                FloatFeaturesBinarization.BorderSelectionType = type;
+            });
+        parser.AddLongOption("nan-mode", TString::Join("Must be one of: ", GetEnumAllNames<ENanMode>(), " Default: ", ToString(ENanMode::Min)))
+            .RequiredArgument("nan-mode")
+            .Handler1T<ENanMode>([this](const auto nanMode) {
+                FloatFeaturesBinarization.NanMode = nanMode;
+            });
+        parser.AddLongOption("input-borders-file", "file with borders")
+            .RequiredArgument("PATH")
+            .StoreResult(&InputBordersFile);
+        parser.AddLongOption('m', "model-file", "use borders of float features from this model")
+            .RequiredArgument("PATH")
+            .StoreResult(&ModelFileName);
+        parser.AddLongOption("model-format", "model format for --model-file")
+            .RequiredArgument("model-format")
+            .StoreResult(&ModelFormat);
+        parser.AddLongOption("used-ram-limit", "Try to limit used memory. Allowed suffixes: GB, MB, KB in different cases")
+            .RequiredArgument("TARGET_RSS")
+            .StoreResult(&UsedRamLimit);
+        parser.AddLongOption("borders-sample-size", "limit number of objects sampled to calculate borders (default: same sample size as in fit)")
+            .RequiredArgument("count")
+            .Handler1T<ui32>([this](ui32 sampleSize) {
+                BordersSampleSize = sampleSize;
+            });
+        parser.AddLongOption('r', "random-seed", "random seed used for border calculation subsampling")
+            .RequiredArgument("count")
+            .StoreResult(&RandomSeed);
+        parser.AddLongOption('T', "thread-count", "worker thread count (default: core count)")
+            .RequiredArgument("count")
+            .StoreResult(&ThreadCount);
+    }
+};
+
+static void SetBordersFromModel(const TFullModel& model, TQuantizedFeaturesInfo* quantizedFeaturesInfo) {
+    const auto& featuresLayout = *quantizedFeaturesInfo->GetFeaturesLayout();
+    for (const auto& floatFeature : model.ObliviousTrees.FloatFeatures) {
+        if (!floatFeature.UsedInModel()) {
+            continue;
+        }
+        CB_ENSURE(
+            (ui32)floatFeature.FlatFeatureIndex < featuresLayout.GetExternalFeatureCount() &&
+            featuresLayout.GetExternalFeatureType(floatFeature.FlatFeatureIndex) == EFeatureType::Float,
+            "Model float feature #" << floatFeature.FlatFeatureIndex << " is not a float feature in the pool"
+        );
+        const auto floatFeatureIdx = featuresLayout.GetInternalFeatureIdx<EFeatureType::Float>(
+            floatFeature.FlatFeatureIndex
+        );
+
+        ENanMode nanMode = ENanMode::Forbidden;
+        if (floatFeature.HasNans) {
+            nanMode = (floatFeature.NanValueTreatment == NCatBoostFbs::ENanValueTreatment_AsTrue) ?
+                ENanMode::Max :
+                ENanMode::Min;
+        }
+        quantizedFeaturesInfo->SetBorders(floatFeatureIdx, TVector<float>(floatFeature.Borders));
+        quantizedFeaturesInfo->SetNanMode(floatFeatureIdx, nanMode);
+    }
+}
+
+int mode_quantize(int argc, const char* argv[]) {
+    TQuantizeParams params;
+
+    auto parser = NLastGetopt::TOpts();
+    parser.AddHelpOption();
+    params.BindParserOpts(parser);
+    parser.SetFreeArgsNum(0);
+    NLastGetopt::TOptsParseResult parserResult{&parser, argc, argv};
+
+    CB_ENSURE(
+        params.InputBordersFile.empty() || params.ModelFileName.empty(),
+        "Only one of --input-borders-file and --model-file can be specified"
+    );
+    params.FloatFeaturesBinarization.Validate();
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(params.ThreadCount - 1);
+
+    // same options as in fit on CPU
+    TQuantizationOptions quantizationOptions;
+    quantizationOptions.GpuCompatibleFormat = false;
+    if (!params.UsedRamLimit.empty()) {
+        quantizationOptions.CpuRamLimit = ParseMemorySizeDescription(params.UsedRamLimit);
+    }
+    if (params.BordersSampleSize) {
+        quantizationOptions.MaxSubsetSizeForStreamingBuildBorders = *params.BordersSampleSize;
+    }
+
+    TRestorableFastRng64 rand(params.RandomSeed);
+
+    // float features are quantized while the pool is read, raw values are never stored for the whole pool
+    TDataProviderPtr quantizedDataProvider = ReadAndQuantizeDataset(
+        params.InputPath,
+        /*pairsFilePath*/ TPathWithScheme(),
+        /*groupWeightsFilePath*/ TPathWithScheme(),
+        params.DsvPoolFormatParams,
+        params.IgnoredFeatures,
+        EObjectsOrder::Undefined,
+        quantizationOptions,
+        /*quantizedFeaturesInfo*/ nullptr,
+        params.FloatFeaturesBinarization,
+        [&] (TQuantizedFeaturesInfo* quantizedFeaturesInfo) {
+            if (!params.InputBordersFile.empty()) {
+                LoadBordersAndNanModesFromFromFileInMatrixnetFormat(
+                    params.InputBordersFile,
+                    quantizedFeaturesInfo
+                );
+            } else if (!params.ModelFileName.empty()) {
+                SetBordersFromModel(ReadModel(params.ModelFileName, params.ModelFormat), quantizedFeaturesInfo);
+            }
+        },
+        &rand,
+        &localExecutor
+    );
+
+    const TQuantizedPool quantizedPool = ConvertToQuantizedPool(
+        *quantizedDataProvider->CastMoveTo<TQuantizedObjectsDataProvider>(),
+        &localExecutor
+    );
+
+    TFileOutput output(params.OutputPath);
+    SaveQuantizedPool(quantizedPool, &output);
+
+    CATBOOST_INFO_LOG << "Quantized pool saved to " << params.OutputPath
+        << ", use it as quantized://" << params.OutputPath << Endl;
+    return 0;
+}
@@ -47,25 +47,29 @@ TVector<TVector<double>> ApplyModelMulti(
         blockParams.SetBlockCount(effectiveBlockCount);
 
         const auto featuresLayout = rawObjectsData->GetFeaturesLayout();
-        const auto getFeatureDataPtr = [&](ui32 flatFeatureIdx) -> const float* {
-            return GetRawFeatureDataBeginPtr(
-                *rawObjectsData,
-                *featuresLayout,
-                consecutiveSubsetBegin,
-                flatFeatureIdx);
-        };
         const auto applyOnBlock = [&](int blockId) {
             TVector<TConstArrayRef<float>> repackedFeatures(model.ObliviousTrees.GetFlatFeatureVectorExpectedSize());
+            TVector<TVector<float>> sparseFeaturesBuffers(model.ObliviousTrees.GetFlatFeatureVectorExpectedSize());
             const int blockFirstIdx = blockParams.FirstId + blockId * blockParams.GetBlockSize();
             const int blockLastIdx = Min(blockParams.LastId, blockFirstIdx + blockParams.GetBlockSize());
             const int blockSize = blockLastIdx - blockFirstIdx;
+            const auto getFeatureData = [&](ui32 flatFeatureIdx, TVector<float>* sparseDataBuffer) {
+                return GetRawFeatureData(
+                    *rawObjectsData,
+                    *featuresLayout,
+                    consecutiveSubsetBegin,
+                    flatFeatureIdx,
+                    blockFirstIdx,
+                    blockSize,
+                    sparseDataBuffer);
+            };
             if (columnReorderMap.empty()) {
                 for (size_t i = 0; i < model.ObliviousTrees.GetFlatFeatureVectorExpectedSize(); ++i) {
-                    repackedFeatures[i] = MakeArrayRef(getFeatureDataPtr(i) + blockFirstIdx, blockSize);
+                    repackedFeatures[i] = getFeatureData(i, &sparseFeaturesBuffers[i]);
                 }
             } else {
                 for (const auto& [origIdx, sourceIdx] : columnReorderMap) {
-                    repackedFeatures[origIdx] = MakeArrayRef(getFeatureDataPtr(sourceIdx) + blockFirstIdx, blockSize);
+                    repackedFeatures[origIdx] = getFeatureData(sourceIdx, &sparseFeaturesBuffers[origIdx]);
                 }
             }
             model.CalcFlatTransposed(
@@ -214,25 +218,28 @@ TModelCalcerOnPool::TModelCalcerOnPool(
     const ui32 consecutiveSubsetBegin = GetConsecutiveSubsetBegin(*RawObjectsData);
     const auto& featuresLayout = *RawObjectsData->GetFeaturesLayout();
 
-    auto getFeatureDataBeginPtr = [&](ui32 flatFeatureIdx) -> const float* {
-        return GetRawFeatureDataBeginPtr(
-            *RawObjectsData,
-            featuresLayout,
-            consecutiveSubsetBegin,
-            flatFeatureIdx);
-    };
-
     executor->ExecRange([&](int blockId) {
         TVector<TConstArrayRef<float>> repackedFeatures(Model->ObliviousTrees.GetFlatFeatureVectorExpectedSize());
+        TVector<TVector<float>> sparseFeaturesBuffers(Model->ObliviousTrees.GetFlatFeatureVectorExpectedSize());
         const int blockFirstId = BlockParams.FirstId + blockId * BlockParams.GetBlockSize();
         const int blockLastId = Min(BlockParams.LastId, blockFirstId + BlockParams.GetBlockSize());
+        auto getFeatureData = [&](ui32 flatFeatureIdx, TVector<float>* sparseDataBuffer) {
+            return GetRawFeatureData(
+                *RawObjectsData,
+                featuresLayout,
+                consecutiveSubsetBegin,
+                flatFeatureIdx,
+                blockFirstId,
+                blockLastId - blockFirstId,
+                sparseDataBuffer);
+        };
         if (columnReorderMap.empty()) {
             for (ui32 i = 0; i < Model->ObliviousTrees.GetFlatFeatureVectorExpectedSize(); ++i) {
-                repackedFeatures[i] = MakeArrayRef(getFeatureDataBeginPtr(i) + blockFirstId, blockLastId - blockFirstId);
+                repackedFeatures[i] = getFeatureData(i, &sparseFeaturesBuffers[i]);
             }
         } else {
             for (const auto& [origIdx, sourceIdx] : columnReorderMap) {
-                repackedFeatures[origIdx] = MakeArrayRef(getFeatureDataBeginPtr(sourceIdx) + blockFirstId, blockLastId - blockFirstId);
+                repackedFeatures[origIdx] = getFeatureData(sourceIdx, &sparseFeaturesBuffers[origIdx]);
             }
         }
         auto floatAccessor = [&repackedFeatures](const TFloatFeature& floatFeature, size_t index) -> float {
@@ -473,11 +473,14 @@ void CalcLeafValues(
     const IDerCalcer& error,
     const TFold& fold,
     const TSplitTree& tree,
+    bool calcTestIndices,
     TLearnContext* ctx,
     TVector<TVector<double>>* leafValues,
     TVector<TIndexType>* indices
 ) {
-    *indices = BuildIndices(fold, tree, data.Learn, data.Test, ctx->LocalExecutor);
+    const TConstArrayRef<NCB::TTrainingForCPUDataProviderPtr> testData
+        = calcTestIndices ? TConstArrayRef<NCB::TTrainingForCPUDataProviderPtr>(data.Test) : TConstArrayRef<NCB::TTrainingForCPUDataProviderPtr>();
+    *indices = BuildIndices(fold, tree, data.Learn, testData, ctx->LocalExecutor);
     const int approxDimension = ctx->LearnProgress.AveragingFold.GetApproxDimension();
     Y_VERIFY(fold.GetLearnSampleCount() == data.Learn->GetObjectCount());
     const int leafCount = tree.GetLeafCount();
@@ -524,3 +527,90 @@ void CalcApproxForLeafStruct(
         }
     }, 0, fold.BodyTailArr.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
 }
+
+bool CanUpdateFoldApproxFused(const TFold& fold, const IDerCalcer& error, const TLearnContext& ctx) {
+    return ctx.Params.SystemOptions->IsSingleHost()
+        && IsPlainMode(ctx.Params.BoostingOptions->BoostingType)
+        && !ctx.Params.BoostingOptions->ApproxOnFullHistory
+        && error.GetErrorType() == EErrorType::PerObjectError
+        && fold.GetApproxDimension() == 1
+        && fold.BodyTailArr.ysize() == 1
+        && fold.BodyTailArr[0].BodyFinish == fold.BodyTailArr[0].TailFinish;
+}
+
+template <bool StoreExpApprox>
+static void UpdateFoldApproxBlock(
+    const NPar::TLocalExecutor::TExecRangeParams& blockParams,
+    int blockIdx,
+    const IDerCalcer& error,
+    const double* leafValues,
+    const TIndexType* indices,
+    const double* approxDeltas,
+    double learningRate,
+    const float* targets,
+    const float* weights,
+    double* approxes,
+    double* weightedDerivatives // nullptr if not needed
+) {
+    const int blockStart = blockIdx * blockParams.GetBlockSize();
+    const int nextBlockStart = Min<int>(blockStart + blockParams.GetBlockSize(), blockParams.LastId);
+    for (int doc = blockStart; doc < nextBlockStart; ++doc) {
+        const double approxDelta = UpdateApprox<StoreExpApprox>(approxDeltas[doc], leafValues[indices[doc]]);
+        approxes[doc] = UpdateApprox<StoreExpApprox>(approxes[doc], ApplyLearningRate<StoreExpApprox>(approxDelta, learningRate));
+    }
+    if (weightedDerivatives != nullptr) {
+        error.CalcFirstDerRange(blockStart, nextBlockStart - blockStart, approxes, nullptr, targets, weights, weightedDerivatives);
+    }
+}
+
+void CalcApproxAndUpdateFoldFused(
+    const NCB::TTrainingForCPUDataProviders& data,
+    const IDerCalcer& error,
+    const TSplitTree& tree,
+    ui64 randomSeed,
+    bool calcDerivatives,
+    TLearnContext* ctx,
+    TFold* fold
+) {
+    Y_ASSERT(CanUpdateFoldApproxFused(*fold, error, *ctx));
+    const TVector<TIndexType> indices = BuildIndices(*fold, tree, data.Learn, data.Test, ctx->LocalExecutor);
+    const int leafCount = tree.GetLeafCount();
+    TFold::TBodyTail& bt = fold->BodyTailArr[0];
+    const ui64 bodyTailRandomSeed = GenRandUI64Vector(1, randomSeed)[0]; // as in CalcApproxForLeafStruct
+
+    TVector<TDers> weightedDers;
+    weightedDers.yresize(APPROX_BLOCK_SIZE * CB_THREAD_LIMIT); // iteration scratch space
+
+    const auto treeLearnerOptions = ctx->Params.ObliviousTreeOptions.Get();
+    const int gradientIterations = static_cast<int>(treeLearnerOptions.LeavesEstimationIterations);
+    const auto estimationMethod = treeLearnerOptions.LeavesEstimationMethod;
+
+    TVector<TSum> buckets(leafCount, TSum(gradientIterations)); // iteration scratch space
+    TArray2D<double> pairwiseBuckets; // iteration scratch space
+    TVector<double> curLeafValues; // iteration scratch space
+    TVector<double> approxDelta(bt.TailFinish, GetNeutralApprox(error.GetIsExpApprox()));
+    for (int it = 0; it < gradientIterations; ++it) {
+        UpdateBucketsSimple(indices, *fold, bt, bt.Approx[0], approxDelta, error, bt.BodyFinish, bt.BodyQueryFinish, it, estimationMethod, ctx->Params, bodyTailRandomSeed, ctx->LocalExecutor, &buckets, &pairwiseBuckets, &weightedDers);
+        CalcMixedModelSimple(buckets, pairwiseBuckets, it, ctx->Params, bt.BodySumWeight, bt.BodyFinish, &curLeafValues);
+        if (it + 1 < gradientIterations) {
+            UpdateApproxDeltas(error.GetIsExpApprox(), indices, bt.TailFinish, ctx->LocalExecutor, &curLeafValues, &approxDelta);
+        }
+    }
+
+    ExpApproxIf(error.GetIsExpApprox(), &curLeafValues);
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, bt.TailFinish);
+    blockParams.SetBlockSize(1000); // same blocks as in CalcWeightedDerivatives
+    const double learningRate = ctx->Params.BoostingOptions->LearningRate;
+    double* weightedDerivatives = calcDerivatives ? bt.WeightedDerivatives[0].data() : nullptr;
+    const float* weights = fold->GetLearnWeights().empty() ? nullptr : fold->GetLearnWeights().data();
+    ctx->LocalExecutor->ExecRange([&](int blockIdx) {
+        if (error.GetIsExpApprox()) {
+            UpdateFoldApproxBlock</*StoreExpApprox*/ true>(blockParams, blockIdx, error, curLeafValues.data(), indices.data(), approxDelta.data(), learningRate,
+                fold->LearnTarget.data(), weights, bt.Approx[0].data(), weightedDerivatives);
+        } else {
+            UpdateFoldApproxBlock</*StoreExpApprox*/ false>(blockParams, blockIdx, error, curLeafValues.data(), indices.data(), approxDelta.data(), learningRate,
+                fold->LearnTarget.data(), weights, bt.Approx[0].data(), weightedDerivatives);
+        }
+    }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
+    bt.AreWeightedDerivativesUpToDate = calcDerivatives;
+}
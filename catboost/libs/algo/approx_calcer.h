@@ -49,11 +49,13 @@ void CalcMixedModelSimple(
     TVector<double>* leafValues
 );
 
+// indices are calculated for test documents only if calcTestIndices is set
 void CalcLeafValues(
     const NCB::TTrainingForCPUDataProviders& data,
     const IDerCalcer& error,
     const TFold& fold,
     const TSplitTree& tree,
+    bool calcTestIndices,
     TLearnContext* ctx,
     TVector<TVector<double>>* leafValues,
     TVector<TIndexType>* indices
@@ -69,3 +71,18 @@ void CalcApproxForLeafStruct(
     TLearnContext* ctx,
     TVector<TVector<TVector<double>>>* approxesDelta // [bodyTailId][approxDim][docIdxInPermuted]
 );
+
+bool CanUpdateFoldApproxFused(const TFold& fold, const IDerCalcer& error, const TLearnContext& ctx);
+
+// Same as CalcApproxForLeafStruct followed by UpdateBodyTailApprox, but the last leaf estimation iteration,
+// the learning rate step and, if calcDerivatives, derivatives for the next tree are done in one pass
+// over each block of documents. Only for folds with CanUpdateFoldApproxFused.
+void CalcApproxAndUpdateFoldFused(
+    const NCB::TTrainingForCPUDataProviders& data,
+    const IDerCalcer& error,
+    const TSplitTree& tree,
+    ui64 randomSeed,
+    bool calcDerivatives,
+    TLearnContext* ctx,
+    TFold* fold
+);
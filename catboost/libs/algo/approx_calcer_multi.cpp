@@ -5,30 +5,61 @@
 #include "approx_updater_helpers.h"
 #include "error_functions.h"
 
+// Upper bound on memory for per-block bucket sums in UpdateBucketsMulti
+constexpr size_t MAX_BLOCK_BUCKETS_MULTI_SIZE = 256 << 20;
+constexpr int MIN_BLOCK_SIZE_FOR_UPDATE_BUCKETS_MULTI = 1000;
+
+int GetBlockCountForUpdateBucketsMulti(int sampleCount, int leafCount, int approxDimension, EHessianType hessianType) {
+    const size_t bucketSize = sizeof(double) * (approxDimension + CalcInternalDer2DataSize(hessianType, approxDimension));
+    const int maxBlockCountForMemory = Max<size_t>(1, MAX_BLOCK_BUCKETS_MULTI_SIZE / (bucketSize * leafCount));
+    const int maxBlockCountForSamples = Max(1, sampleCount / MIN_BLOCK_SIZE_FOR_UPDATE_BUCKETS_MULTI);
+    return Min(CB_THREAD_LIMIT, maxBlockCountForMemory, maxBlockCountForSamples);
+}
+
 void UpdateApproxDeltasMulti(
     bool storeExpApprox,
     const TVector<TIndexType>& indices,
     int docCount,
+    NPar::TLocalExecutor* localExecutor,
     TVector<TVector<double>>* leafValues, //leafValues[dimension][bucketId]
     TVector<TVector<double>>* resArr
 ) {
-    if (storeExpApprox) {
+    for (int dim = 0; dim < leafValues->ysize(); ++dim) {
+        ExpApproxIf(storeExpApprox, &(*leafValues)[dim]);
+    }
+
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, docCount);
+    blockParams.SetBlockSize(1000);
+    const auto updateBlock = [&] (auto storeExpApproxConst, int blockIdx) {
+        const int blockStart = blockIdx * blockParams.GetBlockSize();
+        const int nextBlockStart = Min(docCount, blockStart + blockParams.GetBlockSize());
         for (int dim = 0; dim < leafValues->ysize(); ++dim) {
-            ExpApproxIf(storeExpApprox, &(*leafValues)[dim]);
-            for (int z = 0; z < docCount; ++z) {
-                (*resArr)[dim][z] = UpdateApprox</*StoreExpApprox*/ true>((*resArr)[dim][z], (*leafValues)[dim][indices[z]]);
+            const double* leafValuesData = (*leafValues)[dim].data();
+            double* resArrData = (*resArr)[dim].data();
+            for (int z = blockStart; z < nextBlockStart; ++z) {
+                resArrData[z] = UpdateApprox<decltype(storeExpApproxConst)::value>(resArrData[z], leafValuesData[indices[z]]);
             }
         }
+    };
+    if (storeExpApprox) {
+        localExecutor->ExecRange([&] (int blockIdx) {
+            updateBlock(std::true_type(), blockIdx);
+        }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
     } else {
-        for (int dim = 0; dim < leafValues->ysize(); ++dim) {
-            ExpApproxIf(storeExpApprox, &(*leafValues)[dim]);
-            for (int z = 0; z < docCount; ++z) {
-                (*resArr)[dim][z] = UpdateApprox</*StoreExpApprox*/ false>((*resArr)[dim][z], (*leafValues)[dim][indices[z]]);
-            }
-        }
+        localExecutor->ExecRange([&] (int blockIdx) {
+            updateBlock(std::false_type(), blockIdx);
+        }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
     }
 }
 
+namespace {
+    // Buffers reused between gradient iterations of leaf estimation
+    struct TLeafEstimationBuffersMulti {
+        TVector<TVector<TSumMulti>> BlockBuckets; // [blockId][leafId]
+        TVector<TVector<double>> CurLeafValues; // [dim][leafId]
+    };
+}
+
 template <typename TCalcModel, typename TAddSampleToBucket>
 void CalcApproxDeltaIterationMulti(
     TCalcModel CalcModel,
@@ -40,21 +71,28 @@ void CalcApproxDeltaIterationMulti(
     const IDerCalcer& error,
     int iteration,
     float l2Regularizer,
+    NPar::TLocalExecutor* localExecutor,
+    TLeafEstimationBuffersMulti* buffers,
     TVector<TSumMulti>* buckets,
     TVector<TVector<double>>* resArr,
     TVector<TVector<double>>* sumLeafValues
 ) {
-    UpdateBucketsMulti(AddSampleToBucket, indices, target, weight, bt.Approx, *resArr, error, bt.BodyFinish, iteration, buckets);
+    UpdateBucketsMulti(AddSampleToBucket, indices, target, weight, bt.Approx, *resArr, error, bt.BodyFinish, iteration,
+                       localExecutor, &buffers->BlockBuckets, buckets);
 
     // compute mixed model
     const int approxDimension = resArr->ysize();
     const int leafCount = buckets->ysize();
-    TVector<TVector<double>> curLeafValues(approxDimension, TVector<double>(leafCount));
+    auto& curLeafValues = buffers->CurLeafValues;
+    curLeafValues.resize(approxDimension);
+    for (auto& dimLeafValues : curLeafValues) {
+        dimLeafValues.yresize(leafCount);
+    }
     CalcMixedModelMulti(CalcModel, *buckets, iteration, l2Regularizer, bt.BodySumWeight, bt.BodyFinish, &curLeafValues);
     if (sumLeafValues != nullptr) {
         AddElementwise(curLeafValues, sumLeafValues);
     }
-    UpdateApproxDeltasMulti(error.GetIsExpApprox(), indices, bt.BodyFinish, &curLeafValues, resArr);
+    UpdateApproxDeltasMulti(error.GetIsExpApprox(), indices, bt.BodyFinish, localExecutor, &curLeafValues, resArr);
 
     // compute tail
     TVector<double> curApprox(approxDimension);
@@ -95,16 +133,17 @@ void CalcApproxDeltaMulti(
 
     const int approxDimension = approxDelta->ysize();
     TVector<TSumMulti> buckets(leafCount, TSumMulti(gradientIterations, approxDimension, error.GetHessianType()));
+    TLeafEstimationBuffersMulti buffers;
     for (int it = 0; it < gradientIterations; ++it) {
         if (estimationMethod == ELeavesEstimation::Newton) {
             CalcApproxDeltaIterationMulti(CalcModelNewtonMulti, AddSampleToBucketNewtonMulti,
                                           indices, ff.LearnTarget, ff.GetLearnWeights(), bt, error, it, l2Regularizer,
-                                          &buckets, approxDelta, sumLeafValues);
+                                          ctx->LocalExecutor, &buffers, &buckets, approxDelta, sumLeafValues);
         } else {
             Y_ASSERT(estimationMethod == ELeavesEstimation::Gradient);
             CalcApproxDeltaIterationMulti(CalcModelGradientMulti, AddSampleToBucketGradientMulti,
                                           indices, ff.LearnTarget, ff.GetLearnWeights(), bt, error, it, l2Regularizer,
-                                          &buckets, approxDelta, sumLeafValues);
+                                          ctx->LocalExecutor, &buffers, &buckets, approxDelta, sumLeafValues);
         }
     }
 }
@@ -120,6 +159,8 @@ void CalcLeafValuesIterationMulti(
     int iteration,
     float l2Regularizer,
     double sumWeight,
+    NPar::TLocalExecutor* localExecutor,
+    TLeafEstimationBuffersMulti* buffers,
     TVector<TSumMulti>* buckets,
     TVector<TVector<double>>* approx
 ) {
@@ -127,12 +168,17 @@ void CalcLeafValuesIterationMulti(
     int approxDimension = approx->ysize();
     int learnSampleCount = (*approx)[0].ysize();
 
-    UpdateBucketsMulti(AddSampleToBucket, indices, target, weight, /*approx*/ TVector<TVector<double>>(), *approx, error, learnSampleCount, iteration, buckets);
+    UpdateBucketsMulti(AddSampleToBucket, indices, target, weight, /*approx*/ TVector<TVector<double>>(), *approx, error, learnSampleCount, iteration,
+                       localExecutor, &buffers->BlockBuckets, buckets);
 
-    TVector<TVector<double>> curLeafValues(approxDimension, TVector<double>(leafCount));
+    auto& curLeafValues = buffers->CurLeafValues;
+    curLeafValues.resize(approxDimension);
+    for (auto& dimLeafValues : curLeafValues) {
+        dimLeafValues.yresize(leafCount);
+    }
     CalcMixedModelMulti(CalcModel, *buckets, iteration, l2Regularizer, sumWeight, learnSampleCount, &curLeafValues);
 
-    UpdateApproxDeltasMulti(error.GetIsExpApprox(), indices, learnSampleCount, &curLeafValues, approx);
+    UpdateApproxDeltasMulti(error.GetIsExpApprox(), indices, learnSampleCount, localExecutor, &curLeafValues, approx);
 }
 
 void CalcLeafValuesMulti(
@@ -156,16 +202,17 @@ void CalcLeafValuesMulti(
     TVector<TSumMulti> buckets(leafCount, TSumMulti(gradientIterations, approxDimension, error.GetHessianType()));
     const ELeavesEstimation estimationMethod = treeLearnerOptions.LeavesEstimationMethod;
     const float l2Regularizer = treeLearnerOptions.L2Reg;
+    TLeafEstimationBuffersMulti buffers;
     for (int it = 0; it < gradientIterations; ++it) {
         if (estimationMethod == ELeavesEstimation::Newton) {
             CalcLeafValuesIterationMulti(CalcModelNewtonMulti, AddSampleToBucketNewtonMulti,
                                          indices, ff.LearnTarget, ff.GetLearnWeights(), error, it, l2Regularizer,
-                                         ff.GetSumWeight(), &buckets, &approx);
+                                         ff.GetSumWeight(), ctx->LocalExecutor, &buffers, &buckets, &approx);
         } else {
             Y_ASSERT(estimationMethod == ELeavesEstimation::Gradient);
             CalcLeafValuesIterationMulti(CalcModelGradientMulti, AddSampleToBucketGradientMulti,
                                          indices, ff.LearnTarget, ff.GetLearnWeights(), error, it, l2Regularizer,
-                                         ff.GetSumWeight(), &buckets, &approx);
+                                         ff.GetSumWeight(), ctx->LocalExecutor, &buffers, &buckets, &approx);
         }
     }
 
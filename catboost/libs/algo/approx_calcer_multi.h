@@ -5,10 +5,15 @@
 #include "approx_updater_helpers.h"
 #include "error_functions.h"
 
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/algorithm.h>
+
 void UpdateApproxDeltasMulti(
     bool storeExpApprox,
     const TVector<TIndexType>& indices,
     int docCount,
+    NPar::TLocalExecutor* localExecutor,
     TVector<TVector<double>>* leafValues, //leafValues[dimension][bucketId]
     TVector<TVector<double>>* resArr
 );
@@ -43,6 +48,32 @@ inline void AddSampleToBucketGradientMulti(
     bucket->AddDerWeight(*curDer, weight, iteration);
 }
 
+// Number of document blocks with separate bucket sums. Depends only on data sizes, not on thread count,
+// so that the sums do not change with thread count.
+int GetBlockCountForUpdateBucketsMulti(int sampleCount, int leafCount, int approxDimension, EHessianType hessianType);
+
+inline void ResetBucketMulti(TSumMulti* bucket) {
+    for (auto& sumDer : bucket->SumDerHistory) {
+        Fill(sumDer.begin(), sumDer.end(), 0.0);
+    }
+    for (auto& sumDer2 : bucket->SumDer2History) {
+        Fill(sumDer2.Data.begin(), sumDer2.Data.end(), 0.0);
+    }
+    bucket->SumWeights = 0.0;
+}
+
+// blockBucket contains sums of one document block accumulated as of gradient iteration 0
+inline void AddBlockBucketMulti(const TSumMulti& blockBucket, int iteration, TSumMulti* bucket) {
+    auto& sumDer = bucket->SumDerHistory[iteration];
+    for (int dim = 0; dim < sumDer.ysize(); ++dim) {
+        sumDer[dim] += blockBucket.SumDerHistory[0][dim];
+    }
+    bucket->SumDer2History[iteration].AddDer2(blockBucket.SumDer2History[0]);
+    if (iteration == 0) {
+        bucket->SumWeights += blockBucket.SumWeights;
+    }
+}
+
 template <typename TAddSampleToBucket>
 void UpdateBucketsMulti(
     TAddSampleToBucket AddSampleToBucket,
@@ -54,21 +85,50 @@ void UpdateBucketsMulti(
     const IDerCalcer& error,
     int sampleCount,
     int iteration,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<TVector<TSumMulti>>* blockBuckets, // [blockId][leafId], reused between calls
     TVector<TSumMulti>* buckets
 ) {
     const int approxDimension = resArr.ysize();
     Y_ASSERT(approxDimension > 0);
-    TVector<double> curApprox(approxDimension);
-    TVector<double> bufferDer(approxDimension);
-    THessianInfo bufferDer2(approxDimension, error.GetHessianType());
-    for (int z = 0; z < sampleCount; ++z) {
-        for (int dim = 0; dim < approxDimension; ++dim) {
-            curApprox[dim] = approx.empty() ? resArr[dim][z] : UpdateApprox(error.GetIsExpApprox(), approx[dim][z], resArr[dim][z]);
-        }
-        TSumMulti& bucket = (*buckets)[indices[z]];
-        AddSampleToBucket(error, curApprox, target[z], weight.empty() ? 1 : weight[z], iteration,
-                          &bufferDer, &bufferDer2, &bucket);
+    if (sampleCount == 0) {
+        return;
     }
+    const int leafCount = buckets->ysize();
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, sampleCount);
+    blockParams.SetBlockCount(GetBlockCountForUpdateBucketsMulti(sampleCount, leafCount, approxDimension, error.GetHessianType()));
+    const int blockCount = blockParams.GetBlockCount();
+    blockBuckets->resize(blockCount);
+
+    localExecutor->ExecRange([&](int blockId) {
+        auto& localBuckets = (*blockBuckets)[blockId];
+        if (localBuckets.ysize() != leafCount || localBuckets[0].SumDerHistory[0].ysize() != approxDimension) {
+            localBuckets.assign(leafCount, TSumMulti(/*iterationCount*/ 1, approxDimension, error.GetHessianType()));
+        } else {
+            for (auto& bucket : localBuckets) {
+                ResetBucketMulti(&bucket);
+            }
+        }
+        TVector<double> curApprox(approxDimension);
+        TVector<double> bufferDer(approxDimension);
+        THessianInfo bufferDer2(approxDimension, error.GetHessianType());
+        const int blockStart = blockId * blockParams.GetBlockSize();
+        const int nextBlockStart = Min(sampleCount, blockStart + blockParams.GetBlockSize());
+        for (int z = blockStart; z < nextBlockStart; ++z) {
+            for (int dim = 0; dim < approxDimension; ++dim) {
+                curApprox[dim] = approx.empty() ? resArr[dim][z] : UpdateApprox(error.GetIsExpApprox(), approx[dim][z], resArr[dim][z]);
+            }
+            TSumMulti& bucket = localBuckets[indices[z]];
+            AddSampleToBucket(error, curApprox, target[z], weight.empty() ? 1 : weight[z], /*iteration*/ 0,
+                              &bufferDer, &bufferDer2, &bucket);
+        }
+    }, 0, blockCount, NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    NPar::ParallelFor(*localExecutor, 0, leafCount, [&](int leafId) {
+        for (int blockId = 0; blockId < blockCount; ++blockId) {
+            AddBlockBucketMulti((*blockBuckets)[blockId][leafId], iteration, &(*buckets)[leafId]);
+        }
+    });
 }
 
 template <typename TCalcModel>
@@ -1,5 +1,7 @@
 #include "calc_score_cache.h"
 
+#include <catboost/libs/helpers/counter_rng.h>
+
 #include <util/generic/algorithm.h>
 #include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
@@ -370,7 +372,7 @@ void TCalcScoreFold::SelectSmallestSplitSide(int curDepth, const TCalcScoreFold&
 }
 
 void TCalcScoreFold::Sample(const TFold& fold, const TVector<TIndexType>& indices, TRestorableFastRng64* rand, NPar::TLocalExecutor* localExecutor) {
-    SetSampledControl(indices.ysize(), rand);
+    SetSampledControl(indices.ysize(), rand, localExecutor);
 
     TVectorSlicing srcBlocks;
     TVectorSlicing dstBlocks;
@@ -485,14 +487,21 @@ void TCalcScoreFold::SetSmallestSideControl(int curDepth, int docCount, const TU
     }
 }
 
-void TCalcScoreFold::SetSampledControl(int docCount, TRestorableFastRng64* rand) {
+void TCalcScoreFold::SetSampledControl(int docCount, TRestorableFastRng64* rand, NPar::TLocalExecutor* localExecutor) {
     if (BernoulliSampleRate == 1.0f || IsPairwiseScoring) {
         Fill(Control.begin(), Control.end(), true);
         return;
     }
-    for (int docIdx = 0; docIdx < docCount; ++docIdx) {
-        Control[docIdx] = rand->GenRandReal1() < BernoulliSampleRate;
-    }
+    // counter-based, so sampling does not depend on thread count;
+    // Control is a bit vector, the block size keeps blocks in separate words
+    const ui64 randSeed = rand->GenRand();
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, docCount);
+    blockParams.SetBlockSize(4096);
+    localExecutor->ExecRange([&](int blockIdx) {
+        NPar::TLocalExecutor::BlockedLoopBody(blockParams, [&](int docIdx) {
+            Control[docIdx] = TCounterRng64::GenerateRealPositive(randSeed, docIdx) <= BernoulliSampleRate;
+        })(blockIdx);
+    }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
 
@@ -236,7 +236,7 @@ private:
     template <typename TFoldType>
     void SelectBlockFromFold(const TFoldType& fold, TSlice srcBlock, TSlice dstBlock);
     void SetSmallestSideControl(int curDepth, int docCount, const TUnsizedVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor);
-    void SetSampledControl(int docCount, TRestorableFastRng64* rand);
+    void SetSampledControl(int docCount, TRestorableFastRng64* rand, NPar::TLocalExecutor* localExecutor);
 
     void CreateBlocksAndUpdateQueriesInfoByControl(
         NPar::TLocalExecutor* localExecutor,
@@ -255,6 +255,212 @@ void TCrossEntropyError::CalcDersRange(
     }
 }
 
+namespace {
+    struct TRMSEDers {
+        static constexpr bool IsExpApprox = false;
+
+        double CalcDer(double approx, float target) const {
+            return target - approx;
+        }
+        double CalcDer2(double /*approx*/, float /*target*/) const {
+            return TRMSEError::RMSE_DER2;
+        }
+        double CalcDer3(double /*approx*/, float /*target*/) const {
+            return TRMSEError::RMSE_DER3;
+        }
+    };
+
+    struct TQuantileDers {
+        static constexpr bool IsExpApprox = false;
+
+        const double Alpha;
+
+        double CalcDer(double approx, float target) const {
+            return (target - approx > 0) ? Alpha : -(1 - Alpha);
+        }
+        double CalcDer2(double /*approx*/, float /*target*/) const {
+            return TQuantileError::QUANTILE_DER2_AND_DER3;
+        }
+        double CalcDer3(double /*approx*/, float /*target*/) const {
+            return TQuantileError::QUANTILE_DER2_AND_DER3;
+        }
+    };
+
+    struct TPoissonDers {
+        static constexpr bool IsExpApprox = true;
+
+        double CalcDer(double approxExp, float target) const {
+            return target - approxExp;
+        }
+        double CalcDer2(double approxExp, float /*target*/) const {
+            return -approxExp;
+        }
+        double CalcDer3(double approxExp, float /*target*/) const {
+            return -approxExp;
+        }
+    };
+}
+
+// Same loop as IDerCalcer::CalcDersRangeImpl, but derivatives are inlined instead of virtual calls per document
+template <int MaxDerivativeOrder, bool UseTDers, bool HasDelta, typename TLossDers>
+static void CalcLossDersRangeImpl(
+    const TLossDers& lossDers,
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders,
+    double* firstDers
+) {
+    Y_ASSERT(HasDelta == (approxDeltas != nullptr));
+    Y_ASSERT(UseTDers == (ders != nullptr) && (ders != nullptr) == (firstDers == nullptr));
+#pragma clang loop vectorize_width(4) interleave_count(2)
+    for (int i = start; i < start + count; ++i) {
+        double updatedApprox = approxes[i];
+        if (HasDelta) {
+            updatedApprox = UpdateApprox<TLossDers::IsExpApprox>(updatedApprox, approxDeltas[i]);
+        }
+        if (UseTDers) {
+            ders[i].Der1 = lossDers.CalcDer(updatedApprox, targets[i]);
+            ders[i].Der2 = lossDers.CalcDer2(updatedApprox, targets[i]);
+            if (MaxDerivativeOrder >= 3) {
+                ders[i].Der3 = lossDers.CalcDer3(updatedApprox, targets[i]);
+            }
+        } else {
+            firstDers[i] = lossDers.CalcDer(updatedApprox, targets[i]);
+        }
+    }
+    if (weights != nullptr) {
+#pragma clang loop vectorize_width(4) interleave_count(2)
+        for (int i = start; i < start + count; ++i) {
+            if (UseTDers) {
+                ders[i].Der1 *= weights[i];
+                ders[i].Der2 *= weights[i];
+                if (MaxDerivativeOrder >= 3) {
+                    ders[i].Der3 *= weights[i];
+                }
+            } else {
+                firstDers[i] *= weights[i];
+            }
+        }
+    }
+}
+
+template <int MaxDerivativeOrder, bool UseTDers, typename TLossDers>
+static void CalcLossDersRange(
+    const TLossDers& lossDers,
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders,
+    double* firstDers
+) {
+    if (approxDeltas != nullptr) {
+        CalcLossDersRangeImpl<MaxDerivativeOrder, UseTDers, /*HasDelta*/ true>(lossDers, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+    } else {
+        CalcLossDersRangeImpl<MaxDerivativeOrder, UseTDers, /*HasDelta*/ false>(lossDers, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+    }
+}
+
+template <typename TLossDers>
+static void CalcLossDersRange(
+    const TLossDers& lossDers,
+    int start,
+    int count,
+    bool calcThirdDer,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders
+) {
+    if (calcThirdDer) {
+        CalcLossDersRange</*MaxDerivativeOrder*/ 3, /*UseTDers*/ true>(lossDers, start, count, approxes, approxDeltas, targets, weights, ders, nullptr);
+    } else {
+        CalcLossDersRange</*MaxDerivativeOrder*/ 2, /*UseTDers*/ true>(lossDers, start, count, approxes, approxDeltas, targets, weights, ders, nullptr);
+    }
+}
+
+void TRMSEError::CalcFirstDerRange(
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    double* ders
+) const {
+    CalcLossDersRange</*MaxDerivativeOrder*/ 1, /*UseTDers*/ false>(TRMSEDers(), start, count, approxes, approxDeltas, targets, weights, nullptr, ders);
+}
+
+void TRMSEError::CalcDersRange(
+    int start,
+    int count,
+    bool calcThirdDer,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders
+) const {
+    CalcLossDersRange(TRMSEDers(), start, count, calcThirdDer, approxes, approxDeltas, targets, weights, ders);
+}
+
+void TQuantileError::CalcFirstDerRange(
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    double* ders
+) const {
+    CalcLossDersRange</*MaxDerivativeOrder*/ 1, /*UseTDers*/ false>(TQuantileDers{Alpha}, start, count, approxes, approxDeltas, targets, weights, nullptr, ders);
+}
+
+void TQuantileError::CalcDersRange(
+    int start,
+    int count,
+    bool calcThirdDer,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders
+) const {
+    CalcLossDersRange(TQuantileDers{Alpha}, start, count, calcThirdDer, approxes, approxDeltas, targets, weights, ders);
+}
+
+void TPoissonError::CalcFirstDerRange(
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    double* ders
+) const {
+    CalcLossDersRange</*MaxDerivativeOrder*/ 1, /*UseTDers*/ false>(TPoissonDers(), start, count, approxes, approxDeltas, targets, weights, nullptr, ders);
+}
+
+void TPoissonError::CalcDersRange(
+    int start,
+    int count,
+    bool calcThirdDer,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders
+) const {
+    CalcLossDersRange(TPoissonDers(), start, count, calcThirdDer, approxes, approxDeltas, targets, weights, ders);
+}
+
 void TQuerySoftMaxError::CalcDersForSingleQuery(
     int start,
     int offset,
@@ -184,18 +184,26 @@ public:
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
 
-private:
-    double CalcDer(double approx, float target) const override {
-        return target - approx;
-    }
-
-    double CalcDer2(double /*approx*/, float /*target*/) const override {
-        return RMSE_DER2;
-    }
+    void CalcFirstDerRange(
+        int start,
+        int count,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        double* ders
+    ) const override;
 
-    double CalcDer3(double /*approx*/, float /*target*/) const override {
-        return RMSE_DER3;
-    }
+    void CalcDersRange(
+        int start,
+        int count,
+        bool calcThirdDer,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders
+    ) const override;
 };
 
 class TQuantileError final : public IDerCalcer {
@@ -219,18 +227,26 @@ public:
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
 
-private:
-    double CalcDer(double approx, float target) const override {
-        return (target - approx > 0) ? Alpha : -(1 - Alpha);
-    }
-
-    double CalcDer2(double /*approx*/, float /*target*/) const override {
-        return QUANTILE_DER2_AND_DER3;
-    }
+    void CalcFirstDerRange(
+        int start,
+        int count,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        double* ders
+    ) const override;
 
-    double CalcDer3(double /*approx*/, float /*target*/) const override {
-        return QUANTILE_DER2_AND_DER3;
-    }
+    void CalcDersRange(
+        int start,
+        int count,
+        bool calcThirdDer,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders
+    ) const override;
 };
 
 class TLqError final : public IDerCalcer {
@@ -330,18 +346,26 @@ public:
         CB_ENSURE(isExpApprox == true, "Approx format does not match");
     }
 
-private:
-    double CalcDer(double approxExp, float target) const override {
-        return target - approxExp;
-    }
-
-    double CalcDer2(double approxExp, float) const override {
-        return -approxExp;
-    }
+    void CalcFirstDerRange(
+        int start,
+        int count,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        double* ders
+    ) const override;
 
-    double CalcDer3(double approxExp, float /*target*/) const override {
-        return -approxExp;
-    }
+    void CalcDersRange(
+        int start,
+        int count,
+        bool calcThirdDer,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders
+    ) const override;
 };
 
 class TMultiClassError final : public IDerCalcer {
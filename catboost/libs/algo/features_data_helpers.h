@@ -3,22 +3,45 @@
 #include <catboost/libs/data_new/objects.h>
 #include <catboost/libs/helpers/exception.h>
 
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+
 
 namespace NCB {
 
-    inline const float* GetRawFeatureDataBeginPtr(
+    /* data of objects [objectsBegin, objectsBegin + objectsCount), cat features hashes are returned as floats
+     * sparse float features are unpacked to sparseDataBuffer, dense data is returned without copying
+     */
+    inline TConstArrayRef<float> GetRawFeatureData(
         const TRawObjectsDataProvider& rawObjectsData,
         const TFeaturesLayout& featuresLayout,
         ui32 consecutiveSubsetBegin,
-        ui32 flatFeatureIdx) {
+        ui32 flatFeatureIdx,
+        ui32 objectsBegin,
+        ui32 objectsCount,
+        TVector<float>* sparseDataBuffer) {
 
         const ui32 internalFeatureIdx = featuresLayout.GetInternalFeatureIdx(flatFeatureIdx);
         if (featuresLayout.GetExternalFeatureType(flatFeatureIdx) == EFeatureType::Float) {
-            return (*(*(**rawObjectsData.GetFloatFeature(internalFeatureIdx)).GetArrayData().GetSrc()
-                    )).data() + consecutiveSubsetBegin;
+            const auto& floatFeature = **rawObjectsData.GetFloatFeature(internalFeatureIdx);
+            if (floatFeature.IsSparse()) {
+                sparseDataBuffer->yresize(objectsCount);
+                floatFeature.GetSparseSrcData().ExtractValues(
+                    consecutiveSubsetBegin + objectsBegin,
+                    *sparseDataBuffer
+                );
+                return *sparseDataBuffer;
+            }
+            return MakeArrayRef(
+                (*(*floatFeature.GetArrayData().GetSrc())).data() + consecutiveSubsetBegin + objectsBegin,
+                objectsCount
+            );
         } else {
-            return reinterpret_cast<const float*>((*(*(**rawObjectsData.GetCatFeature(internalFeatureIdx))
-                    .GetArrayData().GetSrc())).data()) + consecutiveSubsetBegin;
+            return MakeArrayRef(
+                reinterpret_cast<const float*>((*(*(**rawObjectsData.GetCatFeature(internalFeatureIdx))
+                    .GetArrayData().GetSrc())).data()) + consecutiveSubsetBegin + objectsBegin,
+                objectsCount
+            );
         }
     }
 
@@ -3,6 +3,7 @@
 #include "approx_updater_helpers.h"
 
 #include <catboost/libs/data_types/groupid.h>
+#include <catboost/libs/helpers/counter_rng.h>
 #include <catboost/libs/helpers/permutation.h>
 #include <catboost/libs/helpers/query_info_helper.h>
 #include <catboost/libs/helpers/restorable_rng.h>
@@ -71,7 +72,9 @@ static void InitPermutationData(
         } else {
             fold->PermutationBlockSize = 1;
         }
-        fold->LearnPermutation = Shuffle(learnData.ObjectsGrouping, fold->PermutationBlockSize, rand);
+        // counter-based, so the permutation depends only on the seed drawn from rand
+        TCounterRng64 permutationRand(rand->GenRand());
+        fold->LearnPermutation = Shuffle(learnData.ObjectsGrouping, fold->PermutationBlockSize, &permutationRand);
         fold->LearnPermutationFeaturesSubset = Compose(
             featuresArraySubsetIndexing,
             fold->LearnPermutation->GetObjectsIndexing()
@@ -249,12 +252,12 @@ TFold TFold::BuildPlainFold(
 void TFold::DropEmptyCTRs() {
     TVector<TProjection> emptyProjections;
     for (auto& projCtr : OnlineSingleCtrs) {
-        if (projCtr.second.Feature.empty()) {
+        if (projCtr.second.Feature.empty() && !projCtr.second.IsCompressed()) {
             emptyProjections.emplace_back(projCtr.first);
         }
     }
     for (auto& projCtr : OnlineCTR) {
-        if (projCtr.second.Feature.empty()) {
+        if (projCtr.second.Feature.empty() && !projCtr.second.IsCompressed()) {
             emptyProjections.emplace_back(projCtr.first);
         }
     }
@@ -263,6 +266,36 @@ void TFold::DropEmptyCTRs() {
     }
 }
 
+size_t TFold::GetCompressedCTRsSize() const {
+    size_t size = 0;
+    for (const auto* ctrs : {&OnlineSingleCtrs, &OnlineCTR}) {
+        for (const auto& projCtr : *ctrs) {
+            size += projCtr.second.GetCompressedSize();
+        }
+    }
+    return size;
+}
+
+size_t TFold::DropCompressedCTRs(size_t memorySize, const THashSet<TProjection>& keptProjections) {
+    size_t freedSize = 0;
+    for (auto* ctrs : {&OnlineSingleCtrs, &OnlineCTR}) {
+        TVector<TProjection> droppedProjections;
+        for (const auto& projCtr : *ctrs) {
+            if (freedSize >= memorySize) {
+                break;
+            }
+            if (projCtr.second.IsCompressed() && !keptProjections.contains(projCtr.first)) {
+                freedSize += projCtr.second.GetCompressedSize();
+                droppedProjections.emplace_back(projCtr.first);
+            }
+        }
+        for (const auto& proj : droppedProjections) {
+            ctrs->erase(proj);
+        }
+    }
+    return freedSize;
+}
+
 void TFold::AssignTarget(TMaybeData<TConstArrayRef<float>> target, const TVector<TTargetClassifier>& targetClassifiers) {
     ui32 learnSampleCount = GetLearnSampleCount();
     if (target.Defined()) {
@@ -16,7 +16,9 @@
 #include <library/threading/local_executor/local_executor.h>
 
 #include <util/generic/array_ref.h>
+#include <util/generic/hash_set.h>
 #include <util/generic/maybe.h>
+#include <util/generic/ptr.h>
 #include <util/generic/vector.h>
 #include <util/random/shuffle.h>
 #include <util/generic/ymath.h>
@@ -45,6 +47,7 @@ struct TFold {
         TVector<TVector<double>> SampleWeightedDerivatives;  // [dim][]
         TVector<float> PairwiseWeights;  // [dim][]
         TVector<float> SamplePairwiseWeights;  // [dim][]
+        bool AreWeightedDerivativesUpToDate = false; // already calculated for current Approx
 
         int GetBodyDocCount() const { return BodyFinish; }
 
@@ -81,6 +84,9 @@ struct TFold {
     TVector<int> TargetClassesCount;
     ui32 PermutationBlockSize = FoldPermutationBlockSizeNotSet;
 
+    // shared pointer to keep TFold copyable, it is used from ComputeOnlineCTRs for const fold
+    TAtomicSharedPtr<TProjectionHashCache> ProjectionHashCache = MakeAtomicShared<TProjectionHashCache>();
+
     TOnlineCTRHash& GetCtrs(const TProjection& proj) {
         return proj.HasSingleFeature() ? OnlineSingleCtrs : OnlineCTR;
     }
@@ -99,6 +105,13 @@ struct TFold {
 
     void DropEmptyCTRs();
 
+    size_t GetCompressedCTRsSize() const;
+
+    /* drops compressed ctrs until at least memorySize bytes are freed, returns freed size
+     * ctrs of keptProjections (e.g. current split candidates) are not dropped
+     */
+    size_t DropCompressedCTRs(size_t memorySize, const THashSet<TProjection>& keptProjections);
+
     const std::tuple<const TOnlineCTRHash&, const TOnlineCTRHash&> GetAllCtrs() const {
         return std::tie(OnlineSingleCtrs, OnlineCTR);
     }
@@ -14,7 +14,11 @@
 #include <library/dot_product/dot_product.h>
 #include <library/fast_log/fast_log.h>
 
+#include <util/generic/algorithm.h>
 #include <util/string/builder.h>
+#include <util/string/cast.h>
+#include <util/system/atomic.h>
+#include <util/system/hp_timer.h>
 #include <util/system/mem_info.h>
 
 
@@ -280,6 +284,8 @@ static void SelectCtrsToDropAfterCalc(size_t memoryLimit,
                                       int sampleCount,
                                       int threadCount,
                                       const std::function<bool(const TProjection&)>& IsInCache,
+                                      const TVector<TProjectionHashCache*>& projectionHashCaches,
+                                      TFold* fold,
                                       TCandidateList* candList) {
     size_t maxMemoryForOneCtr = 0;
     size_t fullNeededMemoryForCtrs = 0;
@@ -295,6 +301,37 @@ static void SelectCtrsToDropAfterCalc(size_t memoryLimit,
     }
 
     auto currentMemoryUsage = NMemInfo::GetMemInfo().RSS;
+    if (fullNeededMemoryForCtrs + currentMemoryUsage > memoryLimit) {
+        // projection hash caches are included in rss too and are the cheapest to rebuild, so they go first
+        size_t freedMemory = 0;
+        size_t cachesMemory = 0;
+        for (auto* cache : projectionHashCaches) {
+            if (fullNeededMemoryForCtrs + currentMemoryUsage > memoryLimit + freedMemory) {
+                freedMemory += cache->Evict(fullNeededMemoryForCtrs + currentMemoryUsage - memoryLimit - freedMemory);
+            }
+            cachesMemory += cache->GetUsedMemory();
+        }
+        CATBOOST_DEBUG_LOG << "Evicted projection hashes of size " << freedMemory << ", left " << cachesMemory << Endl;
+        currentMemoryUsage -= Min<size_t>(freedMemory, currentMemoryUsage);
+    }
+    if (fullNeededMemoryForCtrs + currentMemoryUsage > memoryLimit) {
+        // compressed ctrs are included in rss, they are the first to free,
+        // except ctrs of current candidates, which would have to be computed again right away
+        THashSet<TProjection> candidateProjections;
+        for (const auto& candSubList : *candList) {
+            const auto& firstSubCandidate = candSubList.Candidates[0].SplitCandidate;
+            if (firstSubCandidate.Type == ESplitType::OnlineCtr) {
+                candidateProjections.insert(firstSubCandidate.Ctr.Projection);
+            }
+        }
+        const size_t freedMemory = fold->DropCompressedCTRs(
+            fullNeededMemoryForCtrs + currentMemoryUsage - memoryLimit,
+            candidateProjections
+        );
+        CATBOOST_DEBUG_LOG << "Dropped compressed ctrs of size " << freedMemory << ", left "
+            << fold->GetCompressedCTRsSize() << Endl;
+        currentMemoryUsage -= Min<size_t>(freedMemory, currentMemoryUsage);
+    }
     if (fullNeededMemoryForCtrs + currentMemoryUsage > memoryLimit) {
         CATBOOST_DEBUG_LOG << "Needed more memory then allowed, will drop some ctrs after score calculation" << Endl;
         const float GB = (ui64)1024 * 1024 * 1024;
@@ -317,6 +354,70 @@ static void SelectCtrsToDropAfterCalc(size_t memoryLimit,
     }
 }
 
+namespace {
+    struct TOnlineCtrCacheStats {
+        TAtomic Hits = 0; // ctr values were ready to use
+        TAtomic Decompressions = 0;
+        TAtomic Computations = 0;
+
+        void AddToProfile(TProfileInfo* profile) const {
+            profile->AddCounter("Online ctr cache hits", AtomicGet(Hits));
+            profile->AddCounter("Online ctr cache decompressions", AtomicGet(Decompressions));
+            profile->AddCounter("Online ctr cache misses", AtomicGet(Computations));
+        }
+    };
+}
+
+// returns true if ctr values had to be computed from scratch
+static bool PrepareOnlineCtr(const TTrainingForCPUDataProviders& data,
+                             const TProjection& proj,
+                             TFold* fold,
+                             TLearnContext* ctx,
+                             TOnlineCtrCacheStats* cacheStats) {
+    TOnlineCTR& ctr = fold->GetCtrRef(proj);
+    if (!ctr.Feature.empty()) {
+        AtomicIncrement(cacheStats->Hits);
+        return false;
+    }
+    if (ctr.IsCompressed()) {
+        DecompressOnlineCTR(&ctr);
+        AtomicIncrement(cacheStats->Decompressions);
+        return false;
+    }
+    ComputeOnlineCTRs(data, *fold, proj, ctx, &ctr);
+    AtomicIncrement(cacheStats->Computations);
+    return true;
+}
+
+// Relative cost of computing ctr values of one document in comparison with accumulating its statistics.
+constexpr double ONLINE_CTR_COMPUTATION_COST_PER_DOC = 4.0;
+constexpr double ONLINE_CTR_DECOMPRESSION_COST_PER_DOC = 0.25;
+
+static double EstimateCandidateCost(const TTrainingForCPUDataProviders& data,
+                                    const TVector<int>& splitCounts,
+                                    int currentDepth,
+                                    const TCandidatesInfoList& candidate,
+                                    TFold* fold,
+                                    const TLearnContext& ctx) {
+    const double docCount = ctx.SampledDocs.GetDocCount();
+    const double leafCount = 1 << currentDepth;
+    double cost = 0;
+    for (const auto& subCandidate : candidate.Candidates) {
+        const int bucketCount = GetSplitCount(splitCounts, *data.Learn->ObjectsData->GetQuantizedFeaturesInfo(), subCandidate.SplitCandidate) + 1;
+        cost += docCount + bucketCount * leafCount;
+    }
+    const auto& firstSplitCandidate = candidate.Candidates[0].SplitCandidate;
+    if (firstSplitCandidate.Type == ESplitType::OnlineCtr) {
+        const TOnlineCTR& ctr = fold->GetCtrRef(firstSplitCandidate.Ctr.Projection);
+        if (ctr.Feature.empty()) {
+            const double ctrDocCount = data.Learn->GetObjectCount() + data.GetTestSampleCount();
+            const double costPerDoc = ctr.IsCompressed() ? ONLINE_CTR_DECOMPRESSION_COST_PER_DOC : ONLINE_CTR_COMPUTATION_COST_PER_DOC;
+            cost += costPerDoc * ctrDocCount * candidate.Candidates.size();
+        }
+    }
+    return cost;
+}
+
 static void CalcBestScore(const TTrainingForCPUDataProviders& data,
         const TVector<int>& splitCounts,
         int currentDepth,
@@ -324,24 +425,36 @@ static void CalcBestScore(const TTrainingForCPUDataProviders& data,
         double scoreStDev,
         TCandidateList* candidateList,
         TFold* fold,
-        TLearnContext* ctx) {
+        TLearnContext* ctx,
+        TOnlineCtrCacheStats* ctrCacheStats) {
     CB_ENSURE(static_cast<ui32>(ctx->LocalExecutor->GetThreadCount()) == ctx->Params.SystemOptions->NumThreads - 1);
     const TFlatPairsInfo pairs = UnpackPairsFromQueries(fold->LearnQueriesInfo);
     TCandidateList& candList = *candidateList;
-    ctx->LocalExecutor->ExecRange([&](int id) {
+
+    // Executor threads take candidates in order, so the most expensive ones (usually ctrs
+    // that have to be computed) are started first and do not form a long tail at the end.
+    TVector<double> candidateCosts(candList.size());
+    for (int id = 0; id < candList.ysize(); ++id) {
+        candidateCosts[id] = EstimateCandidateCost(data, splitCounts, currentDepth, candList[id], fold, *ctx);
+    }
+    TVector<int> candidateOrder(candList.size());
+    Iota(candidateOrder.begin(), candidateOrder.end(), 0);
+    StableSortBy(candidateOrder, [&](int id) { return -candidateCosts[id]; });
+
+    TVector<double> candidateBusyTimes(candList.size()); // summed over all threads working on the candidate
+    THPTimer wallTimer;
+    ctx->LocalExecutor->ExecRange([&](int orderIdx) {
+        const int id = candidateOrder[orderIdx];
         auto& candidate = candList[id];
+        THPTimer timer;
         if (candidate.Candidates[0].SplitCandidate.Type == ESplitType::OnlineCtr) {
-            const auto& proj = candidate.Candidates[0].SplitCandidate.Ctr.Projection;
-            if (fold->GetCtrRef(proj).Feature.empty()) {
-                ComputeOnlineCTRs(data,
-                                  *fold,
-                                  proj,
-                                  ctx,
-                                  &fold->GetCtrRef(proj));
-            }
+            PrepareOnlineCtr(data, candidate.Candidates[0].SplitCandidate.Ctr.Projection, fold, ctx, ctrCacheStats);
         }
+        double busyTime = timer.PassedReset();
         TVector<TVector<double>> allScores(candidate.Candidates.size());
+        TVector<double> subCandidateBusyTimes(candidate.Candidates.size());
         ctx->LocalExecutor->ExecRange([&](int oneCandidate) {
+            THPTimer subCandidateTimer;
             if (candidate.Candidates[oneCandidate].SplitCandidate.Type == ESplitType::OnlineCtr) {
                 const auto& proj = candidate.Candidates[oneCandidate].SplitCandidate.Ctr.Projection;
                 Y_ASSERT(!fold->GetCtrRef(proj).Feature.empty());
@@ -364,13 +477,34 @@ static void CalcBestScore(const TTrainingForCPUDataProviders& data,
                                /*pairwiseStats*/nullptr,
                                &scoreBins);
             allScores[oneCandidate] = GetScores(scoreBins);
+            subCandidateBusyTimes[oneCandidate] = subCandidateTimer.Passed();
         }, NPar::TLocalExecutor::TExecRangeParams(0, candidate.Candidates.ysize())
          , NPar::TLocalExecutor::WAIT_COMPLETE);
+        timer.Reset();
         if (candidate.Candidates[0].SplitCandidate.Type == ESplitType::OnlineCtr && candidate.ShouldDropCtrAfterCalc) {
-            fold->GetCtrRef(candidate.Candidates[0].SplitCandidate.Ctr.Projection).Feature.clear();
+            CompressOnlineCTR(&fold->GetCtrRef(candidate.Candidates[0].SplitCandidate.Ctr.Projection));
         }
         SetBestScore(randSeed + id, allScores, scoreStDev, &candidate.Candidates);
+        busyTime += timer.Passed();
+        candidateBusyTimes[id] = busyTime + Accumulate(subCandidateBusyTimes, 0.0);
     }, 0, candList.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    const double wallTime = wallTimer.Passed();
+    const double busyTime = Accumulate(candidateBusyTimes, 0.0);
+    const int threadCount = ctx->Params.SystemOptions->NumThreads;
+    const double utilization = wallTime > 0 ? Min(1.0, busyTime / (wallTime * threadCount)) : 1.0;
+    CATBOOST_DEBUG_LOG << "Calc scores, depth " << currentDepth << ": " << candList.size() << " candidates, wall time "
+        << FloatToString(wallTime, PREC_NDIGITS, 3) << " sec, thread utilization "
+        << FloatToString(100 * utilization, PREC_NDIGITS, 3) << "%" << Endl;
+    // counters are summed over calls, so utilization is reported as busy and available thread time
+    ctx->Profile.AddCounter(
+        TStringBuilder() << "Calc scores busy thread time ms, depth " << currentDepth,
+        (ui64)(1000 * Min(busyTime, wallTime * threadCount))
+    );
+    ctx->Profile.AddCounter(
+        TStringBuilder() << "Calc scores available thread time ms, depth " << currentDepth,
+        (ui64)(1000 * wallTime * threadCount)
+    );
 }
 
 void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
@@ -405,6 +539,7 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
     }
     const bool isPairwiseScoring = IsPairwiseScoring(ctx->Params.LossFunctionDescription->GetLossFunction());
 
+    TOnlineCtrCacheStats ctrCacheStats;
     for (ui32 curDepth = 0; curDepth < ctx->Params.ObliviousTreeOptions->MaxDepth; ++curDepth) {
         TCandidateList candList;
         AddFloatFeatures(*data.Learn->ObjectsData, ctx, &ctx->PrevTreeLevelStats, &candList);
@@ -414,7 +549,12 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
 
         auto IsInCache = [&fold](const TProjection& proj) -> bool {return fold->GetCtrRef(proj).Feature.empty();};
         auto cpuUsedRamLimit = ParseMemorySizeDescription(ctx->Params.SystemOptions->CpuUsedRamLimit.Get());
-        SelectCtrsToDropAfterCalc(cpuUsedRamLimit, learnSampleCount + testSampleCount, ctx->Params.SystemOptions->NumThreads, IsInCache, &candList);
+        TVector<TProjectionHashCache*> projectionHashCaches;
+        for (auto& learnFold : ctx->LearnProgress.Folds) {
+            projectionHashCaches.push_back(learnFold.ProjectionHashCache.Get());
+        }
+        projectionHashCaches.push_back(ctx->LearnProgress.AveragingFold.ProjectionHashCache.Get());
+        SelectCtrsToDropAfterCalc(cpuUsedRamLimit, learnSampleCount + testSampleCount, ctx->Params.SystemOptions->NumThreads, IsInCache, projectionHashCaches, fold, &candList);
 
         CheckInterrupted(); // check after long-lasting operation
         if (!isSamplingPerTree) {
@@ -438,7 +578,7 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
             }
         } else {
             const ui64 randSeed = ctx->Rand.GenRand();
-            CalcBestScore(data, splitCounts, currentSplitTree.GetDepth(), randSeed, scoreStDev, &candList, fold, ctx);
+            CalcBestScore(data, splitCounts, currentSplitTree.GetDepth(), randSeed, scoreStDev, &candList, fold, ctx, &ctrCacheStats);
         }
 
         size_t maxFeatureValueCount = 1;
@@ -492,15 +632,8 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
         auto bestSplit = TSplit(bestSplitCandidate->SplitCandidate, bestSplitCandidate->BestBinBorderId);
         if (bestSplit.Type == ESplitType::OnlineCtr) {
             const auto& proj = bestSplit.Ctr.Projection;
-            if (fold->GetCtrRef(proj).Feature.empty()) {
-                ComputeOnlineCTRs(data,
-                                  *fold,
-                                  proj,
-                                  ctx,
-                                  &fold->GetCtrRef(proj));
-                if (ctx->UseTreeLevelCaching()) {
-                    DropStatsForProjection(*fold, *ctx, proj, &ctx->PrevTreeLevelStats);
-                }
+            if (PrepareOnlineCtr(data, proj, fold, ctx, &ctrCacheStats) && ctx->UseTreeLevelCaching()) {
+                DropStatsForProjection(*fold, *ctx, proj, &ctx->PrevTreeLevelStats);
             }
         }
 
@@ -534,5 +667,6 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
             break;
         }
     }
+    ctrCacheStats.AddToProfile(&profile);
     *resSplitTree = std::move(currentSplitTree);
 }
@@ -79,13 +79,82 @@ void ConfigureMalloc() {
 #endif
 }
 
+TBackgroundErrorsCalcer::TBackgroundErrorsCalcer() {
+    // one dedicated thread, so that training uses at most one thread more than thread_count
+    Executor.RunAdditionalThreads(1);
+}
+
+TBackgroundErrorsCalcer::~TBackgroundErrorsCalcer() {
+    Wait();
+}
+
+void TBackgroundErrorsCalcer::Start(TVector<TErrorTask>&& tasks) {
+    Y_VERIFY(!HasPendingErrors());
+    if (tasks.empty()) {
+        return;
+    }
+    Tasks = std::move(tasks);
+    Exception = nullptr;
+    Done.Reset();
+    Executor.Exec(
+        [this](int) {
+            try {
+                for (auto& task : Tasks) {
+                    const auto& additiveStats = EvalErrors(
+                        *task.Approx,
+                        task.Target,
+                        task.Weights,
+                        task.QueryInfo,
+                        *task.Metric,
+                        &Executor
+                    );
+                    task.Error = (*task.Metric)->GetFinalError(additiveStats);
+                }
+            } catch (...) {
+                Exception = std::current_exception();
+            }
+            Done.Signal();
+        },
+        0,
+        0
+    );
+}
+
+void TBackgroundErrorsCalcer::Wait() {
+    if (HasPendingErrors()) {
+        Done.Wait();
+    }
+}
+
+void TBackgroundErrorsCalcer::Finish(TMetricsAndTimeLeftHistory* metricsHistory) {
+    if (!HasPendingErrors()) {
+        return;
+    }
+    Wait();
+    TVector<TErrorTask> tasks = std::move(Tasks);
+    Tasks.clear();
+    if (Exception) {
+        std::rethrow_exception(Exception);
+    }
+    for (const auto& task : tasks) {
+        if (task.TestIdx.Defined()) {
+            metricsHistory->AddTestError(*task.TestIdx, *task.Metric->Get(), task.Error, /*updateBestIteration*/ false);
+        } else {
+            metricsHistory->AddLearnError(*task.Metric->Get(), task.Error);
+        }
+    }
+}
+
 void CalcErrors(
     const TTrainingForCPUDataProviders& trainingDataProviders,
     const TVector<THolder<IMetric>>& errors,
     bool calcAllMetrics,
     bool calcErrorTrackerMetric,
-    TLearnContext* ctx
+    TLearnContext* ctx,
+    TBackgroundErrorsCalcer* backgroundErrorsCalcer
 ) {
+    TVector<TBackgroundErrorsCalcer::TErrorTask> backgroundTasks;
+
     if (trainingDataProviders.Learn->GetObjectCount() > 0) {
         ctx->LearnProgress.MetricsAndTimeHistory.LearnMetricsHistory.emplace_back();
         if (calcAllMetrics) {
@@ -99,6 +168,16 @@ void CalcErrors(
                 TVector<bool> skipMetricOnTrain = GetSkipMetricOnTrain(errors);
                 for (int i = 0; i < errors.ysize(); ++i) {
                     if (!skipMetricOnTrain[i]) {
+                        if (backgroundErrorsCalcer) {
+                            TBackgroundErrorsCalcer::TErrorTask task;
+                            task.Metric = &errors[i];
+                            task.Approx = &ctx->LearnProgress.AvrgApprox;
+                            task.Target = target;
+                            task.Weights = weights;
+                            task.QueryInfo = queryInfo;
+                            backgroundTasks.push_back(std::move(task));
+                            continue;
+                        }
                         const auto& additiveStats = EvalErrors(
                             ctx->LearnProgress.AvrgApprox,
                             target,
@@ -130,15 +209,32 @@ void CalcErrors(
             if (!calcAllMetrics && testIdx != trainingDataProviders.Test.size() - 1) {
                 continue;
             }
+            if (!calcAllMetrics && !calcErrorTrackerMetric) {
+                continue;
+            }
             const auto& targetData = testDataPtr->TargetData;
 
             auto target = GetMaybeTarget(targetData).GetOrElse(TConstArrayRef<float>());
             auto weights = GetWeights(targetData);
             auto queryInfo = GetGroupInfo(targetData);
 
+            ctx->TestApproxUpdater.Update(testIdx, trainingDataProviders.Test, ctx->LocalExecutor, &ctx->LearnProgress.TestApprox[testIdx]);
             const auto& testApprox = ctx->LearnProgress.TestApprox[testIdx];
             for (int i = 0; i < errors.ysize(); ++i) {
                 if (calcAllMetrics || i == errorTrackerMetricIdx) {
+                    // the error tracker metric decides whether to stop and which iteration is the best one, so it is needed now
+                    bool updateBestIteration = (i == 0) && (testIdx == trainingDataProviders.Test.size() - 1);
+                    if (backgroundErrorsCalcer && !updateBestIteration) {
+                        TBackgroundErrorsCalcer::TErrorTask task;
+                        task.Metric = &errors[i];
+                        task.TestIdx = testIdx;
+                        task.Approx = &testApprox;
+                        task.Target = target;
+                        task.Weights = weights;
+                        task.QueryInfo = queryInfo;
+                        backgroundTasks.push_back(std::move(task));
+                        continue;
+                    }
                     const auto& additiveStats = EvalErrors(
                         testApprox,
                         target,
@@ -147,7 +243,6 @@ void CalcErrors(
                         errors[i],
                         ctx->LocalExecutor
                     );
-                    bool updateBestIteration = (i == 0) && (testIdx == trainingDataProviders.Test.size() - 1);
                     ctx->LearnProgress.MetricsAndTimeHistory.AddTestError(testIdx,
                                                                           *errors[i].Get(),
                                                                           errors[i]->GetFinalError(additiveStats),
@@ -156,4 +251,8 @@ void CalcErrors(
             }
         }
     }
+
+    if (backgroundErrorsCalcer) {
+        backgroundErrorsCalcer->Start(std::move(backgroundTasks));
+    }
 }
@@ -7,8 +7,15 @@
 #include <catboost/libs/metrics/metric.h>
 #include <catboost/libs/model/features.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/maybe.h>
+#include <util/generic/noncopyable.h>
 #include <util/generic/ptr.h>
 #include <util/generic/vector.h>
+#include <util/system/event.h>
+
+#include <exception>
 
 
 TVector<TFloatFeature> CreateFloatFeatures(const NCB::TQuantizedFeaturesInfo& quantizedFeaturesInfo);
@@ -17,10 +24,52 @@ TVector<TCatFeature> CreateCatFeatures(const NCB::TQuantizedFeaturesInfo& quanti
 
 void ConfigureMalloc();
 
+/************************************************************************/
+/* Evaluates metrics which are not needed to continue training          */
+/* (everything except the error tracker metric) in a separate thread,   */
+/* so that they are calculated while the next tree is built.            */
+/* Approxes are not copied, so training must call Wait() before it      */
+/* updates them.                                                        */
+/************************************************************************/
+class TBackgroundErrorsCalcer : public TNonCopyable {
+public:
+    struct TErrorTask {
+        const THolder<IMetric>* Metric = nullptr;
+        TMaybe<size_t> TestIdx; // Nothing() for learn
+        const TVector<TVector<double>>* Approx = nullptr;
+        TConstArrayRef<float> Target;
+        TConstArrayRef<float> Weights;
+        TConstArrayRef<TQueryInfo> QueryInfo;
+        double Error = 0;
+    };
+
+public:
+    TBackgroundErrorsCalcer();
+    ~TBackgroundErrorsCalcer();
+
+    void Start(TVector<TErrorTask>&& tasks);
+    bool HasPendingErrors() const {
+        return !Tasks.empty();
+    }
+    // waits until started errors are calculated, approxes can be changed after that
+    void Wait();
+    // waits for the errors and adds them to the history of the iteration they were started for,
+    // must be called before errors of the next iteration are added
+    void Finish(TMetricsAndTimeLeftHistory* metricsHistory);
+
+private:
+    NPar::TLocalExecutor Executor;
+    TVector<TErrorTask> Tasks;
+    TSystemEvent Done;
+    std::exception_ptr Exception;
+};
+
+// errors which are not needed immediately are started in backgroundErrorsCalcer if it is not nullptr
 void CalcErrors(
     const NCB::TTrainingForCPUDataProviders& trainingDataProviders,
     const TVector<THolder<IMetric>>& errors,
     bool calcAllMetrics, // bool value for each error
     bool calcErrorTrackerMetric,
-    TLearnContext* ctx
+    TLearnContext* ctx,
+    TBackgroundErrorsCalcer* backgroundErrorsCalcer = nullptr
 );
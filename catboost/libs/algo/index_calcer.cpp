@@ -162,6 +162,20 @@ static TVector<const TOnlineCTR*> GetOnlineCtrs(const TFold& fold, const TSplitT
     return onlineCtrs;
 }
 
+const ui32* GetFeaturesPermutation(const NCB::TFeaturesArraySubsetIndexing& featuresArraySubsetIndexing,
+                                   NPar::TLocalExecutor* localExecutor,
+                                   TVector<ui32>* permutationStorage) {
+    if (HoldsAlternative<TIndexedSubset<ui32>>(featuresArraySubsetIndexing)) {
+        return featuresArraySubsetIndexing.Get<TIndexedSubset<ui32>>().data();
+    }
+    permutationStorage->yresize(featuresArraySubsetIndexing.Size());
+    featuresArraySubsetIndexing.ParallelForEach(
+        [&](ui32 idx, ui32 srcIdx) { (*permutationStorage)[idx] = srcIdx; },
+        localExecutor
+    );
+    return permutationStorage->data();
+}
+
 static void BuildIndicesForDataset(const TSplitTree& tree,
                                    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
                                    const NCB::TFeaturesArraySubsetIndexing& featuresArraySubsetIndexing,
@@ -170,18 +184,8 @@ static void BuildIndicesForDataset(const TSplitTree& tree,
                                    int docOffset,
                                    NPar::TLocalExecutor* localExecutor,
                                    TIndexType* indices) {
-    const ui32* permutation = nullptr;
     TVector<ui32> permutationStorage;
-    if (HoldsAlternative<TIndexedSubset<ui32>>(featuresArraySubsetIndexing)) {
-        permutation = featuresArraySubsetIndexing.Get<TIndexedSubset<ui32>>().data();
-    } else {
-        permutationStorage.yresize(featuresArraySubsetIndexing.Size());
-        featuresArraySubsetIndexing.ParallelForEach(
-            [&](ui32 idx, ui32 srcIdx) { permutationStorage[idx] = srcIdx; },
-            localExecutor
-        );
-        permutation = permutationStorage.data();
-    }
+    const ui32* permutation = GetFeaturesPermutation(featuresArraySubsetIndexing, localExecutor, &permutationStorage);
 
     const int blockSize = 1000;
     NPar::TLocalExecutor::TExecRangeParams blockParams(0, (int)sampleCount);
@@ -212,6 +216,33 @@ static void BuildIndicesForDataset(const TSplitTree& tree,
     localExecutor->ExecRange(updateLearnIndex, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
+void BuildIndicesForDocRange(const TSplitTree& tree,
+                             const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+                             const ui32* permutation,
+                             ui32 docCount,
+                             TIndexType* indices) {
+    Fill(indices, indices + docCount, 0);
+    if (docCount == 0) {
+        return;
+    }
+    NPar::TLocalExecutor::TExecRangeParams rangeParams(0, (int)docCount);
+    rangeParams.SetBlockSize((int)docCount);
+    for (int splitIdx = 0; splitIdx < tree.GetDepth(); ++splitIdx) {
+        const auto& split = tree.Splits[splitIdx];
+        const int splitWeight = 1 << splitIdx;
+        if (split.Type == ESplitType::FloatFeature) {
+            OfflineCtrBlock<ui8, IsTrueHistogram>(rangeParams, /*blockIdx*/ 0, permutation,
+                GetFloatHistogram(split, objectsDataProvider),
+                GetFeatureSplitIdx(split), splitWeight, indices);
+        } else {
+            CB_ENSURE(split.Type == ESplitType::OneHotFeature, "Online ctr splits need precomputed indices");
+            OfflineCtrBlock<ui32, IsTrueOneHotFeature>(rangeParams, /*blockIdx*/ 0, permutation,
+                GetRemappedCatFeatures(split, objectsDataProvider),
+                (ui32)split.BinBorder, splitWeight, indices);
+        }
+    }
+}
+
 TVector<TIndexType> BuildIndices(const TFold& fold,
                                  const TSplitTree& tree,
                                  NCB::TTrainingForCPUDataProviderPtr learnData, // can be nullptr
@@ -271,22 +302,26 @@ void BinarizeFeatures(const TFullModel& model,
     const auto& featuresLayout = *rawObjectsData.GetFeaturesLayout();
     const ui32 flatFeaturesCount = featuresLayout.GetExternalFeatureCount();
 
-    auto getFeatureDataBeginPtr = [&](ui32 flatFeatureIdx) -> const float* {
-        return GetRawFeatureDataBeginPtr(
+    auto getFeatureData = [&](ui32 flatFeatureIdx, TVector<float>* sparseDataBuffer) {
+        return GetRawFeatureData(
             rawObjectsData,
             featuresLayout,
             consecutiveSubsetBegin,
-            flatFeatureIdx);
+            flatFeatureIdx,
+            start,
+            docCount,
+            sparseDataBuffer);
     };
 
     TVector<TConstArrayRef<float>> repackedFeatures(model.ObliviousTrees.GetFlatFeatureVectorExpectedSize());
+    TVector<TVector<float>> sparseFeaturesBuffers(model.ObliviousTrees.GetFlatFeatureVectorExpectedSize());
     if (columnReorderMap.empty()) {
         for (ui32 i = 0; i < flatFeaturesCount; ++i) {
-            repackedFeatures[i] = MakeArrayRef(getFeatureDataBeginPtr(i) + start, docCount);
+            repackedFeatures[i] = getFeatureData(i, &sparseFeaturesBuffers[i]);
         }
     } else {
         for (const auto& [origIdx, sourceIdx] : columnReorderMap) {
-            repackedFeatures[origIdx] = MakeArrayRef(getFeatureDataBeginPtr(sourceIdx) + start, docCount);
+            repackedFeatures[origIdx] = getFeatureData(sourceIdx, &sparseFeaturesBuffers[origIdx]);
         }
     }
 
@@ -317,13 +352,13 @@ TVector<ui8> BinarizeFeatures(const TFullModel& model, const NCB::TRawObjectsDat
     return BinarizeFeatures(model, rawObjectsData, /*start*/0, rawObjectsData.GetObjectCount());
 }
 
-TVector<TIndexType> BuildIndicesForBinTree(const TFullModel& model, const TVector<ui8>& binarizedFeatures, size_t treeId) {
+TVector<ui32> BuildIndicesForBinTree(const TFullModel& model, const TVector<ui8>& binarizedFeatures, size_t treeId) {
     if (model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount() == 0) {
-        return TVector<TIndexType>();
+        return TVector<ui32>();
     }
 
     auto docCount = binarizedFeatures.size() / model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount();
-    TVector<TIndexType> indexesVec(docCount);
+    TVector<ui32> indexesVec(docCount);
     const auto* treeSplitsCurPtr =
         model.ObliviousTrees.GetRepackedBins().data() +
         model.ObliviousTrees.TreeStartOffsets[treeId];
@@ -28,6 +28,18 @@ TVector<TIndexType> BuildIndices(const TFold& fold, // can be empty
                                  TConstArrayRef<NCB::TTrainingForCPUDataProviderPtr> testData, // can be empty
                                  NPar::TLocalExecutor* localExecutor);
 
+const ui32* GetFeaturesPermutation(const NCB::TFeaturesArraySubsetIndexing& featuresArraySubsetIndexing,
+                                   NPar::TLocalExecutor* localExecutor,
+                                   TVector<ui32>* permutationStorage);
+
+// Leaf indices of docCount documents whose feature indices are given by permutation;
+// the tree must not have online ctr splits, their values are available only for the whole fold
+void BuildIndicesForDocRange(const TSplitTree& tree,
+                             const NCB::TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+                             const ui32* permutation,
+                             ui32 docCount,
+                             TIndexType* indices);
+
 struct TFullModel;
 
 void BinarizeFeatures(const TFullModel& model,
@@ -43,6 +55,6 @@ TVector<ui8> BinarizeFeatures(const TFullModel& model,
 
 TVector<ui8> BinarizeFeatures(const TFullModel& model, const NCB::TRawObjectsDataProvider& rawObjectsData);
 
-TVector<TIndexType> BuildIndicesForBinTree(const TFullModel& model,
+TVector<ui32> BuildIndicesForBinTree(const TFullModel& model,
                                            const TVector<ui8>& binarizedFeatures,
                                            size_t treeId);
@@ -1,10 +1,11 @@
 #include "index_hash_calcer.h"
 
-/// Compute reindexHash and reindex hash values in range [begin,end).
-size_t ComputeReindexHash(ui64 topSize,
-                          TDenseHash<ui64, ui32>* reindexHashPtr,
-                          ui64* begin,
-                          ui64* end) {
+#include <util/generic/cast.h>
+
+static size_t ComputeReindexHashSequential(ui64 topSize,
+                                           TDenseHash<ui64, ui32>* reindexHashPtr,
+                                           ui64* begin,
+                                           ui64* end) {
     auto& reindexHash = *reindexHashPtr;
     auto* hashArr = begin;
     size_t learnSize = end - begin;
@@ -60,6 +61,105 @@ size_t ComputeReindexHash(ui64 topSize,
     return reindexHash.Size();
 }
 
+// Values of each block with their counts in the order of the first occurrence in the block
+static TVector<TVector<std::pair<ui64, ui32>>> CountBlockUniqueValues(
+    const ui64* hashArr,
+    const NPar::TLocalExecutor::TExecRangeParams& blockParams,
+    NPar::TLocalExecutor* localExecutor
+) {
+    TVector<TVector<std::pair<ui64, ui32>>> blockUniqueValues(blockParams.GetBlockCount());
+    localExecutor->ExecRange([&](int blockId) {
+        const int blockStart = blockParams.FirstId + blockId * blockParams.GetBlockSize();
+        const int nextBlockStart = Min(blockParams.LastId, blockStart + blockParams.GetBlockSize());
+        TDenseHash<ui64, ui32> valueIdx;
+        auto& uniqueValues = blockUniqueValues[blockId];
+        for (int i = blockStart; i < nextBlockStart; ++i) {
+            auto p = valueIdx.emplace(hashArr[i], uniqueValues.size());
+            if (p.second) {
+                uniqueValues.emplace_back(hashArr[i], 1);
+            } else {
+                ++uniqueValues[p.first->second].second;
+            }
+        }
+    }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
+    return blockUniqueValues;
+}
+
+/// Compute reindexHash and reindex hash values in range [begin,end).
+size_t ComputeReindexHash(ui64 topSize,
+                          TDenseHash<ui64, ui32>* reindexHashPtr,
+                          ui64* begin,
+                          ui64* end,
+                          NPar::TLocalExecutor* localExecutor) {
+    size_t learnSize = end - begin;
+    if (localExecutor == nullptr || localExecutor->GetThreadCount() == 0 || learnSize == 0) {
+        return ComputeReindexHashSequential(topSize, reindexHashPtr, begin, end);
+    }
+    auto& reindexHash = *reindexHashPtr;
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(learnSize));
+    blockParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
+
+    // Values are inserted into reindexHash in the same order as in the sequential calculation,
+    // so ids and the layout of reindexHash (and hence the order of its iteration) do not change
+    const auto blockUniqueValues = CountBlockUniqueValues(begin, blockParams, localExecutor);
+    ui32 counter = 0;
+    if (topSize > learnSize) {
+        for (const auto& uniqueValues : blockUniqueValues) {
+            for (const auto& valueWithCount : uniqueValues) {
+                if (reindexHash.emplace(valueWithCount.first, counter).second) {
+                    ++counter;
+                }
+            }
+        }
+    } else {
+        for (const auto& uniqueValues : blockUniqueValues) {
+            for (const auto& valueWithCount : uniqueValues) {
+                reindexHash[valueWithCount.first] += valueWithCount.second;
+            }
+        }
+
+        if (reindexHash.Size() <= topSize) {
+            for (auto& it : reindexHash) {
+                it.second = counter;
+                ++counter;
+            }
+        } else {
+            // Limit reindexHash to topSize buckets
+            using TFreqPair = std::pair<ui64, ui32>;
+            TVector<TFreqPair> freqValList;
+
+            freqValList.reserve(reindexHash.Size());
+            for (const auto& it : reindexHash) {
+                freqValList.emplace_back(it.first, it.second);
+            }
+            std::nth_element(freqValList.begin(), freqValList.begin() + topSize, freqValList.end(),
+                         [](const TFreqPair& a, const TFreqPair& b) {
+                             return a.second > b.second;
+                         });
+
+            reindexHash.MakeEmpty();
+            for (ui32 i = 0; i < topSize; ++i) {
+                reindexHash[freqValList[i].first] = i;
+            }
+        }
+    }
+
+    const auto& constReindexHash = reindexHash;
+    const ui64 missingValueIdx = reindexHash.Size() - 1;
+    localExecutor->ExecRange([&](int blockId) {
+        const int blockStart = blockId * blockParams.GetBlockSize();
+        const int nextBlockStart = Min(blockParams.LastId, blockStart + blockParams.GetBlockSize());
+        for (int i = blockStart; i < nextBlockStart; ++i) {
+            if (const auto* p = constReindexHash.FindPtr(begin[i])) {
+                begin[i] = *p;
+            } else {
+                begin[i] = missingValueIdx;
+            }
+        }
+    }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
+    return reindexHash.Size();
+}
+
 /// Update reindexHash and reindex hash values in range [begin,end).
 size_t UpdateReindexHash(TDenseHash<ui64, ui32>* reindexHashPtr, ui64* begin, ui64* end) {
     auto& reindexHash = *reindexHashPtr;
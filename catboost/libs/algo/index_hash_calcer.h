@@ -6,10 +6,20 @@
 #include <catboost/libs/helpers/clear_array.h>
 
 #include <library/containers/dense_hash/dense_hash.h>
+#include <library/threading/local_executor/local_executor.h>
 
 #include <util/generic/utility.h>
 
 
+template <class TArraySubsetType, class F>
+inline void ForEachMaybeParallel(const TArraySubsetType& arraySubset, F&& f, NPar::TLocalExecutor* localExecutor) {
+    if (localExecutor) {
+        arraySubset.ParallelForEach(std::move(f), localExecutor);
+    } else {
+        arraySubset.ForEach(std::move(f));
+    }
+}
+
 /// Calculate document hashes into range [begin,end) for CTR bucket identification.
 /// @param proj - Projection delivering the feature ids to hash
 /// @param objectsDataProvider - Values of features to hash
@@ -17,12 +27,14 @@
 /// @param perfectHashedToHashedCatValuesMap - if not nullptr use it to Hash original hashed cat values
 //                                             if nullptr - used perfectHashed values
 /// @param begin, @param end - Result range
+/// @param localExecutor - if not nullptr hash documents in parallel (result is the same)
 inline void CalcHashes(const TProjection& proj,
                        const NCB::TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
                        const NCB::TFeaturesArraySubsetIndexing& featuresSubsetIndexing,
                        const NCB::TPerfectHashedToHashedCatValuesMap* perfectHashedToHashedCatValuesMap,
                        ui64* begin,
-                       ui64* end) {
+                       ui64* end,
+                       NPar::TLocalExecutor* localExecutor = nullptr) {
     const size_t sampleCount = end - begin;
     Y_VERIFY((size_t)featuresSubsetIndexing.Size() == sampleCount);
     if (sampleCount == 0) {
@@ -34,37 +46,43 @@ inline void CalcHashes(const TProjection& proj,
         for (const int featureIdx : proj.CatFeatures) {
             const auto& ohv = (*perfectHashedToHashedCatValuesMap)[featureIdx];
 
-            NCB::SubsetWithAlternativeIndexing(
-                objectsDataProvider.GetCatFeature((ui32)featureIdx),
-                &featuresSubsetIndexing
-            ).ForEach(
+            ForEachMaybeParallel(
+                NCB::SubsetWithAlternativeIndexing(
+                    objectsDataProvider.GetCatFeature((ui32)featureIdx),
+                    &featuresSubsetIndexing
+                ),
                 [hashArr, &ohv] (ui32 i, ui32 featureValue) {
                     hashArr[i] = CalcHash(hashArr[i], (ui64)(int)ohv[featureValue]);
-                }
+                },
+                localExecutor
             );
         }
     } else {
         for (const int featureIdx : proj.CatFeatures) {
-            NCB::SubsetWithAlternativeIndexing(
-                objectsDataProvider.GetCatFeature((ui32)featureIdx),
-                &featuresSubsetIndexing
-            ).ForEach(
+            ForEachMaybeParallel(
+                NCB::SubsetWithAlternativeIndexing(
+                    objectsDataProvider.GetCatFeature((ui32)featureIdx),
+                    &featuresSubsetIndexing
+                ),
                 [hashArr] (ui32 i, ui32 featureValue) {
                     hashArr[i] = CalcHash(hashArr[i], (ui64)featureValue + 1);
-                }
+                },
+                localExecutor
             );
         }
     }
 
     for (const TBinFeature& feature : proj.BinFeatures) {
-        NCB::SubsetWithAlternativeIndexing(
-            objectsDataProvider.GetFloatFeature((ui32)feature.FloatFeature),
-            &featuresSubsetIndexing
-        ).ForEach(
+        ForEachMaybeParallel(
+            NCB::SubsetWithAlternativeIndexing(
+                objectsDataProvider.GetFloatFeature((ui32)feature.FloatFeature),
+                &featuresSubsetIndexing
+            ),
             [feature, hashArr] (ui32 i, ui8 featureValue) {
                 const bool isTrueFeature = IsTrueHistogram(featureValue, (ui8)feature.SplitIdx);
                 hashArr[i] = CalcHash(hashArr[i], (ui64)isTrueFeature);
-            }
+            },
+            localExecutor
         );
     }
 
@@ -77,14 +95,16 @@ inline void CalcHashes(const TProjection& proj,
         );
         const ui32 maxBin = uniqueValuesCounts.OnLearnOnly;
 
-        NCB::SubsetWithAlternativeIndexing(
-            objectsDataProvider.GetCatFeature(*catFeatureIdx),
-            &featuresSubsetIndexing
-        ).ForEach(
+        ForEachMaybeParallel(
+            NCB::SubsetWithAlternativeIndexing(
+                objectsDataProvider.GetCatFeature(*catFeatureIdx),
+                &featuresSubsetIndexing
+            ),
             [feature, hashArr, maxBin] (ui32 i, ui32 featureValue) {
                 const bool isTrueFeature = IsTrueOneHotFeature(Min(featureValue, maxBin), (ui32)feature.Value);
                 hashArr[i] = CalcHash(hashArr[i], (ui64)isTrueFeature);
-            }
+            },
+            localExecutor
         );
     }
 }
@@ -93,8 +113,15 @@ inline void CalcHashes(const TProjection& proj,
 /// After reindex, hash values belong to [0, reindexHash.Size()].
 /// If reindexHash would become larger than topSize, keep only topSize most
 /// frequent mappings and map other hash values to value reindexHash.Size().
+/// If localExecutor is not nullptr, values are counted by blocks in parallel and merged in the order of
+/// their first occurrence, so the result is the same as for the sequential calculation.
 /// @return the size of reindexHash.
-size_t ComputeReindexHash(ui64 topSize, TDenseHash<ui64, ui32>* reindexHashPtr, ui64* begin, ui64* end);
+size_t ComputeReindexHash(
+    ui64 topSize,
+    TDenseHash<ui64, ui32>* reindexHashPtr,
+    ui64* begin,
+    ui64* end,
+    NPar::TLocalExecutor* localExecutor = nullptr);
 
 /// Update reindexHash and reindex hash values in range [begin,end).
 /// If a hash value is not present in reindexHash, then update reindexHash for that value.
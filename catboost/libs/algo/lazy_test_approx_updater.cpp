@@ -0,0 +1,146 @@
+#include "lazy_test_approx_updater.h"
+
+#include "index_calcer.h"
+
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
+#include <util/generic/xrange.h>
+
+
+using namespace NCB;
+
+
+// 64M indices take 128MB
+static constexpr size_t MAX_STORED_INDEX_COUNT = 64 * 1024 * 1024;
+
+// small enough to keep approxes and indices of a block in cache while all pending trees are applied
+static constexpr int UPDATE_BLOCK_SIZE = 1024;
+
+
+void TLazyTestApproxUpdater::Init(size_t testCount) {
+    PendingTrees.clear();
+    AppliedTreeCount.assign(testCount, 0);
+    StoredIndexCount = 0;
+}
+
+void TLazyTestApproxUpdater::AddTree(
+    const TSplitTree& tree,
+    const TVector<TVector<double>>& leafValues,
+    TConstArrayRef<TIndexType> testIndices,
+    TConstArrayRef<TTrainingForCPUDataProviderPtr> testData
+) {
+    Y_ASSERT(AppliedTreeCount.size() == testData.size());
+    if (testData.empty()) {
+        return;
+    }
+    PendingTrees.emplace_back();
+    TPendingTree& pendingTree = PendingTrees.back();
+    pendingTree.Tree = tree;
+    pendingTree.LeafValues = leafValues;
+    if (NeedsStoredIndices(tree)) {
+        pendingTree.TestIndices.resize(testData.size());
+        size_t testOffset = 0;
+        for (size_t testIdx : xrange(testData.size())) {
+            const size_t testSampleCount = testData[testIdx] ? testData[testIdx]->GetObjectCount() : 0;
+            Y_ASSERT(testOffset + testSampleCount <= testIndices.size());
+            pendingTree.TestIndices[testIdx].assign(
+                testIndices.begin() + testOffset,
+                testIndices.begin() + testOffset + testSampleCount);
+            testOffset += testSampleCount;
+        }
+        StoredIndexCount += testOffset;
+    }
+}
+
+bool TLazyTestApproxUpdater::IsUpToDate(size_t testIdx) const {
+    return AppliedTreeCount[testIdx] == PendingTrees.size();
+}
+
+bool TLazyTestApproxUpdater::HasTooManyStoredIndices() const {
+    return StoredIndexCount > MAX_STORED_INDEX_COUNT;
+}
+
+void TLazyTestApproxUpdater::Update(
+    size_t testIdx,
+    TConstArrayRef<TTrainingForCPUDataProviderPtr> testData,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<TVector<double>>* testApprox
+) {
+    if (IsUpToDate(testIdx)) {
+        return;
+    }
+    const size_t firstTreeIdx = AppliedTreeCount[testIdx];
+    const size_t treeCount = PendingTrees.size();
+    const auto* testSet = testData[testIdx].Get();
+    const ui32 docCount = testSet ? testSet->GetObjectCount() : 0;
+
+    if (docCount > 0) {
+        const TQuantizedForCPUObjectsDataProvider& objectsData = *testSet->ObjectsData;
+        TVector<ui32> permutationStorage;
+        const ui32* permutation = GetFeaturesPermutation(
+            objectsData.GetFeaturesArraySubsetIndexing(),
+            localExecutor,
+            &permutationStorage);
+
+        NPar::TLocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(docCount));
+        blockParams.SetBlockSize(UPDATE_BLOCK_SIZE);
+        localExecutor->ExecRange([&](int blockIdx) {
+            const ui32 blockStart = blockIdx * blockParams.GetBlockSize();
+            const ui32 blockSize = Min<ui32>(blockParams.GetBlockSize(), docCount - blockStart);
+            TVector<TIndexType> blockIndices;
+            for (size_t treeIdx : xrange(firstTreeIdx, treeCount)) {
+                const TPendingTree& pendingTree = PendingTrees[treeIdx];
+                const TIndexType* indices;
+                if (pendingTree.TestIndices.empty()) {
+                    blockIndices.yresize(blockSize);
+                    BuildIndicesForDocRange(pendingTree.Tree, objectsData, permutation + blockStart, blockSize, blockIndices.data());
+                    indices = blockIndices.data();
+                } else {
+                    indices = pendingTree.TestIndices[testIdx].data() + blockStart;
+                }
+                for (size_t dim : xrange(testApprox->size())) {
+                    const double* leafValues = pendingTree.LeafValues[dim].data();
+                    double* approx = (*testApprox)[dim].data() + blockStart;
+                    for (ui32 doc = 0; doc < blockSize; ++doc) {
+                        approx[doc] += leafValues[indices[doc]];
+                    }
+                }
+            }
+        }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
+    }
+
+    for (size_t treeIdx : xrange(firstTreeIdx, treeCount)) {
+        TPendingTree& pendingTree = PendingTrees[treeIdx];
+        if (!pendingTree.TestIndices.empty()) {
+            StoredIndexCount -= pendingTree.TestIndices[testIdx].size();
+            pendingTree.TestIndices[testIdx] = TVector<TIndexType>();
+        }
+    }
+    AppliedTreeCount[testIdx] = treeCount;
+    DropAppliedTrees();
+}
+
+void TLazyTestApproxUpdater::UpdateAll(
+    TConstArrayRef<TTrainingForCPUDataProviderPtr> testData,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<TVector<TVector<double>>>* testApprox
+) {
+    for (size_t testIdx : xrange(testData.size())) {
+        Update(testIdx, testData, localExecutor, &(*testApprox)[testIdx]);
+    }
+}
+
+void TLazyTestApproxUpdater::DropAppliedTrees() {
+    if (AppliedTreeCount.empty()) {
+        PendingTrees.clear();
+        return;
+    }
+    const size_t appliedToAllCount = *MinElement(AppliedTreeCount.begin(), AppliedTreeCount.end());
+    if (appliedToAllCount == 0) {
+        return;
+    }
+    PendingTrees.erase(PendingTrees.begin(), PendingTrees.begin() + appliedToAllCount);
+    for (auto& appliedTreeCount : AppliedTreeCount) {
+        appliedTreeCount -= appliedToAllCount;
+    }
+}
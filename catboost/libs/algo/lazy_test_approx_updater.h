@@ -0,0 +1,70 @@
+#pragma once
+
+#include "split.h"
+
+#include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/options/restrictions.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+/************************************************************************/
+/* Trees which are not applied to test approxes yet.                    */
+/* Test approxes are needed only when test metrics are calculated, so   */
+/* new trees are queued and applied to a test set in one pass over its  */
+/* documents. Trees are applied in the order they were added, so the    */
+/* approxes are exactly the same as with the update after every tree.   */
+/************************************************************************/
+class TLazyTestApproxUpdater {
+public:
+    void Init(size_t testCount);
+
+    // testIndices are [docIdx] for all test sets concatenated, as returned by BuildIndices,
+    // they are needed only for trees with online ctr splits
+    void AddTree(
+        const TSplitTree& tree,
+        const TVector<TVector<double>>& leafValues, // [dim][leafId]
+        TConstArrayRef<TIndexType> testIndices,
+        TConstArrayRef<NCB::TTrainingForCPUDataProviderPtr> testData
+    );
+
+    bool IsUpToDate(size_t testIdx) const;
+
+    // stored indices take memory proportional to test size, so they should not be kept for too many trees
+    bool HasTooManyStoredIndices() const;
+
+    void Update(
+        size_t testIdx,
+        TConstArrayRef<NCB::TTrainingForCPUDataProviderPtr> testData,
+        NPar::TLocalExecutor* localExecutor,
+        TVector<TVector<double>>* testApprox // [dim][docIdx]
+    );
+
+    void UpdateAll(
+        TConstArrayRef<NCB::TTrainingForCPUDataProviderPtr> testData,
+        NPar::TLocalExecutor* localExecutor,
+        TVector<TVector<TVector<double>>>* testApprox // [test][dim][docIdx]
+    );
+
+    static bool NeedsStoredIndices(const TSplitTree& tree) {
+        return !tree.GetCtrSplits().empty();
+    }
+
+private:
+    void DropAppliedTrees();
+
+private:
+    struct TPendingTree {
+        TSplitTree Tree;
+        TVector<TVector<double>> LeafValues;      // [dim][leafId]
+        TVector<TVector<TIndexType>> TestIndices; // [test][docIdx], empty if indices are computed on update
+    };
+
+    TVector<TPendingTree> PendingTrees;
+    TVector<size_t> AppliedTreeCount; // [test]
+    size_t StoredIndexCount = 0;
+};
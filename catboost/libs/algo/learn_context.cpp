@@ -17,6 +17,10 @@
 #include <util/folder/path.h>
 #include <util/system/fs.h>
 #include <util/stream/file.h>
+#include <util/stream/str.h>
+
+#include <exception>
+#include <utility>
 
 
 using namespace NCB;
@@ -24,6 +28,11 @@ using namespace NCB;
 
 
 TLearnContext::~TLearnContext() {
+    try {
+        WaitForSavedProgress();
+    } catch (...) {
+        CATBOOST_WARNING_LOG << "Can't save snapshot: " << CurrentExceptionMessage() << Endl;
+    }
     if (Params.SystemOptions->IsMaster()) {
         FinalizeMaster(this);
     }
@@ -164,6 +173,8 @@ void TLearnContext::InitContext(const TTrainingForCPUDataProviders& data) {
         }
     }
 
+    TestApproxUpdater.Init(data.Test.size());
+
     const ui32 maxBodyTailCount = Max(1, GetMaxBodyTailCount(LearnProgress.Folds));
     UseTreeLevelCachingFlag = NeedToUseTreeLevelCaching(Params, maxBodyTailCount, LearnProgress.ApproxDimension);
 }
@@ -172,9 +183,47 @@ void TLearnContext::SaveProgress() {
     if (!OutputOptions.SaveSnapshot()) {
         return;
     }
-    TProgressHelper(ToString(ETaskType::CPU)).Write(Files.SnapshotFile, [&](IOutputStream* out) {
-        ::SaveMany(out, Rand, LearnProgress, Profile.DumpProfileInfo());
-    });
+    // only one snapshot is written at a time, the new one would replace the previous anyway
+    WaitForSavedProgress();
+
+    // serializing to memory is much faster than writing the file with md5,
+    // so training is blocked only while the consistent copy is made
+    auto snapshot = MakeAtomicShared<TString>();
+    {
+        TStringOutput out(*snapshot);
+        ::SaveMany(&out, Rand, LearnProgress, Profile.DumpProfileInfo());
+    }
+
+    if (SnapshotExecutor.GetThreadCount() == 0) {
+        SnapshotExecutor.RunAdditionalThreads(1);
+    }
+    IsSnapshotBeingSaved = true;
+    SnapshotException = nullptr;
+    SnapshotSaved.Reset();
+    SnapshotExecutor.Exec(
+        [this, snapshot, snapshotFile = Files.SnapshotFile](int) {
+            try {
+                TProgressHelper(ToString(ETaskType::CPU)).Write(snapshotFile, [&](IOutputStream* out) {
+                    out->Write(snapshot->data(), snapshot->size());
+                });
+            } catch (...) {
+                SnapshotException = std::current_exception();
+            }
+            SnapshotSaved.Signal();
+        },
+        0,
+        0
+    );
+}
+
+void TLearnContext::WaitForSavedProgress() {
+    if (IsSnapshotBeingSaved) {
+        SnapshotSaved.Wait();
+        IsSnapshotBeingSaved = false;
+        if (SnapshotException) {
+            std::rethrow_exception(std::exchange(SnapshotException, nullptr));
+        }
+    }
 }
 
 bool TLearnContext::TryLoadProgress() {
@@ -6,6 +6,7 @@
 #include "split.h"
 #include "calc_score_cache.h"
 #include "custom_objective_descriptor.h"
+#include "lazy_test_approx_updater.h"
 
 #include <catboost/libs/data_new/data_provider.h>
 #include <catboost/libs/data_new/features_layout.h>
@@ -24,6 +25,9 @@
 
 #include <util/generic/noncopyable.h>
 #include <util/generic/hash_set.h>
+#include <util/system/event.h>
+
+#include <exception>
 
 
 struct TLearnProgress {
@@ -117,7 +121,10 @@ public:
 
     void OutputMeta();
     void InitContext(const NCB::TTrainingForCPUDataProviders& data);
+    // the snapshot is written in a separate thread from a serialized copy of the progress
     void SaveProgress();
+    // rethrows an exception from writing the snapshot
+    void WaitForSavedProgress();
     bool TryLoadProgress();
     bool UseTreeLevelCaching() const;
 
@@ -130,12 +137,17 @@ public:
     TCalcScoreFold SmallestSplitSideDocs;
     TCalcScoreFold SampledDocs;
     TBucketStatsCache PrevTreeLevelStats;
+    TLazyTestApproxUpdater TestApproxUpdater;
     TObj<NPar::IRootEnvironment> RootEnvironment;
     TObj<NPar::IEnvironment> SharedTrainData;
     TProfileInfo Profile;
 
 private:
     bool UseTreeLevelCachingFlag;
+    NPar::TLocalExecutor SnapshotExecutor;
+    TSystemEvent SnapshotSaved;
+    std::exception_ptr SnapshotException;
+    bool IsSnapshotBeingSaved = false;
 };
 
 bool NeedToUseTreeLevelCaching(
@@ -8,10 +8,14 @@
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/resource_constrained_executor.h>
 #include <catboost/libs/model/model.h>
+#include <catboost/libs/options/system_options.h>
+
+#include <library/blockcodecs/codecs.h>
 
 #include <util/generic/bitops.h>
 #include <util/generic/utility.h>
 #include <util/stream/format.h>
+#include <util/system/info.h>
 #include <util/system/mem_info.h>
 #include <util/thread/singleton.h>
 
@@ -96,6 +100,58 @@ void CalcNormalization(const TVector<float>& priors, TVector<float>* shift, TVec
 
 
 
+TAtomicSharedPtr<const TVector<ui32>> TProjectionHashCache::Get(const TProjection& proj) {
+    with_lock (Lock) {
+        auto* entry = Entries.FindPtr(proj);
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        entry->LastUseTime = ++Time;
+        return entry->HashIds;
+    }
+}
+
+void TProjectionHashCache::Put(const TProjection& proj, TVector<ui32>&& hashIds, size_t memoryLimit) {
+    const size_t neededMemory = hashIds.size() * sizeof(ui32);
+    if (neededMemory > memoryLimit) {
+        return;
+    }
+    with_lock (Lock) {
+        if (Entries.contains(proj)) {
+            return;
+        }
+        if (UsedMemory + neededMemory > memoryLimit) {
+            EvictUnlocked(UsedMemory + neededMemory - memoryLimit);
+        }
+        UsedMemory += neededMemory;
+        Entries[proj] = TEntry{MakeAtomicShared<const TVector<ui32>>(std::move(hashIds)), ++Time};
+    }
+}
+
+size_t TProjectionHashCache::Evict(size_t memorySize) {
+    with_lock (Lock) {
+        return EvictUnlocked(memorySize);
+    }
+}
+
+size_t TProjectionHashCache::GetUsedMemory() const {
+    with_lock (Lock) {
+        return UsedMemory;
+    }
+}
+
+size_t TProjectionHashCache::EvictUnlocked(size_t memorySize) {
+    size_t freedMemory = 0;
+    while (freedMemory < memorySize && !Entries.empty()) {
+        auto leastRecentlyUsed = MinElementBy(Entries.begin(), Entries.end(), [] (const auto& projEntry) { return projEntry.second.LastUseTime; });
+        const size_t entryMemory = leastRecentlyUsed->second.HashIds->size() * sizeof(ui32);
+        UsedMemory -= entryMemory;
+        freedMemory += entryMemory;
+        Entries.erase(leastRecentlyUsed);
+    }
+    return freedMemory;
+}
+
 static void UpdateGoodCount(int curCount, ECtrType ctrType, int* goodCount) {
     if (ctrType == ECtrType::Buckets) {
         *goodCount = curCount;
@@ -337,6 +393,257 @@ static inline void CountOnlineCTRTotal(const TVector<ui64>& hashArr, int sampleC
     }
 }
 
+static void CalcOnlineCTR(const TVector<size_t>& testOffsets,
+                          const TVector<ui64>& enumeratedCatFeatures,
+                          size_t leafCount,
+                          const TVector<int>& permutedTargetClass,
+                          const TVector<int>& counterCTRTotal,
+                          int counterCTRDenominator,
+                          ECtrType ctrType,
+                          int targetClassesCount,
+                          int targetBorderCount,
+                          const TVector<float>& priors,
+                          int ctrBorderCount,
+                          TArray2D<TVector<ui8>>* feature) {
+    if (ctrType == ECtrType::Borders && targetClassesCount == SIMPLE_CLASSES_COUNT) {
+        CalcOnlineCTRSimple(
+            testOffsets,
+            enumeratedCatFeatures,
+            leafCount,
+            permutedTargetClass,
+            priors,
+            ctrBorderCount,
+            feature);
+
+    } else if (ctrType == ECtrType::BinarizedTargetMeanValue) {
+        CalcOnlineCTRMean(
+            testOffsets,
+            enumeratedCatFeatures,
+            leafCount,
+            permutedTargetClass,
+            targetClassesCount - 1,
+            priors,
+            ctrBorderCount,
+            feature);
+
+    } else if (ctrType == ECtrType::Buckets ||
+               (ctrType == ECtrType::Borders && targetClassesCount > SIMPLE_CLASSES_COUNT)) {
+        CalcOnlineCTRClasses(
+            testOffsets,
+            enumeratedCatFeatures,
+            leafCount,
+            permutedTargetClass,
+            targetClassesCount,
+            targetBorderCount,
+            priors,
+            ctrBorderCount,
+            ctrType,
+            feature);
+    } else {
+        Y_ASSERT(ctrType == ECtrType::Counter);
+        CalcOnlineCTRCounter(
+            testOffsets,
+            counterCTRTotal,
+            enumeratedCatFeatures,
+            counterCTRDenominator,
+            priors,
+            ctrBorderCount,
+            feature);
+    }
+}
+
+namespace {
+    // Learn and test documents with leaf ids equal to ShardIdx modulo shard count.
+    // Online statistics of different leaves do not depend on each other,
+    // so shards can be processed in parallel with exactly the same result as sequential calculation.
+    struct TOnlineCtrShard {
+        TVector<ui32> DocIndices; // in the original order
+        TVector<size_t> TestOffsets;
+        TVector<ui64> EnumeratedCatFeatures; // leaf ids divided by shard count
+        size_t LeafCount = 0;
+    };
+}
+
+static TVector<TOnlineCtrShard> SplitOnlineCtrShards(const TVector<size_t>& testOffsets,
+                                                     const TVector<ui64>& enumeratedCatFeatures,
+                                                     size_t leafCount,
+                                                     NPar::TLocalExecutor* localExecutor) {
+    const int shardCount = localExecutor->GetThreadCount() + 1;
+    const size_t docCount = testOffsets.empty() ? 0 : testOffsets.back();
+
+    // count documents of each shard first to distribute them in a single pass without reallocations
+    TVector<size_t> shardDocCounts(shardCount, 0);
+    for (size_t docIdx = 0; docIdx < docCount; ++docIdx) {
+        ++shardDocCounts[enumeratedCatFeatures[docIdx] % shardCount];
+    }
+
+    TVector<TOnlineCtrShard> shards(shardCount);
+    for (int shardIdx = 0; shardIdx < shardCount; ++shardIdx) {
+        auto& shard = shards[shardIdx];
+        shard.LeafCount = (leafCount + shardCount - 1) / shardCount;
+        shard.TestOffsets.reserve(testOffsets.size());
+        shard.DocIndices.yresize(shardDocCounts[shardIdx]);
+        shard.EnumeratedCatFeatures.yresize(shardDocCounts[shardIdx]);
+    }
+
+    TVector<size_t> shardDocPositions(shardCount, 0);
+    size_t docIdx = 0;
+    for (size_t nextOffset : testOffsets) {
+        for (; docIdx < nextOffset; ++docIdx) {
+            const ui64 leafIdx = enumeratedCatFeatures[docIdx];
+            const int shardIdx = leafIdx % shardCount;
+            auto& shard = shards[shardIdx];
+            const size_t position = shardDocPositions[shardIdx]++;
+            shard.DocIndices[position] = docIdx;
+            shard.EnumeratedCatFeatures[position] = leafIdx / shardCount;
+        }
+        for (int shardIdx = 0; shardIdx < shardCount; ++shardIdx) {
+            shards[shardIdx].TestOffsets.push_back(shardDocPositions[shardIdx]);
+        }
+    }
+    return shards;
+}
+
+static void CalcOnlineCTRByShards(const TVector<TOnlineCtrShard>& shards,
+                                  const TVector<int>& permutedTargetClass,
+                                  const TVector<int>& counterCTRTotal,
+                                  int counterCTRDenominator,
+                                  ECtrType ctrType,
+                                  int targetClassesCount,
+                                  int targetBorderCount,
+                                  const TVector<float>& priors,
+                                  int ctrBorderCount,
+                                  NPar::TLocalExecutor* localExecutor,
+                                  TArray2D<TVector<ui8>>* feature) {
+    const int shardCount = shards.ysize();
+    NPar::ParallelFor(*localExecutor, 0, shardCount, [&] (int shardIdx) {
+        const auto& shard = shards[shardIdx];
+        const size_t shardLearnSampleCount = shard.TestOffsets[0];
+
+        TVector<int> shardTargetClass;
+        TVector<int> shardCounterCTRTotal;
+        if (ctrType == ECtrType::Counter) {
+            shardCounterCTRTotal.yresize(shard.LeafCount);
+            for (size_t leafIdx = 0; leafIdx < shard.LeafCount; ++leafIdx) {
+                const size_t globalLeafIdx = leafIdx * shardCount + shardIdx;
+                shardCounterCTRTotal[leafIdx] = globalLeafIdx < counterCTRTotal.size() ? counterCTRTotal[globalLeafIdx] : 0;
+            }
+        } else {
+            shardTargetClass.yresize(shardLearnSampleCount);
+            for (size_t i = 0; i < shardLearnSampleCount; ++i) {
+                shardTargetClass[i] = permutedTargetClass[shard.DocIndices[i]];
+            }
+        }
+
+        TArray2D<TVector<ui8>> shardFeature;
+        shardFeature.SetSizes(priors.size(), targetBorderCount);
+        for (int border = 0; border < targetBorderCount; ++border) {
+            for (int prior = 0; prior < priors.ysize(); ++prior) {
+                Clear(&shardFeature[border][prior], shard.DocIndices.size());
+            }
+        }
+        CalcOnlineCTR(
+            shard.TestOffsets,
+            shard.EnumeratedCatFeatures,
+            shard.LeafCount,
+            shardTargetClass,
+            shardCounterCTRTotal,
+            counterCTRDenominator,
+            ctrType,
+            targetClassesCount,
+            targetBorderCount,
+            priors,
+            ctrBorderCount,
+            &shardFeature);
+
+        for (int border = 0; border < targetBorderCount; ++border) {
+            for (int prior = 0; prior < priors.ysize(); ++prior) {
+                const ui8* shardFeatureData = shardFeature[border][prior].data();
+                ui8* featureData = (*feature)[border][prior].data();
+                for (size_t i = 0; i < shard.DocIndices.size(); ++i) {
+                    featureData[shard.DocIndices[i]] = shardFeatureData[i];
+                }
+            }
+        }
+    });
+}
+
+// Find a projection with cached hashes that differs from proj by one cat feature
+static TAtomicSharedPtr<const TVector<ui32>> GetBaseProjectionHashIds(const TProjection& proj,
+                                                                      TProjectionHashCache* cache,
+                                                                      int* addedCatFeature) {
+    for (int catFeature : proj.CatFeatures) {
+        TProjection baseProj = proj;
+        baseProj.CatFeatures.erase(Find(baseProj.CatFeatures, catFeature));
+        if (baseProj.IsEmpty()) {
+            continue;
+        }
+        auto baseHashIds = cache->Get(baseProj);
+        if (baseHashIds) {
+            *addedCatFeature = catFeature;
+            return baseHashIds;
+        }
+    }
+    return nullptr;
+}
+
+// Documents have equal hashes iff they have equal base projection hash ids and equal values of
+// the added feature, so the partition into ctr leaves is the same as for CalcHashes
+static void CalcHashesForExtendedProjection(const TTrainingForCPUDataProviders& data,
+                                            const TFold& fold,
+                                            const TVector<ui32>& baseHashIds,
+                                            int addedCatFeature,
+                                            NPar::TLocalExecutor* localExecutor,
+                                            TVector<ui64>* hashArr) {
+    const size_t learnSampleCount = data.Learn->GetObjectCount();
+    const size_t totalSampleCount = learnSampleCount + data.GetTestSampleCount();
+    Y_ASSERT(baseHashIds.size() == totalSampleCount);
+    Clear(hashArr, totalSampleCount);
+    TArrayRef<ui64> hashArrView = *hashArr;
+    const ui32* baseHashIdsData = baseHashIds.data();
+    if (learnSampleCount > 0) {
+        ForEachMaybeParallel(
+            SubsetWithAlternativeIndexing(
+                data.Learn->ObjectsData->GetCatFeature((ui32)addedCatFeature),
+                &fold.LearnPermutationFeaturesSubset
+            ),
+            [hashArrView, baseHashIdsData] (ui32 i, ui32 featureValue) {
+                hashArrView[i] = CalcHash((ui64)baseHashIdsData[i], (ui64)featureValue + 1);
+            },
+            localExecutor
+        );
+    }
+    for (size_t docOffset = learnSampleCount, testIdx = 0; docOffset < totalSampleCount && testIdx < data.Test.size(); ++testIdx) {
+        const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
+        ForEachMaybeParallel(
+            (*data.Test[testIdx]->ObjectsData->GetCatFeature((ui32)addedCatFeature))->GetArrayData(),
+            [hashArrView, baseHashIdsData, docOffset] (ui32 i, ui32 featureValue) {
+                hashArrView[docOffset + i] = CalcHash((ui64)baseHashIdsData[docOffset + i], (ui64)featureValue + 1);
+            },
+            localExecutor
+        );
+        docOffset += testSampleCount;
+    }
+}
+
+// Used if the size of physical memory is unknown
+static constexpr ui64 DEFAULT_PROJECTION_HASH_CACHES_MEMORY_LIMIT = 1ull << 30;
+
+// A quarter of the memory limit is shared between the hash caches of all folds,
+// if the limit is not set (it is infinite by default) 1/16 of physical memory is used instead
+static size_t GetProjectionHashCacheMemoryLimit(const TLearnContext& ctx) {
+    const ui64 memoryLimit = ParseMemorySizeDescription(ctx.Params.SystemOptions->CpuUsedRamLimit.Get());
+    ui64 cachesMemoryLimit = memoryLimit / 4;
+    if (memoryLimit == Max<ui64>()) {
+        const ui64 totalMemorySize = NSystemInfo::TotalMemorySize();
+        cachesMemoryLimit = totalMemorySize ? totalMemorySize / 16 : DEFAULT_PROJECTION_HASH_CACHES_MEMORY_LIMIT;
+    }
+    return cachesMemoryLimit / (ctx.LearnProgress.Folds.size() + 1);
+}
+
+// Smaller datasets are not worth the overhead of parallel calculation of a single projection
+static constexpr size_t MIN_SAMPLE_COUNT_FOR_PARALLEL_ONLINE_CTR = 100000;
+
 void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
                        const TFold& fold,
                        const TProjection& proj,
@@ -344,13 +651,27 @@ void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
                        TOnlineCTR* dst) {
     const TCtrHelper& ctrHelper = ctx->CtrsHelper;
     const auto& ctrInfo = ctrHelper.GetCtrInfo(proj);
+    dst->CompressedFeature.clear();
     dst->Feature.resize(ctrInfo.size());
     size_t learnSampleCount = data.Learn->GetObjectCount();
     const TVector<size_t>& testOffsets = data.CalcTestOffsets();
     size_t totalSampleCount = learnSampleCount + data.GetTestSampleCount();
 
+    NPar::TLocalExecutor* localExecutor = nullptr;
+    if (learnSampleCount >= MIN_SAMPLE_COUNT_FOR_PARALLEL_ONLINE_CTR && ctx->LocalExecutor->GetThreadCount() > 0) {
+        localExecutor = ctx->LocalExecutor;
+    }
+
     const auto& quantizedFeaturesInfo = *data.Learn->ObjectsData->GetQuantizedFeaturesInfo();
 
+    ui64 topSize = ctx->Params.CatFeatureParams->CtrLeafCountLimit;
+    if (proj.IsSingleCatFeature() && ctx->Params.CatFeatureParams->StoreAllSimpleCtrs) {
+        topSize = Max<ui64>();
+    }
+    // Without leaf count limit hash ids are assigned in the order of first occurrence,
+    // so they depend only on the partition of documents and not on the hash values
+    const bool hashIdsDoNotDependOnHashes = topSize > learnSampleCount;
+
     using THashArr = TVector<ui64>;
     using TRehashHash = TDenseHash<ui64, ui32>;
     Y_STATIC_THREAD(THashArr) tlsHashArr;
@@ -361,23 +682,26 @@ void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
         Clear(&hashArr, totalSampleCount);
         TArrayRef<ui64> hashArrView = hashArr;
         if (learnSampleCount > 0) {
-            SubsetWithAlternativeIndexing(
-                data.Learn->ObjectsData->GetCatFeature((ui32)proj.CatFeatures[0]),
-                &fold.LearnPermutationFeaturesSubset
-            ).ForEach(
+            ForEachMaybeParallel(
+                SubsetWithAlternativeIndexing(
+                    data.Learn->ObjectsData->GetCatFeature((ui32)proj.CatFeatures[0]),
+                    &fold.LearnPermutationFeaturesSubset
+                ),
                 [hashArrView] (ui32 i, ui32 featureValue) {
                     hashArrView[i] = (ui64)featureValue + 1;
-                }
+                },
+                localExecutor
             );
         }
         for (size_t docOffset = learnSampleCount, testIdx = 0; docOffset < totalSampleCount && testIdx < data.Test.size(); ++testIdx) {
             const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
-            (*data.Test[testIdx]->ObjectsData->GetCatFeature((ui32)proj.CatFeatures[0]))->GetArrayData()
-                .ForEach(
-                    [hashArrView, docOffset] (ui32 i, ui32 featureValue) {
-                        hashArrView[docOffset + i] = (ui64)featureValue + 1;
-                    }
-                );
+            ForEachMaybeParallel(
+                (*data.Test[testIdx]->ObjectsData->GetCatFeature((ui32)proj.CatFeatures[0]))->GetArrayData(),
+                [hashArrView, docOffset] (ui32 i, ui32 featureValue) {
+                    hashArrView[docOffset + i] = (ui64)featureValue + 1;
+                },
+                localExecutor
+            );
 
             docOffset += testSampleCount;
         }
@@ -385,24 +709,35 @@ void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
             quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(proj.CatFeatures[0])).OnLearnOnly
         );
     } else {
-        Clear(&hashArr, totalSampleCount);
-        CalcHashes(
-            proj,
-            *data.Learn->ObjectsData,
-            fold.LearnPermutationFeaturesSubset,
-            nullptr,
-            hashArr.begin(),
-            hashArr.begin() + learnSampleCount);
-        for (size_t docOffset = learnSampleCount, testIdx = 0; docOffset < totalSampleCount && testIdx < data.Test.size(); ++testIdx) {
-            const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
+        int addedCatFeature = 0;
+        TAtomicSharedPtr<const TVector<ui32>> baseHashIds;
+        if (hashIdsDoNotDependOnHashes) {
+            baseHashIds = GetBaseProjectionHashIds(proj, fold.ProjectionHashCache.Get(), &addedCatFeature);
+        }
+        if (baseHashIds) {
+            CalcHashesForExtendedProjection(data, fold, *baseHashIds, addedCatFeature, localExecutor, &hashArr);
+        } else {
+            Clear(&hashArr, totalSampleCount);
             CalcHashes(
                 proj,
-                *data.Test[testIdx]->ObjectsData,
-                data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
+                *data.Learn->ObjectsData,
+                fold.LearnPermutationFeaturesSubset,
                 nullptr,
-                hashArr.begin() + docOffset,
-                hashArr.begin() + docOffset + testSampleCount);
-            docOffset += testSampleCount;
+                hashArr.begin(),
+                hashArr.begin() + learnSampleCount,
+                localExecutor);
+            for (size_t docOffset = learnSampleCount, testIdx = 0; docOffset < totalSampleCount && testIdx < data.Test.size(); ++testIdx) {
+                const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
+                CalcHashes(
+                    proj,
+                    *data.Test[testIdx]->ObjectsData,
+                    data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
+                    nullptr,
+                    hashArr.begin() + docOffset,
+                    hashArr.begin() + docOffset + testSampleCount,
+                    localExecutor);
+                docOffset += testSampleCount;
+            }
         }
         size_t approxBucketsCount = 1;
         for (auto cf : proj.CatFeatures) {
@@ -413,11 +748,12 @@ void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
         }
         rehashHashTlsVal.Get().MakeEmpty(Min(learnSampleCount, approxBucketsCount));
     }
-    ui64 topSize = ctx->Params.CatFeatureParams->CtrLeafCountLimit;
-    if (proj.IsSingleCatFeature() && ctx->Params.CatFeatureParams->StoreAllSimpleCtrs) {
-        topSize = Max<ui64>();
-    }
-    auto leafCount = ComputeReindexHash(topSize, rehashHashTlsVal.GetPtr(), hashArr.begin(), hashArr.begin() + learnSampleCount);
+    auto leafCount = ComputeReindexHash(
+        topSize,
+        rehashHashTlsVal.GetPtr(),
+        hashArr.begin(),
+        hashArr.begin() + learnSampleCount,
+        localExecutor);
     dst->CounterUniqueValuesCount = dst->UniqueValuesCount = leafCount;
 
     for (size_t docOffset = learnSampleCount, testIdx = 0; docOffset < totalSampleCount && testIdx < data.Test.size(); ++testIdx) {
@@ -426,6 +762,13 @@ void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
         docOffset += testSampleCount;
     }
 
+    if (hashIdsDoNotDependOnHashes) {
+        fold.ProjectionHashCache->Put(
+            proj,
+            TVector<ui32>(hashArr.begin(), hashArr.end()),
+            GetProjectionHashCacheMemoryLimit(*ctx));
+    }
+
     TVector<int> counterCTRTotal;
     int counterCTRDenominator = 0;
     if (AnyOf(ctrInfo.begin(), ctrInfo.begin() + dst->Feature.ysize(), [] (const auto& info) { return info.Type == ECtrType::Counter; })) {
@@ -439,68 +782,145 @@ void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
         counterCTRDenominator = *MaxElement(counterCTRTotal.begin(), counterCTRTotal.end());
     }
 
-    for (int ctrIdx = 0; ctrIdx < dst->Feature.ysize(); ++ctrIdx) {
+    CalcOnlineCTRValues(
+        testOffsets,
+        hashArr,
+        leafCount,
+        ctrInfo,
+        fold.LearnTargetClass,
+        fold.TargetClassesCount,
+        counterCTRTotal,
+        counterCTRDenominator,
+        localExecutor,
+        &dst->Feature);
+}
+
+void CalcOnlineCTRValues(const TVector<size_t>& testOffsets,
+                         const TVector<ui64>& enumeratedCatFeatures,
+                         size_t leafCount,
+                         const TVector<TCtrInfo>& ctrInfo,
+                         const TVector<TVector<int>>& learnTargetClass,
+                         const TVector<int>& targetClassesCounts,
+                         const TVector<int>& counterCTRTotal,
+                         int counterCTRDenominator,
+                         NPar::TLocalExecutor* localExecutor,
+                         TVector<TArray2D<TVector<ui8>>>* feature) {
+    const size_t totalSampleCount = testOffsets.back();
+    TVector<TOnlineCtrShard> shards;
+    if (localExecutor) {
+        shards = SplitOnlineCtrShards(testOffsets, enumeratedCatFeatures, leafCount, localExecutor);
+    }
+
+    for (int ctrIdx = 0; ctrIdx < feature->ysize(); ++ctrIdx) {
         const ECtrType ctrType = ctrInfo[ctrIdx].Type;
         const ui32 classifierId = ctrInfo[ctrIdx].TargetClassifierIdx;
-        int targetClassesCount = fold.TargetClassesCount[classifierId];
+        int targetClassesCount = targetClassesCounts[classifierId];
 
         const ui32 targetBorderCount = GetTargetBorderCount(ctrInfo[ctrIdx], targetClassesCount);
         const ui32 ctrBorderCount = ctrInfo[ctrIdx].BorderCount;
         const auto& priors = ctrInfo[ctrIdx].Priors;
-        dst->Feature[ctrIdx].SetSizes(priors.size(), targetBorderCount);
+        (*feature)[ctrIdx].SetSizes(priors.size(), targetBorderCount);
 
         for (ui32 border = 0; border < targetBorderCount; ++border) {
             for (int prior = 0; prior < priors.ysize(); ++prior) {
-                Clear(&dst->Feature[ctrIdx][border][prior], totalSampleCount);
+                Clear(&(*feature)[ctrIdx][border][prior], totalSampleCount);
             }
         }
 
-        if (ctrType == ECtrType::Borders && targetClassesCount == SIMPLE_CLASSES_COUNT) {
-            CalcOnlineCTRSimple(
-                testOffsets,
-                hashArr,
-                leafCount,
-                fold.LearnTargetClass[classifierId],
-                priors,
-                ctrBorderCount,
-                &dst->Feature[ctrIdx]);
-
-        } else if (ctrType == ECtrType::BinarizedTargetMeanValue) {
-            CalcOnlineCTRMean(
-                testOffsets,
-                hashArr,
-                leafCount,
-                fold.LearnTargetClass[classifierId],
-                targetClassesCount - 1,
-                priors,
-                ctrBorderCount,
-                &dst->Feature[ctrIdx]);
-
-        } else if (ctrType == ECtrType::Buckets ||
-                   (ctrType == ECtrType::Borders && targetClassesCount > SIMPLE_CLASSES_COUNT)) {
-            CalcOnlineCTRClasses(
-                testOffsets,
-                hashArr,
-                leafCount,
-                fold.LearnTargetClass[classifierId],
+        if (localExecutor) {
+            CalcOnlineCTRByShards(
+                shards,
+                learnTargetClass[classifierId],
+                counterCTRTotal,
+                counterCTRDenominator,
+                ctrType,
                 targetClassesCount,
-                GetTargetBorderCount(ctrInfo[ctrIdx], targetClassesCount),
+                targetBorderCount,
                 priors,
                 ctrBorderCount,
-                ctrType,
-                &dst->Feature[ctrIdx]);
+                localExecutor,
+                &(*feature)[ctrIdx]);
         } else {
-            Y_ASSERT(ctrType == ECtrType::Counter);
-            CalcOnlineCTRCounter(
+            CalcOnlineCTR(
                 testOffsets,
+                enumeratedCatFeatures,
+                leafCount,
+                learnTargetClass[classifierId],
                 counterCTRTotal,
-                hashArr,
                 counterCTRDenominator,
+                ctrType,
+                targetClassesCount,
+                targetBorderCount,
                 priors,
                 ctrBorderCount,
-                &dst->Feature[ctrIdx]);
+                &(*feature)[ctrIdx]);
+        }
+    }
+}
+
+size_t TOnlineCTR::GetCompressedSize() const {
+    size_t size = 0;
+    for (const auto& compressedFeature : CompressedFeature) {
+        for (size_t classIdx = 0; classIdx < compressedFeature.GetYSize(); ++classIdx) {
+            for (size_t priorIdx = 0; priorIdx < compressedFeature.GetXSize(); ++priorIdx) {
+                size += compressedFeature[classIdx][priorIdx].size();
+            }
+        }
+    }
+    return size;
+}
+
+// Compressed values larger than this part of raw values are not worth keeping
+static constexpr double ONLINE_CTR_MAX_COMPRESSION_RATIO = 0.5;
+
+static const NBlockCodecs::ICodec* GetOnlineCtrCodec() {
+    static const NBlockCodecs::ICodec* codec = NBlockCodecs::Codec("lz4");
+    return codec;
+}
+
+void CompressOnlineCTR(TOnlineCTR* ctr) {
+    Y_ASSERT(!ctr->IsCompressed());
+    const auto* codec = GetOnlineCtrCodec();
+    ctr->CompressedFeature.resize(ctr->Feature.size());
+    size_t size = 0;
+    for (int ctrIdx = 0; ctrIdx < ctr->Feature.ysize(); ++ctrIdx) {
+        const auto& feature = ctr->Feature[ctrIdx];
+        auto& compressedFeature = ctr->CompressedFeature[ctrIdx];
+        compressedFeature.SetSizes(feature.GetXSize(), feature.GetYSize());
+        for (size_t classIdx = 0; classIdx < feature.GetYSize(); ++classIdx) {
+            for (size_t priorIdx = 0; priorIdx < feature.GetXSize(); ++priorIdx) {
+                const auto& values = feature[classIdx][priorIdx];
+                compressedFeature[classIdx][priorIdx] = codec->Encode(
+                    TStringBuf(reinterpret_cast<const char*>(values.data()), values.size()));
+                size += values.size();
+            }
+        }
+    }
+    if (ctr->GetCompressedSize() > ONLINE_CTR_MAX_COMPRESSION_RATIO * size) {
+        ctr->CompressedFeature.clear();
+    }
+    ctr->Feature.clear();
+    ctr->Feature.shrink_to_fit();
+}
+
+void DecompressOnlineCTR(TOnlineCTR* ctr) {
+    Y_ASSERT(ctr->IsCompressed());
+    const auto* codec = GetOnlineCtrCodec();
+    ctr->Feature.resize(ctr->CompressedFeature.size());
+    for (int ctrIdx = 0; ctrIdx < ctr->CompressedFeature.ysize(); ++ctrIdx) {
+        const auto& compressedFeature = ctr->CompressedFeature[ctrIdx];
+        auto& feature = ctr->Feature[ctrIdx];
+        feature.SetSizes(compressedFeature.GetXSize(), compressedFeature.GetYSize());
+        for (size_t classIdx = 0; classIdx < compressedFeature.GetYSize(); ++classIdx) {
+            for (size_t priorIdx = 0; priorIdx < compressedFeature.GetXSize(); ++priorIdx) {
+                const TString& compressedValues = compressedFeature[classIdx][priorIdx];
+                auto& values = feature[classIdx][priorIdx];
+                values.yresize(codec->DecompressedLength(compressedValues));
+                codec->Decompress(compressedValues, values.data());
+            }
         }
     }
+    ctr->CompressedFeature.clear();
 }
 
 void CalcFinalCtrsImpl(
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ctr_helper.h"
 #include "index_hash_calcer.h"
 #include "projection.h"
 #include "target_classifier.h"
@@ -12,7 +13,10 @@
 
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/hash.h>
 #include <util/generic/maybe.h>
+#include <util/generic/ptr.h>
+#include <util/system/spinlock.h>
 #include <util/system/types.h>
 
 #include <functional>
@@ -27,6 +31,7 @@ bool HasFeaturesForCtrs(const NCB::TQuantizedFeaturesInfo& quantizedFeaturesInfo
 
 struct TOnlineCTR {
     TVector<TArray2D<TVector<ui8>>> Feature; // Feature[ctrIdx][classIdx][priorIdx][docIdx]
+    TVector<TArray2D<TString>> CompressedFeature; // Feature blocks packed by CompressOnlineCTR, empty if not compressed
     size_t UniqueValuesCount = 0;
     size_t CounterUniqueValuesCount = 0; // Counter ctrs could have more values than other types when  counter_calc_method == Full
 
@@ -40,10 +45,41 @@ struct TOnlineCTR {
             return UniqueValuesCount;
         }
     }
+    bool IsCompressed() const {
+        return !CompressedFeature.empty();
+    }
+    size_t GetCompressedSize() const;
 };
 
 using TOnlineCTRHash = THashMap<TProjection, TOnlineCTR>;
 
+/// Reindexed hashes of learn and test documents for projections with computed online ctrs.
+/// Hashes of a projection extended by one more cat feature are calculated from them in a single pass.
+/// Total size is bounded by memory limit, least recently used projections are evicted first.
+class TProjectionHashCache {
+public:
+    TAtomicSharedPtr<const TVector<ui32>> Get(const TProjection& proj);
+    void Put(const TProjection& proj, TVector<ui32>&& hashIds, size_t memoryLimit);
+    // Drops least recently used entries until memorySize bytes are freed, returns freed size
+    size_t Evict(size_t memorySize);
+    size_t GetUsedMemory() const;
+
+private:
+    size_t EvictUnlocked(size_t memorySize);
+
+private:
+    struct TEntry {
+        TAtomicSharedPtr<const TVector<ui32>> HashIds;
+        ui64 LastUseTime = 0;
+    };
+
+private:
+    mutable TAdaptiveLock Lock;
+    THashMap<TProjection, TEntry> Entries;
+    size_t UsedMemory = 0;
+    ui64 Time = 0;
+};
+
 inline ui8 CalcCTR(float countInClass, int totalCount, float prior, float shift, float norm, int borderCount) {
     float ctr = (countInClass + prior) / (totalCount + 1);
     return (ctr + shift) / norm * borderCount;
@@ -59,6 +95,27 @@ void ComputeOnlineCTRs(const NCB::TTrainingForCPUDataProviders& data,
                        const TLearnContext* ctx,
                        TOnlineCTR* dst);
 
+/// Values of ctrs described by ctrInfo for documents enumerated by ctr leaf ids
+/// (learn documents in the fold's permutation order, then test ones, testOffsets[0] is learn size).
+/// With localExecutor documents are split into shards by leaf ids and shards are processed in parallel,
+/// the result is exactly the same as without it.
+void CalcOnlineCTRValues(const TVector<size_t>& testOffsets,
+                         const TVector<ui64>& enumeratedCatFeatures,
+                         size_t leafCount,
+                         const TVector<TCtrInfo>& ctrInfo,
+                         const TVector<TVector<int>>& learnTargetClass, // [targetBorderClassifierIdx][objectIdx]
+                         const TVector<int>& targetClassesCounts, // [targetBorderClassifierIdx]
+                         const TVector<int>& counterCTRTotal,
+                         int counterCTRDenominator,
+                         NPar::TLocalExecutor* localExecutor, // can be nullptr
+                         TVector<TArray2D<TVector<ui8>>>* feature); // [ctrIdx][classIdx][priorIdx][docIdx], sized by ctrIdx
+
+/// Keeps ctr values of a projection that is not used right now in a compressed form
+/// so that they can be restored later much faster than computed again.
+/// Values that compress poorly are just dropped, they will be computed again if needed.
+void CompressOnlineCTR(TOnlineCTR* ctr);
+void DecompressOnlineCTR(TOnlineCTR* ctr);
+
 class TCtrValueTable;
 
 
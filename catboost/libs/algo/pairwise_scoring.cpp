@@ -6,10 +6,22 @@
 
 #include <emmintrin.h>
 
+void TPairwiseStats::Init(int leafCount, int bucketCount) {
+    DerSums.assign(leafCount, TVector<double>(bucketCount, 0.0));
+    PairWeightStatistics.SetSizes(leafCount, leafCount);
+    PairWeightStatistics.FillEvery(TVector<TBucketPairWeightStatistics>(bucketCount));
+}
+
 void TPairwiseStats::Add(const TPairwiseStats& rhs) {
     Y_ASSERT(DerSums.size() == rhs.DerSums.size());
 
     for (auto leafIdx : xrange(DerSums.size())) {
+        AddLeaf(rhs, leafIdx);
+    }
+}
+
+void TPairwiseStats::AddLeaf(const TPairwiseStats& rhs, int leafIdx) {
+    {
         auto& dst = DerSums[leafIdx];
         const auto& add = rhs.DerSums[leafIdx];
 
@@ -23,19 +35,17 @@ void TPairwiseStats::Add(const TPairwiseStats& rhs) {
     Y_ASSERT(PairWeightStatistics.GetXSize() == rhs.PairWeightStatistics.GetXSize());
     Y_ASSERT(PairWeightStatistics.GetYSize() == rhs.PairWeightStatistics.GetYSize());
 
-    for (auto leafIdx1 : xrange(PairWeightStatistics.GetYSize())) {
-        auto dst1 = PairWeightStatistics[leafIdx1];
-        const auto add1 = rhs.PairWeightStatistics[leafIdx1];
+    auto dst1 = PairWeightStatistics[leafIdx];
+    const auto add1 = rhs.PairWeightStatistics[leafIdx];
 
-        for (auto leafIdx2 : xrange(PairWeightStatistics.GetXSize())) {
-            auto& dst2 = dst1[leafIdx2];
-            const auto& add2 = add1[leafIdx2];
+    for (auto leafIdx2 : xrange(PairWeightStatistics.GetXSize())) {
+        auto& dst2 = dst1[leafIdx2];
+        const auto& add2 = add1[leafIdx2];
 
-            Y_ASSERT(dst2.size() == add2.size());
+        Y_ASSERT(dst2.size() == add2.size());
 
-            for (auto bucketIdx : xrange(dst2.size())) {
-                dst2[bucketIdx].Add(add2[bucketIdx]);
-            }
+        for (auto bucketIdx : xrange(dst2.size())) {
+            dst2[bucketIdx].Add(add2[bucketIdx]);
         }
     }
 }
@@ -25,11 +25,34 @@ struct TPairwiseStats {
     TVector<TVector<double>> DerSums; // [leafCount][bucketCount]
     TArray2D<TVector<TBucketPairWeightStatistics>> PairWeightStatistics; // [leafCount][leafCount][bucketCount]
 
+    // sets sizes and fills with zeros
+    void Init(int leafCount, int bucketCount);
+
     void Add(const TPairwiseStats& rhs);
+
+    // adds only statistics for leafIdx: DerSums[leafIdx] and PairWeightStatistics[leafIdx][*]
+    void AddLeaf(const TPairwiseStats& rhs, int leafIdx);
+
     SAVELOAD(DerSums, PairWeightStatistics);
 };
 
 
+// TGetBucketFunc is of type ui32(ui32 docId)
+template <class TGetBucketFunc>
+inline void AddDerSums(
+    TConstArrayRef<double> weightedDerivativesData,
+    const TVector<TIndexType>& leafIndices,
+    TGetBucketFunc getBucketFunc,
+    NCB::TIndexRange<int> docIndexRange,
+    TVector<TVector<double>>* derSums // [leafCount][bucketCount]
+) {
+    for (int docId : docIndexRange.Iter()) {
+        const ui32 leafIndex = leafIndices[docId];
+        const ui32 bucketIndex = getBucketFunc((ui32)docId);
+        (*derSums)[leafIndex][bucketIndex] += weightedDerivativesData[docId];
+    }
+}
+
 // TGetBucketFunc is of type ui32(ui32 docId)
 template <class TGetBucketFunc>
 inline TVector<TVector<double>> ComputeDerSums(
@@ -41,27 +64,19 @@ inline TVector<TVector<double>> ComputeDerSums(
     NCB::TIndexRange<int> docIndexRange
 ) {
     TVector<TVector<double>> derSums(leafCount, TVector<double>(bucketCount));
-
-    for (int docId : docIndexRange.Iter()) {
-        const ui32 leafIndex = leafIndices[docId];
-        const ui32 bucketIndex = getBucketFunc((ui32)docId);
-        derSums[leafIndex][bucketIndex] += weightedDerivativesData[docId];
-    }
+    AddDerSums(weightedDerivativesData, leafIndices, getBucketFunc, docIndexRange, &derSums);
     return derSums;
 }
 
 // TGetBucketFunc is of type ui32(ui32 docId)
 template <class TGetBucketFunc>
-inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistics(
+inline void AddPairWeightStatistics(
     const TFlatPairsInfo& pairs,
-    int leafCount,
-    int bucketCount,
     const TVector<TIndexType>& leafIndices,
     TGetBucketFunc getBucketFunc,
-    NCB::TIndexRange<int> pairIndexRange
+    NCB::TIndexRange<int> pairIndexRange,
+    TArray2D<TVector<TBucketPairWeightStatistics>>* weightSums // [leafCount][leafCount][bucketCount]
 ) {
-    TArray2D<TVector<TBucketPairWeightStatistics>> weightSums(leafCount, leafCount);
-    weightSums.FillEvery(TVector<TBucketPairWeightStatistics>(bucketCount));
     for (size_t pairIdx : pairIndexRange.Iter()) {
         const auto winnerIdx = pairs[pairIdx].WinnerId;
         const auto loserIdx = pairs[pairIdx].LoserId;
@@ -74,14 +89,30 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
         const auto loserLeafId = leafIndices[loserIdx];
         const float weight = pairs[pairIdx].Weight;
         if (winnerBucketId > loserBucketId) {
-            weightSums[loserLeafId][winnerLeafId][loserBucketId].SmallerBorderWeightSum -= weight;
-            weightSums[loserLeafId][winnerLeafId][winnerBucketId].GreaterBorderRightWeightSum -= weight;
+            TBucketPairWeightStatistics* leafPairStats = (*weightSums)[loserLeafId][winnerLeafId].data();
+            leafPairStats[loserBucketId].SmallerBorderWeightSum -= weight;
+            leafPairStats[winnerBucketId].GreaterBorderRightWeightSum -= weight;
         } else {
-            weightSums[winnerLeafId][loserLeafId][winnerBucketId].SmallerBorderWeightSum -= weight;
-            weightSums[winnerLeafId][loserLeafId][loserBucketId].GreaterBorderRightWeightSum -= weight;
+            TBucketPairWeightStatistics* leafPairStats = (*weightSums)[winnerLeafId][loserLeafId].data();
+            leafPairStats[winnerBucketId].SmallerBorderWeightSum -= weight;
+            leafPairStats[loserBucketId].GreaterBorderRightWeightSum -= weight;
         }
     }
+}
 
+// TGetBucketFunc is of type ui32(ui32 docId)
+template <class TGetBucketFunc>
+inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistics(
+    const TFlatPairsInfo& pairs,
+    int leafCount,
+    int bucketCount,
+    const TVector<TIndexType>& leafIndices,
+    TGetBucketFunc getBucketFunc,
+    NCB::TIndexRange<int> pairIndexRange
+) {
+    TArray2D<TVector<TBucketPairWeightStatistics>> weightSums(leafCount, leafCount);
+    weightSums.FillEvery(TVector<TBucketPairWeightStatistics>(bucketCount));
+    AddPairWeightStatistics(pairs, leafIndices, getBucketFunc, pairIndexRange, &weightSums);
     return weightSums;
 }
 
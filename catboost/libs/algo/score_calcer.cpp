@@ -8,6 +8,8 @@
 #include <catboost/libs/helpers/map_merge.h>
 #include <catboost/libs/options/defaults_helper.h>
 
+#include <util/generic/xrange.h>
+
 #include <type_traits>
 
 using namespace NCB;
@@ -324,6 +326,9 @@ inline static void FixUpStats(
 }
 
 
+// Limits the memory used by pairwise statistics buffers, must not depend on the thread count
+static constexpr int PAIRWISE_STATS_MAX_PART_COUNT = 16;
+
 template <typename TFullIndexType, typename TIsCaching>
 static void CalcStatsImpl(
     const TCalcScoreFold& fold,
@@ -349,83 +354,127 @@ static void CalcStatsImpl(
         fold.BodyTailArr[0].WeightedDerivatives[0].data(),
         docCount
     );
-    const auto blockCount = fold.GetCalcStatsIndexRanges().RangesCount();
-    const auto docPart = CeilDiv(docCount, blockCount);
-
     const auto pairCount = pairs.ysize();
-    const auto pairPart = CeilDiv(pairCount, blockCount);
 
-    NCB::MapMerge(
-        localExecutor,
-        fold.GetCalcStatsIndexRanges(),
-        /*mapFunc*/[&](NCB::TIndexRange<int> partIndexRange, TPairwiseStats* output) {
-            Y_ASSERT(!partIndexRange.Empty());
+    /* statistics size is leafCount^2 * bucketCount and does not depend on the block size, so consecutive
+     * calc stats blocks are grouped into a fixed number of parts with one statistics buffer per part.
+     * Parts do not depend on the thread count and are merged in a fixed order, so the result does not
+     * depend on it either.
+     */
+    const auto& blocks = fold.GetCalcStatsIndexRanges();
+    const int blockCount = blocks.RangesCount();
+    const int partCount = Max(1, Min(blockCount, PAIRWISE_STATS_MAX_PART_COUNT));
+
+    // calc stats blocks' ranges for pairwise scoring are in units of docPart docs and pairPart pairs
+    const int docPart = blockCount ? CeilDiv(docCount, blockCount) : docCount;
+    const int pairPart = blockCount ? CeilDiv(pairCount, blockCount) : pairCount;
+    auto getPartRange = [&] (int partIdx) {
+        if (!blockCount) {
+            return NCB::TIndexRange<int>(0, 1);
+        }
+        return NCB::TIndexRange<int>(
+            blocks.GetRange(blockCount * partIdx / partCount).Begin,
+            blocks.GetRange(blockCount * (partIdx + 1) / partCount - 1).End
+        );
+    };
 
-            auto docIndexRange = NCB::TIndexRange<int>(
-                Min(docCount, docPart * partIndexRange.Begin),
-                Min(docCount, docPart * partIndexRange.End)
-            );
+    TVector<TPairwiseStats> partStats(partCount - 1); // w/o first, first is 'stats' param
+    auto getPartStats = [&] (int partIdx) {
+        return (partIdx == 0) ? stats : &partStats[partIdx - 1];
+    };
 
-            auto pairIndexRange = NCB::TIndexRange<int>(
-                Min(pairCount, pairPart * partIndexRange.Begin),
-                Min(pairCount, pairPart * partIndexRange.End)
-            );
+    auto calcStats = [&] (auto&& getBucketFunc) {
+        localExecutor->ExecRangeWithThrow(
+            [&] (int partIdx) {
+                TPairwiseStats* output = getPartStats(partIdx);
+                output->Init(leafCount, indexer.BucketCount);
+
+                const auto partRange = getPartRange(partIdx);
 
-            auto setOutput = [&] (auto&& getBucketFunc) {
-                output->DerSums = ComputeDerSums(
+                const NCB::TIndexRange<int> docIndexRange(
+                    Min(docCount, docPart * partRange.Begin),
+                    Min(docCount, docPart * partRange.End)
+                );
+                AddDerSums(
                     weightedDerivativesData,
-                    leafCount,
-                    indexer.BucketCount,
                     fold.Indices,
                     getBucketFunc,
-                    docIndexRange
+                    docIndexRange,
+                    &output->DerSums
+                );
+
+                const NCB::TIndexRange<int> pairIndexRange(
+                    Min(pairCount, pairPart * partRange.Begin),
+                    Min(pairCount, pairPart * partRange.End)
                 );
-                auto pairWeightStatistics = ComputePairWeightStatistics(
+                AddPairWeightStatistics(
                     pairs,
-                    leafCount,
-                    indexer.BucketCount,
                     fold.Indices,
                     getBucketFunc,
-                    pairIndexRange
-                );
-                output->PairWeightStatistics.Swap(pairWeightStatistics);
-            };
-
-            if (split.Type == ESplitType::OnlineCtr) {
-                const TCtr& ctr = split.Ctr;
-                TConstArrayRef<ui8> buckets =
-                    GetCtr(allCtrs, ctr.Projection).Feature[ctr.CtrIdx][ctr.TargetBorderIdx][ctr.PriorIdx];
-                setOutput([buckets](ui32 docIdx) { return buckets[docIdx]; });
-            } else if (split.Type == ESplitType::FloatFeature) {
-                const ui8* bucketSrcData =
-                    *((*objectsDataProvider.GetFloatFeature((ui32)split.FeatureIdx))->GetArrayData().GetSrc());
-                const ui32* bucketIndexing
-                    = fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data();
-                setOutput(
-                    [bucketSrcData, bucketIndexing](ui32 docIdx) {
-                        return bucketSrcData[bucketIndexing[docIdx]];
-                    }
+                    pairIndexRange,
+                    &output->PairWeightStatistics
                 );
-            } else {
-                Y_ASSERT(split.Type == ESplitType::OneHotFeature);
-                const ui32* bucketSrcData =
-                    *((*objectsDataProvider.GetCatFeature((ui32)split.FeatureIdx))->GetArrayData().GetSrc());
-                const ui32* bucketIndexing
-                    = fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data();
-                setOutput(
-                    [bucketSrcData, bucketIndexing](ui32 docIdx) {
-                        return bucketSrcData[bucketIndexing[docIdx]];
-                    }
-                );
-            }
-        },
-        /*mergeFunc*/[&](TPairwiseStats* output, TVector<TPairwiseStats>&& addVector) {
-            for (const auto& addItem : addVector) {
-                output->Add(addItem);
-            }
-        },
-        stats
-    );
+            },
+            0,
+            partCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+    };
+
+    if (split.Type == ESplitType::OnlineCtr) {
+        const TCtr& ctr = split.Ctr;
+        TConstArrayRef<ui8> buckets =
+            GetCtr(allCtrs, ctr.Projection).Feature[ctr.CtrIdx][ctr.TargetBorderIdx][ctr.PriorIdx];
+        calcStats([buckets](ui32 docIdx) { return buckets[docIdx]; });
+    } else {
+        const ui32* bucketIndexing = fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data();
+
+        // every document is looked up once per its pair, so gather buckets in fold order only once
+        auto calcStatsForGatheredBuckets = [&] (const auto* bucketSrcData) {
+            using TBucket = std::remove_const_t<std::remove_pointer_t<decltype(bucketSrcData)>>;
+
+            TVector<TBucket> buckets;
+            buckets.yresize(docCount);
+            NPar::TLocalExecutor::TExecRangeParams blockParams(0, docCount);
+            blockParams.SetBlockSize(Max(1, CeilDiv(docCount, partCount)));
+            localExecutor->ExecRange(
+                NPar::TLocalExecutor::BlockedLoopBody(
+                    blockParams,
+                    [&] (int docIdx) { buckets[docIdx] = bucketSrcData[bucketIndexing[docIdx]]; }
+                ),
+                0,
+                blockParams.GetBlockCount(),
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+
+            const TBucket* bucketsData = buckets.data();
+            calcStats([bucketsData](ui32 docIdx) { return bucketsData[docIdx]; });
+        };
+
+        if (split.Type == ESplitType::FloatFeature) {
+            calcStatsForGatheredBuckets(
+                *((*objectsDataProvider.GetFloatFeature((ui32)split.FeatureIdx))->GetArrayData().GetSrc())
+            );
+        } else {
+            Y_ASSERT(split.Type == ESplitType::OneHotFeature);
+            calcStatsForGatheredBuckets(
+                *((*objectsDataProvider.GetCatFeature((ui32)split.FeatureIdx))->GetArrayData().GetSrc())
+            );
+        }
+    }
+
+    if (partCount > 1) {
+        localExecutor->ExecRange(
+            [&] (int leafIdx) {
+                for (auto partIdx : xrange(1, partCount)) {
+                    stats->AddLeaf(partStats[partIdx - 1], leafIdx);
+                }
+            },
+            0,
+            leafCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+    }
 }
 
 
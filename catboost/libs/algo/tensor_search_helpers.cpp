@@ -1,5 +1,6 @@
 #include "tensor_search_helpers.h"
 
+#include <catboost/libs/helpers/counter_rng.h>
 #include <catboost/libs/helpers/restorable_rng.h>
 
 THolder<IDerCalcer> BuildError(
@@ -86,20 +87,34 @@ static void GenerateRandomWeights(
         return;
     }
 
+    // counter-based, so weights depend only on the seed and the document
     const ui64 randSeed = rand->GenRand();
     NPar::TLocalExecutor::TExecRangeParams blockParams(0, learnSampleCount);
     blockParams.SetBlockSize(1000);
     localExecutor->ExecRange([&](int blockIdx) {
-        TRestorableFastRng64 rand(randSeed + blockIdx);
-        rand.Advance(10); // reduce correlation between RNGs in different threads
-        float* sampleWeightsData = fold->SampleWeights.data();
-        NPar::TLocalExecutor::BlockedLoopBody(blockParams, [=,&rand](int i) {
-            const float w = -FastLogf(rand.GenRandReal1() + 1e-100);
-            sampleWeightsData[i] = powf(w, baggingTemperature);
-        })(blockIdx);
+        const int blockStart = blockIdx * blockParams.GetBlockSize();
+        const int blockSize = Min(blockParams.GetBlockSize(), learnSampleCount - blockStart);
+        GenerateBayesianWeights(
+            randSeed,
+            blockStart,
+            baggingTemperature,
+            MakeArrayRef(fold->SampleWeights.data() + blockStart, blockSize));
     }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
+// competitors are numbered by their position in the concatenation of all queries
+static TVector<ui64> CalcCompetitorOffsets(const TVector<TQueryInfo>& queriesInfo) {
+    TVector<ui64> offsets(queriesInfo.size() + 1, 0);
+    for (size_t queryIdx = 0; queryIdx < queriesInfo.size(); ++queryIdx) {
+        ui64 competitorCount = 0;
+        for (const auto& competitors : queriesInfo[queryIdx].Competitors) {
+            competitorCount += competitors.size();
+        }
+        offsets[queryIdx + 1] = offsets[queryIdx] + competitorCount;
+    }
+    return offsets;
+}
+
 static void GenerateBayesianWeightsForPairs(
     float baggingTemperature,
     NPar::TLocalExecutor* localExecutor,
@@ -110,16 +125,18 @@ static void GenerateBayesianWeightsForPairs(
         return;
     }
     const ui64 randSeed = rand->GenRand();
+    const TVector<ui64> competitorOffsets = CalcCompetitorOffsets(fold->LearnQueriesInfo);
     NPar::TLocalExecutor::TExecRangeParams blockParams(0, fold->LearnQueriesInfo.ysize());
     blockParams.SetBlockSize(1000);
     localExecutor->ExecRange([&](int blockIdx) {
-        TRestorableFastRng64 rand(randSeed + blockIdx);
-        rand.Advance(10); // reduce correlation between RNGs in different threads
+        TVector<float> weights;
         NPar::TLocalExecutor::BlockedLoopBody(blockParams, [&](int i) {
+            weights.yresize(competitorOffsets[i + 1] - competitorOffsets[i]);
+            GenerateBayesianWeights(randSeed, competitorOffsets[i], baggingTemperature, weights);
+            size_t competitorIdx = 0;
             for (auto& competitors : fold->LearnQueriesInfo[i].Competitors) {
                 for (auto& competitor : competitors) {
-                    const float w = -FastLogf(rand.GenRandReal1() + 1e-100);
-                    competitor.SampleWeight = competitor.Weight * powf(w, baggingTemperature);
+                    competitor.SampleWeight = competitor.Weight * weights[competitorIdx++];
                 }
             }
         })(blockIdx);
@@ -136,15 +153,15 @@ static void GenerateBernoulliWeightsForPairs(
         return;
     }
     const ui64 randSeed = rand->GenRand();
+    const TVector<ui64> competitorOffsets = CalcCompetitorOffsets(fold->LearnQueriesInfo);
     NPar::TLocalExecutor::TExecRangeParams blockParams(0, fold->LearnQueriesInfo.ysize());
     blockParams.SetBlockSize(1000);
     localExecutor->ExecRange([&](int blockIdx) {
-        TRestorableFastRng64 rand(randSeed + blockIdx);
-        rand.Advance(10); // reduce correlation between RNGs in different threads
         NPar::TLocalExecutor::BlockedLoopBody(blockParams, [&](int i) {
+            ui64 competitorIdx = competitorOffsets[i];
             for (auto& competitors : fold->LearnQueriesInfo[i].Competitors) {
                 for (auto& competitor : competitors) {
-                    if (rand.GenRandReal1() < takenFraction) {
+                    if (TCounterRng64::GenerateRealPositive(randSeed, competitorIdx++) <= takenFraction) {
                         competitor.SampleWeight = competitor.Weight;
                     } else {
                         competitor.SampleWeight = 0.0f;
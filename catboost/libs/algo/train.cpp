@@ -4,6 +4,7 @@
 #include "error_functions.h"
 #include "fold.h"
 #include "greedy_tensor_search.h"
+#include "helpers.h"
 #include "online_ctr.h"
 #include "tensor_search_helpers.h"
 
@@ -24,9 +25,16 @@ static void UpdateLearningFold(
     const IDerCalcer& error,
     const TSplitTree& bestSplitTree,
     ui64 randomSeed,
+    bool isOnlyLearningFold,
     TFold* fold,
     TLearnContext* ctx
 ) {
+    if (CanUpdateFoldApproxFused(*fold, error, *ctx)) {
+        // derivatives are needed only for the fold taken for the next tree
+        CalcApproxAndUpdateFoldFused(data, error, bestSplitTree, randomSeed, /*calcDerivatives*/ isOnlyLearningFold, ctx, fold);
+        return;
+    }
+
     TVector<TVector<TVector<double>>> approxDelta;
 
     CalcApproxForLeafStruct(
@@ -44,9 +52,16 @@ static void UpdateLearningFold(
     } else {
         UpdateBodyTailApprox</*StoreExpApprox*/ false>(approxDelta, ctx->Params.BoostingOptions->LearningRate, ctx->LocalExecutor, fold);
     }
+    for (auto& bodyTail : fold->BodyTailArr) {
+        bodyTail.AreWeightedDerivativesUpToDate = false;
+    }
 }
 
-void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnContext* ctx) {
+void TrainOneIteration(
+    const NCB::TTrainingForCPUDataProviders& data,
+    TLearnContext* ctx,
+    TBackgroundErrorsCalcer* backgroundErrorsCalcer
+) {
     const auto error = BuildError(ctx->Params, ctx->ObjectiveDescriptor);
     ctx->LearnProgress.HessianType = error->GetHessianType();
     CheckDerivativeOrderForTrain(
@@ -69,7 +84,9 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
         const TVector<ui64> randomSeeds = GenRandUI64Vector(takenFold->BodyTailArr.ysize(), ctx->Rand.GenRand());
         if (ctx->Params.SystemOptions->IsSingleHost()) {
             ctx->LocalExecutor->ExecRange([&](int bodyTailId) {
-                CalcWeightedDerivatives(*error, bodyTailId, ctx->Params, randomSeeds[bodyTailId], takenFold, ctx->LocalExecutor);
+                if (!takenFold->BodyTailArr[bodyTailId].AreWeightedDerivativesUpToDate) {
+                    CalcWeightedDerivatives(*error, bodyTailId, ctx->Params, randomSeeds[bodyTailId], takenFold, ctx->LocalExecutor);
+                }
             }, 0, takenFold->BodyTailArr.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
         } else {
             Y_ASSERT(takenFold->BodyTailArr.ysize() == 1);
@@ -106,7 +123,11 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
                 TFold* Fold;
                 TOnlineCTR* Ctr;
                 void DoTask(TLearnContext* ctx) {
-                    ComputeOnlineCTRs(*data, *Fold, Projection, ctx, Ctr);
+                    if (Ctr->IsCompressed()) {
+                        DecompressOnlineCTR(Ctr);
+                    } else {
+                        ComputeOnlineCTRs(*data, *Fold, Projection, ctx, Ctr);
+                    }
                 }
             };
 
@@ -143,18 +164,21 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
         if (ctx->Params.SystemOptions->IsSingleHost()) {
             const TVector<ui64> randomSeeds = GenRandUI64Vector(foldCount, ctx->Rand.GenRand());
             ctx->LocalExecutor->ExecRange([&](int foldId) {
-                UpdateLearningFold(data, *error, bestSplitTree, randomSeeds[foldId], trainFolds[foldId], ctx);
+                UpdateLearningFold(data, *error, bestSplitTree, randomSeeds[foldId], /*isOnlyLearningFold*/ foldCount == 1, trainFolds[foldId], ctx);
             }, 0, foldCount, NPar::TLocalExecutor::WAIT_COMPLETE);
 
             profile.AddOperation("CalcApprox tree struct and update tree structure approx");
             CheckInterrupted(); // check after long-lasting operation
 
+            // test approxes are updated lazily, test indices are needed now only if the tree depends on online ctrs
+            const bool calcTestIndices = TLazyTestApproxUpdater::NeedsStoredIndices(bestSplitTree);
             TVector<TIndexType> indices;
             CalcLeafValues(
                 data,
                 *error,
                 ctx->LearnProgress.AveragingFold,
                 bestSplitTree,
+                calcTestIndices,
                 ctx,
                 &treeValues,
                 &indices
@@ -174,7 +198,22 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
                 &treeValues
             );
 
-            UpdateAvrgApprox(error->GetIsExpApprox(), data.Learn->GetObjectCount(), indices, treeValues, data.Test, &ctx->LearnProgress, ctx->LocalExecutor);
+            // errors of the previous iteration are calculated from the approxes updated below
+            if (backgroundErrorsCalcer) {
+                backgroundErrorsCalcer->Wait();
+            }
+
+            const ui32 learnSampleCount = data.Learn->GetObjectCount();
+            UpdateAvrgApprox(error->GetIsExpApprox(), learnSampleCount, indices, treeValues, /*testData*/ {}, &ctx->LearnProgress, ctx->LocalExecutor);
+
+            TConstArrayRef<TIndexType> testIndices;
+            if (calcTestIndices) {
+                testIndices = TConstArrayRef<TIndexType>(indices.data() + learnSampleCount, indices.size() - learnSampleCount);
+            }
+            ctx->TestApproxUpdater.AddTree(bestSplitTree, treeValues, testIndices, data.Test);
+            if (ctx->TestApproxUpdater.HasTooManyStoredIndices()) {
+                ctx->TestApproxUpdater.UpdateAll(data.Test, ctx->LocalExecutor, &ctx->LearnProgress.TestApprox);
+            }
         } else {
             if (ctx->LearnProgress.ApproxDimension == 1) {
                 MapSetApproxesSimple(*error, bestSplitTree, data.Test, &treeValues, &sumLeafWeights, ctx);
@@ -5,6 +5,13 @@
 #include <catboost/libs/data_new/data_provider.h>
 #include <catboost/libs/overfitting_detector/error_tracker.h>
 
-void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnContext* ctx);
+class TBackgroundErrorsCalcer;
+
+// backgroundErrorsCalcer can be nullptr, otherwise its errors are waited for before approxes are updated
+void TrainOneIteration(
+    const NCB::TTrainingForCPUDataProviders& data,
+    TLearnContext* ctx,
+    TBackgroundErrorsCalcer* backgroundErrorsCalcer
+);
 
 TErrorTracker BuildErrorTracker(EMetricBestValue bestValueType, double bestPossibleValue, bool hasTest, TLearnContext* ctx);
@@ -0,0 +1,67 @@
+#include <catboost/libs/algo/error_functions.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/generic/vector.h>
+
+
+static void CheckDersRange(
+    const IDerCalcer& error,
+    const TVector<double>& approxes,
+    const TVector<double>& approxDeltas,
+    const TVector<float>& targets,
+    const TVector<float>& weights,
+    const TVector<TDers>& expectedDers
+) {
+    const int start = 1;
+    const int count = approxes.ysize() - start;
+    const double* approxDeltasData = approxDeltas.empty() ? nullptr : approxDeltas.data();
+    const float* weightsData = weights.empty() ? nullptr : weights.data();
+
+    TVector<TDers> ders(approxes.size(), TDers{0.0, 0.0, 0.0});
+    error.CalcDersRange(start, count, /*calcThirdDer*/ true, approxes.data(), approxDeltasData, targets.data(), weightsData, ders.data());
+    TVector<double> firstDers(approxes.size(), 0.0);
+    error.CalcFirstDerRange(start, count, approxes.data(), approxDeltasData, targets.data(), weightsData, firstDers.data());
+
+    UNIT_ASSERT_VALUES_EQUAL(ders[0].Der1, 0.0);
+    UNIT_ASSERT_VALUES_EQUAL(firstDers[0], 0.0);
+    for (int i = start; i < start + count; ++i) {
+        UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der1, expectedDers[i].Der1, 1e-12);
+        UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der2, expectedDers[i].Der2, 1e-12);
+        UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der3, expectedDers[i].Der3, 1e-12);
+        UNIT_ASSERT_DOUBLES_EQUAL(firstDers[i], expectedDers[i].Der1, 1e-12);
+    }
+}
+
+Y_UNIT_TEST_SUITE(TErrorFunctionsTest) {
+    Y_UNIT_TEST(TestRMSEDersRange) {
+        const TVector<double> approxes = {0.5, 1.0, -2.0, 3.0};
+        const TVector<double> approxDeltas = {0.0, 0.5, 1.0, -1.0};
+        const TVector<float> targets = {1.0f, 2.0f, 0.0f, 1.0f};
+        const TVector<float> weights = {1.0f, 2.0f, 0.5f, 1.0f};
+        TRMSEError error(/*isExpApprox*/ false);
+
+        CheckDersRange(error, approxes, {}, targets, {}, {{0, 0, 0}, {1.0, -1.0, 0.0}, {2.0, -1.0, 0.0}, {-2.0, -1.0, 0.0}});
+        CheckDersRange(error, approxes, approxDeltas, targets, weights, {{0, 0, 0}, {1.0, -2.0, 0.0}, {0.5, -0.5, 0.0}, {-1.0, -1.0, 0.0}});
+    }
+
+    Y_UNIT_TEST(TestQuantileDersRange) {
+        const TVector<double> approxes = {0.0, 1.0, -2.0, 3.0};
+        const TVector<float> targets = {0.0f, 2.0f, -3.0f, 1.0f};
+        const TVector<float> weights = {1.0f, 2.0f, 0.5f, 1.0f};
+        TQuantileError error(/*alpha*/ 0.25, /*isExpApprox*/ false);
+
+        CheckDersRange(error, approxes, {}, targets, weights, {{0, 0, 0}, {0.5, 0.0, 0.0}, {-0.375, 0.0, 0.0}, {-0.75, 0.0, 0.0}});
+    }
+
+    Y_UNIT_TEST(TestPoissonDersRange) {
+        const TVector<double> expApproxes = {1.0, 2.0, 0.5, 4.0};
+        const TVector<double> expApproxDeltas = {1.0, 1.5, 2.0, 0.25};
+        const TVector<float> targets = {1.0f, 1.0f, 3.0f, 0.0f};
+        const TVector<float> weights = {1.0f, 2.0f, 1.0f, 0.5f};
+        TPoissonError error(/*isExpApprox*/ true);
+
+        CheckDersRange(error, expApproxes, {}, targets, {}, {{0, 0, 0}, {-1.0, -2.0, -2.0}, {2.5, -0.5, -0.5}, {-4.0, -4.0, -4.0}});
+        CheckDersRange(error, expApproxes, expApproxDeltas, targets, weights, {{0, 0, 0}, {-4.0, -6.0, -6.0}, {2.0, -1.0, -1.0}, {-0.5, -0.5, -0.5}});
+    }
+}
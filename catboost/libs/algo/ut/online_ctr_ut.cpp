@@ -0,0 +1,154 @@
+#include <catboost/libs/algo/fold.h>
+#include <catboost/libs/algo/online_ctr.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/algorithm.h>
+#include <util/random/fast.h>
+
+#include <library/unittest/registar.h>
+
+Y_UNIT_TEST_SUITE(TOnlineCtrTest) {
+    Y_UNIT_TEST(CompressDecompress) {
+        TOnlineCTR ctr;
+        ctr.UniqueValuesCount = 7;
+        ctr.Feature.resize(2);
+        for (int ctrIdx = 0; ctrIdx < ctr.Feature.ysize(); ++ctrIdx) {
+            ctr.Feature[ctrIdx].SetSizes(/*priorCount*/ 3, /*classCount*/ ctrIdx + 1);
+            for (size_t classIdx = 0; classIdx < ctr.Feature[ctrIdx].GetYSize(); ++classIdx) {
+                for (size_t priorIdx = 0; priorIdx < ctr.Feature[ctrIdx].GetXSize(); ++priorIdx) {
+                    auto& values = ctr.Feature[ctrIdx][classIdx][priorIdx];
+                    for (size_t docIdx = 0; docIdx < 1000 * priorIdx; ++docIdx) {
+                        values.push_back(static_cast<ui8>((docIdx * (classIdx + 1)) % 7));
+                    }
+                }
+            }
+        }
+        const auto expectedFeature = ctr.Feature;
+
+        CompressOnlineCTR(&ctr);
+        UNIT_ASSERT(ctr.IsCompressed());
+        UNIT_ASSERT(ctr.GetCompressedSize() > 0);
+        UNIT_ASSERT(ctr.Feature.empty());
+        UNIT_ASSERT_VALUES_EQUAL(ctr.UniqueValuesCount, 7);
+
+        DecompressOnlineCTR(&ctr);
+        UNIT_ASSERT(!ctr.IsCompressed());
+        UNIT_ASSERT_VALUES_EQUAL(ctr.Feature.size(), expectedFeature.size());
+        for (int ctrIdx = 0; ctrIdx < ctr.Feature.ysize(); ++ctrIdx) {
+            UNIT_ASSERT(ctr.Feature[ctrIdx] == expectedFeature[ctrIdx]);
+        }
+    }
+
+    Y_UNIT_TEST(PoorlyCompressedValuesAreDropped) {
+        TOnlineCTR ctr;
+        ctr.Feature.resize(1);
+        ctr.Feature[0].SetSizes(/*priorCount*/ 1, /*classCount*/ 1);
+        TFastRng<ui32> rng(0);
+        for (size_t docIdx = 0; docIdx < 10000; ++docIdx) {
+            ctr.Feature[0][0][0].push_back(static_cast<ui8>(rng.Uniform(256)));
+        }
+
+        CompressOnlineCTR(&ctr);
+        UNIT_ASSERT(!ctr.IsCompressed());
+        UNIT_ASSERT(ctr.Feature.empty());
+        UNIT_ASSERT_VALUES_EQUAL(ctr.GetCompressedSize(), 0);
+    }
+
+    Y_UNIT_TEST(DropCompressedCtrsKeepsCandidates) {
+        TVector<TProjection> projections(3);
+        projections[0].AddCatFeature(0);
+        projections[1].AddCatFeature(1);
+        projections[2].AddCatFeature(0);
+        projections[2].AddCatFeature(1);
+
+        TFold fold;
+        for (const auto& proj : projections) {
+            TOnlineCTR& ctr = fold.GetCtrRef(proj);
+            ctr.Feature.resize(1);
+            ctr.Feature[0].SetSizes(/*priorCount*/ 1, /*classCount*/ 1);
+            ctr.Feature[0][0][0].assign(10000, 3);
+            CompressOnlineCTR(&ctr);
+            UNIT_ASSERT(ctr.IsCompressed());
+        }
+        const size_t keptSize = fold.GetCtr(projections[0]).GetCompressedSize();
+        const size_t allSize = fold.GetCompressedCTRsSize();
+
+        const size_t freedSize = fold.DropCompressedCTRs(Max<size_t>(), THashSet<TProjection>{projections[0]});
+        UNIT_ASSERT_VALUES_EQUAL(freedSize, allSize - keptSize);
+        UNIT_ASSERT_VALUES_EQUAL(fold.GetCompressedCTRsSize(), keptSize);
+        UNIT_ASSERT(fold.GetCtr(projections[0]).IsCompressed());
+        for (const auto& proj : {projections[1], projections[2]}) {
+            const auto& ctrs = fold.GetCtrs(proj);
+            UNIT_ASSERT(ctrs.find(proj) == ctrs.end());
+        }
+    }
+
+    Y_UNIT_TEST(ShardedCalculationIsSameAsSequential) {
+        const size_t learnSampleCount = 20000;
+        const TVector<size_t> testOffsets = {learnSampleCount, learnSampleCount + 3000, learnSampleCount + 5000};
+        const size_t totalSampleCount = testOffsets.back();
+        const size_t leafCount = 1000;
+        const TVector<int> targetClassesCounts = {2, 4};
+
+        TReallyFastRng32 rng(0);
+        TVector<ui64> enumeratedCatFeatures(totalSampleCount);
+        for (auto& leafIdx : enumeratedCatFeatures) {
+            leafIdx = rng.Uniform(leafCount);
+        }
+        TVector<TVector<int>> learnTargetClass(targetClassesCounts.size(), TVector<int>(learnSampleCount));
+        for (size_t classifierIdx = 0; classifierIdx < targetClassesCounts.size(); ++classifierIdx) {
+            for (auto& targetClass : learnTargetClass[classifierIdx]) {
+                targetClass = rng.Uniform(targetClassesCounts[classifierIdx]);
+            }
+        }
+        TVector<int> counterCTRTotal(leafCount, 0);
+        for (auto leafIdx : enumeratedCatFeatures) {
+            ++counterCTRTotal[leafIdx];
+        }
+        const int counterCTRDenominator = *MaxElement(counterCTRTotal.begin(), counterCTRTotal.end());
+
+        const TVector<float> priors = {0.0f, 0.5f, 1.0f};
+        const TVector<TCtrInfo> ctrInfo = {
+            {ECtrType::Borders, 15, 0, priors},
+            {ECtrType::Borders, 15, 1, priors},
+            {ECtrType::Buckets, 15, 1, priors},
+            {ECtrType::BinarizedTargetMeanValue, 15, 1, priors},
+            {ECtrType::Counter, 15, 0, priors}
+        };
+
+        TVector<TArray2D<TVector<ui8>>> sequentialFeature(ctrInfo.size());
+        CalcOnlineCTRValues(
+            testOffsets,
+            enumeratedCatFeatures,
+            leafCount,
+            ctrInfo,
+            learnTargetClass,
+            targetClassesCounts,
+            counterCTRTotal,
+            counterCTRDenominator,
+            /*localExecutor*/ nullptr,
+            &sequentialFeature);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        TVector<TArray2D<TVector<ui8>>> shardedFeature(ctrInfo.size());
+        CalcOnlineCTRValues(
+            testOffsets,
+            enumeratedCatFeatures,
+            leafCount,
+            ctrInfo,
+            learnTargetClass,
+            targetClassesCounts,
+            counterCTRTotal,
+            counterCTRDenominator,
+            &localExecutor,
+            &shardedFeature);
+
+        for (size_t ctrIdx = 0; ctrIdx < ctrInfo.size(); ++ctrIdx) {
+            UNIT_ASSERT_VALUES_EQUAL(sequentialFeature[ctrIdx].GetXSize(), priors.size());
+            UNIT_ASSERT_VALUES_EQUAL(sequentialFeature[ctrIdx][0][0].size(), totalSampleCount);
+            UNIT_ASSERT(shardedFeature[ctrIdx] == sequentialFeature[ctrIdx]);
+        }
+    }
+}
@@ -8,6 +8,7 @@
 #include <util/random/fast.h>
 #include <util/generic/vector.h>
 #include <util/generic/xrange.h>
+#include <util/string/cast.h>
 
 
 using namespace NCB;
@@ -125,4 +126,203 @@ Y_UNIT_TEST_SUITE(TTrainTest) {
             UNIT_ASSERT( Equal<float>(features[j], (**rawObjectsData.GetFloatFeature(j)).GetArrayData()) );
         }
     }
+
+    Y_UNIT_TEST(TestProjectionHashCacheDoesNotChangeModel) {
+        const size_t LearnDocCount = 1000;
+        const size_t TestDocCount = 200;
+        const TVector<ui32> CatFeatureCardinalities = {7, 13, 29};
+        const ui32 CatFeatureCount = CatFeatureCardinalities.size();
+
+        TReallyFastRng32 rng(42);
+
+        auto generateData = [&] (size_t docCount, TVector<TVector<TString>>* catFeatures, TVector<float>* target) {
+            catFeatures->assign(CatFeatureCount, TVector<TString>(docCount));
+            target->yresize(docCount);
+            for (size_t i = 0; i < docCount; ++i) {
+                ui32 valuesSum = 0;
+                for (auto featureIdx : xrange(CatFeatureCount)) {
+                    const ui32 value = rng.Uniform(CatFeatureCardinalities[featureIdx]);
+                    (*catFeatures)[featureIdx][i] = ToString(value);
+                    valuesSum += value;
+                }
+                (*target)[i] = (valuesSum % 2) ^ (rng.GenRandReal2() < 0.1 ? 1 : 0);
+            }
+        };
+
+        auto createDataProvider = [&] (const TVector<TVector<TString>>& catFeatures, const TVector<float>& target) {
+            return CreateDataProvider(
+                [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                    TDataMetaInfo metaInfo;
+                    metaInfo.HasTarget = true;
+                    metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                        CatFeatureCount,
+                        TVector<ui32>{0, 1, 2},
+                        TVector<TString>{}
+                    );
+
+                    visitor->Start(metaInfo, target.size(), EObjectsOrder::Undefined, {});
+
+                    for (auto featureIdx : xrange(CatFeatureCount)) {
+                        visitor->AddCatFeature(featureIdx, catFeatures[featureIdx]);
+                    }
+                    visitor->AddTarget(target);
+
+                    visitor->Finish();
+                }
+            );
+        };
+
+        TVector<TVector<TString>> learnCatFeatures;
+        TVector<float> learnTarget;
+        generateData(LearnDocCount, &learnCatFeatures, &learnTarget);
+        TVector<TVector<TString>> testCatFeatures;
+        TVector<float> testTarget;
+        generateData(TestDocCount, &testCatFeatures, &testTarget);
+
+        TDataProviders dataProviders;
+        dataProviders.Learn = createDataProvider(learnCatFeatures, learnTarget);
+        dataProviders.Test.push_back(createDataProvider(testCatFeatures, testTarget));
+
+        NJson::TJsonValue plainFitParams;
+        plainFitParams.InsertValue("loss_function", "Logloss");
+        plainFitParams.InsertValue("random_seed", 5);
+        plainFitParams.InsertValue("iterations", 20);
+        plainFitParams.InsertValue("depth", 4);
+        plainFitParams.InsertValue("max_ctr_complexity", 3);
+        plainFitParams.InsertValue("train_dir", ".");
+        plainFitParams.InsertValue("thread_count", 1);
+
+        // without leaf count limit hashes of combinations are extended from the cached hashes of their base projections
+        TEvalResult cachedTestApprox;
+        TFullModel cachedModel;
+        TrainModel(
+            plainFitParams,
+            nullptr,
+            Nothing(),
+            Nothing(),
+            dataProviders,
+            "",
+            &cachedModel,
+            {&cachedTestApprox}
+        );
+
+        // the limit is not reached, but disables the cache, so all hashes are computed from scratch
+        plainFitParams.InsertValue("ctr_leaf_count_limit", LearnDocCount);
+        TEvalResult testApprox;
+        TFullModel model;
+        TrainModel(
+            plainFitParams,
+            nullptr,
+            Nothing(),
+            Nothing(),
+            dataProviders,
+            "",
+            &model,
+            {&testApprox}
+        );
+
+        UNIT_ASSERT_EQUAL(cachedModel, model);
+        UNIT_ASSERT_EQUAL(cachedTestApprox.GetRawValuesConstRef(), testApprox.GetRawValuesConstRef());
+    }
+
+    Y_UNIT_TEST(TestLazyTestApproxUpdateIsSameAsEager) {
+        const ui32 FloatFeatureCount = 3;
+        const ui32 CatFeatureCardinality = 10;
+        const ui32 FeatureCount = FloatFeatureCount + 1;
+
+        TReallyFastRng32 rng(7);
+
+        // last feature is categorical, so trees with ctr splits (and stored test indices) are there too
+        auto createDataProvider = [&] (size_t docCount) {
+            TVector<TVector<float>> floatFeatures(FloatFeatureCount, TVector<float>(docCount));
+            TVector<TString> catFeature(docCount);
+            TVector<float> target(docCount);
+            for (size_t i = 0; i < docCount; ++i) {
+                const ui32 catValue = rng.Uniform(CatFeatureCardinality);
+                catFeature[i] = ToString(catValue);
+                target[i] = catValue % 3;
+                for (auto featureIdx : xrange(FloatFeatureCount)) {
+                    floatFeatures[featureIdx][i] = rng.GenRandReal2();
+                    target[i] += floatFeatures[featureIdx][i];
+                }
+            }
+            return CreateDataProvider(
+                [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                    TDataMetaInfo metaInfo;
+                    metaInfo.HasTarget = true;
+                    metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                        FeatureCount,
+                        TVector<ui32>{FloatFeatureCount},
+                        TVector<TString>{}
+                    );
+
+                    visitor->Start(metaInfo, docCount, EObjectsOrder::Undefined, {});
+
+                    for (auto featureIdx : xrange(FloatFeatureCount)) {
+                        visitor->AddFloatFeature(
+                            featureIdx,
+                            TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(floatFeatures[featureIdx]))
+                        );
+                    }
+                    visitor->AddCatFeature(FloatFeatureCount, catFeature);
+                    visitor->AddTarget(target);
+
+                    visitor->Finish();
+                }
+            );
+        };
+
+        TDataProviders dataProviders;
+        dataProviders.Learn = createDataProvider(1000);
+        dataProviders.Test.push_back(createDataProvider(300));
+        dataProviders.Test.push_back(createDataProvider(200));
+
+        for (bool useBestModel : {false, true}) {
+            NJson::TJsonValue plainFitParams;
+            plainFitParams.InsertValue("random_seed", 5);
+            plainFitParams.InsertValue("iterations", 30);
+            plainFitParams.InsertValue("train_dir", ".");
+            plainFitParams.InsertValue("thread_count", 1);
+            // with use_best_model the last test set is updated every iteration, the first one is still lazy
+            plainFitParams.InsertValue("use_best_model", useBestModel);
+
+            // test approxes are updated after every tree
+            plainFitParams.InsertValue("metric_period", 1);
+            TVector<TEvalResult> eagerTestApproxes(dataProviders.Test.size());
+            TFullModel eagerModel;
+            TrainModel(
+                plainFitParams,
+                nullptr,
+                Nothing(),
+                Nothing(),
+                dataProviders,
+                "",
+                &eagerModel,
+                {&eagerTestApproxes[0], &eagerTestApproxes[1]}
+            );
+
+            // trees are queued and applied to test sets only when metrics are calculated
+            plainFitParams.InsertValue("metric_period", 7);
+            TVector<TEvalResult> lazyTestApproxes(dataProviders.Test.size());
+            TFullModel lazyModel;
+            TrainModel(
+                plainFitParams,
+                nullptr,
+                Nothing(),
+                Nothing(),
+                dataProviders,
+                "",
+                &lazyModel,
+                {&lazyTestApproxes[0], &lazyTestApproxes[1]}
+            );
+
+            UNIT_ASSERT_EQUAL(eagerModel, lazyModel);
+            for (auto testIdx : xrange(dataProviders.Test.size())) {
+                UNIT_ASSERT_EQUAL(
+                    eagerTestApproxes[testIdx].GetRawValuesConstRef(),
+                    lazyTestApproxes[testIdx].GetRawValuesConstRef()
+                );
+            }
+        }
+    }
 }
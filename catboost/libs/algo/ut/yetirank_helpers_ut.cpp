@@ -0,0 +1,158 @@
+#include <catboost/libs/algo/yetirank_helpers.h>
+#include <catboost/libs/helpers/restorable_rng.h>
+#include <catboost/libs/options/restrictions.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/vector.h>
+#include <util/random/fast.h>
+
+#include <library/unittest/registar.h>
+
+#include <cmath>
+#include <numeric>
+
+
+// pairs generation with dense winner x loser weights matrix, as it was before sparse generation
+static void GenerateYetiRankPairsForQueryDense(
+    const float* relevs,
+    const double* expApproxes,
+    float queryWeight,
+    ui32 querySize,
+    int permutationCount,
+    double decaySpeed,
+    ui64 randomSeed,
+    TVector<TVector<TCompetitor>>* competitors
+) {
+    TFastRng64 rand(randomSeed);
+    competitors->clear();
+    competitors->resize(querySize);
+
+    TVector<int> indices(querySize);
+    TVector<TVector<float>> competitorsWeights(querySize, TVector<float>(querySize));
+    for (int permutationIndex = 0; permutationIndex < permutationCount; ++permutationIndex) {
+        std::iota(indices.begin(), indices.end(), 0);
+        TVector<double> bootstrappedApprox(expApproxes, expApproxes + querySize);
+        for (ui32 docId = 0; docId < querySize; ++docId) {
+            const float uniformValue = rand.GenRandReal1();
+            bootstrappedApprox[docId] *= uniformValue / (1.000001f - uniformValue);
+        }
+
+        Sort(indices, [&](int i, int j) {
+            return bootstrappedApprox[i] > bootstrappedApprox[j];
+        });
+
+        double decayCoefficient = 1;
+        for (ui32 docId = 1; docId < querySize; ++docId) {
+            const int firstCandidate = indices[docId - 1];
+            const int secondCandidate = indices[docId];
+            const double magicConst = 0.15;
+
+            const float pairWeight = magicConst * decayCoefficient * Abs(relevs[firstCandidate] - relevs[secondCandidate]);
+            if (relevs[firstCandidate] > relevs[secondCandidate]) {
+                competitorsWeights[firstCandidate][secondCandidate] += pairWeight;
+            } else if (relevs[firstCandidate] < relevs[secondCandidate]) {
+                competitorsWeights[secondCandidate][firstCandidate] += pairWeight;
+            }
+            decayCoefficient *= decaySpeed;
+        }
+    }
+
+    for (ui32 winnerIndex = 0; winnerIndex < querySize; ++winnerIndex) {
+        for (ui32 loserIndex = 0; loserIndex < querySize; ++loserIndex) {
+            const float competitorsWeight = queryWeight * competitorsWeights[winnerIndex][loserIndex] / permutationCount;
+            if (competitorsWeight != 0) {
+                (*competitors)[winnerIndex].push_back({loserIndex, competitorsWeight});
+            }
+        }
+    }
+}
+
+// sequential version with per query seeds derived from CB_THREAD_LIMIT blocks, as it was before
+static void UpdatePairsForYetiRankDense(
+    const TVector<double>& approxes,
+    const TVector<float>& relevances,
+    int queryInfoSize,
+    int permutationCount,
+    double decaySpeed,
+    ui64 randomSeed,
+    TVector<TQueryInfo>* queriesInfo
+) {
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, queryInfoSize);
+    blockParams.SetBlockCount(CB_THREAD_LIMIT);
+    const int blockSize = blockParams.GetBlockSize();
+    const int blockCount = blockParams.GetBlockCount();
+    const TVector<ui64> randomSeeds = GenRandUI64Vector(blockCount, randomSeed);
+    for (int blockId = 0; blockId < blockCount; ++blockId) {
+        TFastRng64 rand(randomSeeds[blockId]);
+        const int to = Min<int>((blockId + 1) * blockSize, queryInfoSize);
+        for (int queryIndex = blockId * blockSize; queryIndex < to; ++queryIndex) {
+            TQueryInfo& queryInfo = (*queriesInfo)[queryIndex];
+            GenerateYetiRankPairsForQueryDense(
+                relevances.data() + queryInfo.Begin,
+                approxes.data() + queryInfo.Begin,
+                queryInfo.Weight,
+                queryInfo.End - queryInfo.Begin,
+                permutationCount,
+                decaySpeed,
+                rand.GenRand(),
+                &queryInfo.Competitors
+            );
+        }
+    }
+}
+
+
+Y_UNIT_TEST_SUITE(TYetiRankHelpersTest) {
+    Y_UNIT_TEST(SparsePairsAreSameAsDense) {
+        TReallyFastRng32 rng(0);
+
+        // a few large queries among small ones, relevances have ties
+        TVector<TQueryInfo> queriesInfo;
+        TVector<float> relevances;
+        TVector<double> approxes;
+        for (int queryIndex = 0; queryIndex < 300; ++queryIndex) {
+            const ui32 querySize = (queryIndex % 50 == 7) ? 200 + rng.Uniform(100) : 1 + rng.Uniform(30);
+            const ui32 begin = relevances.size();
+            queriesInfo.emplace_back(begin, begin + querySize);
+            queriesInfo.back().Weight = 0.5f + rng.GenRandReal2();
+            for (ui32 docId = 0; docId < querySize; ++docId) {
+                relevances.push_back(rng.Uniform(4));
+                approxes.push_back(std::exp(rng.GenRandReal2() * 2 - 1));
+            }
+        }
+        const int permutationCount = 10;
+        const double decaySpeed = 0.99;
+        const ui64 randomSeed = 42;
+
+        TVector<TQueryInfo> expectedQueriesInfo = queriesInfo;
+        UpdatePairsForYetiRankDense(
+            approxes,
+            relevances,
+            queriesInfo.ysize(),
+            permutationCount,
+            decaySpeed,
+            randomSeed,
+            &expectedQueriesInfo
+        );
+
+        for (int threadCount : {0, 3}) {
+            NPar::TLocalExecutor localExecutor;
+            localExecutor.RunAdditionalThreads(threadCount);
+
+            TVector<TQueryInfo> sparseQueriesInfo = queriesInfo;
+            UpdatePairsForYetiRank(
+                approxes,
+                relevances,
+                sparseQueriesInfo.ysize(),
+                permutationCount,
+                decaySpeed,
+                randomSeed,
+                &sparseQueriesInfo,
+                &localExecutor
+            );
+            UNIT_ASSERT_EQUAL(sparseQueriesInfo, expectedQueriesInfo);
+        }
+    }
+}
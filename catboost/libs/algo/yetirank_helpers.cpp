@@ -3,8 +3,23 @@
 
 #include <catboost/libs/data_types/pair.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/vector.h>
 
+namespace {
+    struct TYetiRankPairWeight {
+        ui64 WinnerLoserKey; // winnerIndex * querySize + loserIndex
+        float Weight;
+    };
+
+    // Buffers reused between queries processed by the same thread
+    struct TYetiRankScratch {
+        TVector<int> Indices;
+        TVector<double> BootstrappedApprox;
+        TVector<TYetiRankPairWeight> PairWeights;
+    };
+}
+
 static void GenerateYetiRankPairsForQuery(
     const float* relevs,
     const double* expApproxes,
@@ -13,6 +28,7 @@ static void GenerateYetiRankPairsForQuery(
     int permutationCount,
     double decaySpeed,
     ui64 randomSeed,
+    TYetiRankScratch* scratch,
     TVector<TVector<TCompetitor>>* competitors
 ) {
     TFastRng64 rand(randomSeed);
@@ -20,11 +36,16 @@ static void GenerateYetiRankPairsForQuery(
     competitorsRef.clear();
     competitorsRef.resize(querySize);
 
-    TVector<int> indices(querySize);
-    TVector<TVector<float>> competitorsWeights(querySize, TVector<float>(querySize));
+    TVector<int>& indices = scratch->Indices;
+    TVector<double>& bootstrappedApprox = scratch->BootstrappedApprox;
+    // only adjacent documents of each permutation form pairs, so there are at most
+    // (querySize - 1) * permutationCount nonzero weights
+    TVector<TYetiRankPairWeight>& pairWeights = scratch->PairWeights;
+    indices.yresize(querySize);
+    pairWeights.clear();
     for (int permutationIndex = 0; permutationIndex < permutationCount; ++permutationIndex) {
         std::iota(indices.begin(), indices.end(), 0);
-        TVector<double> bootstrappedApprox(expApproxes, expApproxes + querySize);
+        bootstrappedApprox.assign(expApproxes, expApproxes + querySize);
         for (ui32 docId = 0; docId < querySize; ++docId) {
             const float uniformValue = rand.GenRandReal1();
             // TODO(nikitxskv): try to experiment with different bootstraps.
@@ -43,47 +64,79 @@ static void GenerateYetiRankPairsForQuery(
 
             const float pairWeight = magicConst * decayCoefficient * Abs(relevs[firstCandidate] - relevs[secondCandidate]);
             if (relevs[firstCandidate] > relevs[secondCandidate]) {
-                competitorsWeights[firstCandidate][secondCandidate] += pairWeight;
+                pairWeights.push_back({(ui64)firstCandidate * querySize + secondCandidate, pairWeight});
             } else if (relevs[firstCandidate] < relevs[secondCandidate]) {
-                competitorsWeights[secondCandidate][firstCandidate] += pairWeight;
+                pairWeights.push_back({(ui64)secondCandidate * querySize + firstCandidate, pairWeight});
             }
             decayCoefficient *= decaySpeed;
         }
     }
 
-    // TODO(nikitxskv): Can be optimized
-    for (ui32 winnerIndex = 0; winnerIndex < querySize; ++winnerIndex) {
-        for (ui32 loserIndex = 0; loserIndex < querySize; ++loserIndex) {
-            const float competitorsWeight = queryWeight * competitorsWeights[winnerIndex][loserIndex] / permutationCount;
-            if (competitorsWeight != 0) {
-                competitorsRef[winnerIndex].push_back({loserIndex, competitorsWeight});
-            }
+    // stable sort keeps weights of the same pair in permutation order, so they are summed
+    // exactly as in the dense winner x loser matrix
+    StableSortBy(pairWeights, [](const TYetiRankPairWeight& pairWeight) { return pairWeight.WinnerLoserKey; });
+    for (size_t pairBegin = 0; pairBegin < pairWeights.size();) {
+        const ui64 key = pairWeights[pairBegin].WinnerLoserKey;
+        float weightSum = 0;
+        size_t pairEnd = pairBegin;
+        for (; pairEnd < pairWeights.size() && pairWeights[pairEnd].WinnerLoserKey == key; ++pairEnd) {
+            weightSum += pairWeights[pairEnd].Weight;
         }
+        const float competitorsWeight = queryWeight * weightSum / permutationCount;
+        if (competitorsWeight != 0) {
+            competitorsRef[key / querySize].push_back({static_cast<ui32>(key % querySize), competitorsWeight});
+        }
+        pairBegin = pairEnd;
     }
 }
 
-static void UpdatePairsForYetiRank(
+void UpdatePairsForYetiRank(
     const TVector<double>& approxes,
     const TVector<float>& relevances,
     int queryInfoSize,
-    const NCatboostOptions::TCatBoostOptions& params,
+    int permutationCount,
+    double decaySpeed,
     ui64 randomSeed,
     TVector<TQueryInfo>* queriesInfo,
     NPar::TLocalExecutor* localExecutor
 ) {
-    const int permutationCount = NCatboostOptions::GetYetiRankPermutations(params.LossFunctionDescription);
-    const double decaySpeed = NCatboostOptions::GetYetiRankDecay(params.LossFunctionDescription);
+    // seeds do not depend on the way queries are distributed among threads
+    TVector<ui64> querySeeds(queryInfoSize);
+    {
+        NPar::TLocalExecutor::TExecRangeParams seedBlockParams(0, queryInfoSize);
+        seedBlockParams.SetBlockCount(CB_THREAD_LIMIT);
+        const int seedBlockSize = seedBlockParams.GetBlockSize();
+        const int seedBlockCount = seedBlockParams.GetBlockCount();
+        const TVector<ui64> randomSeeds = GenRandUI64Vector(seedBlockCount, randomSeed);
+        for (int blockId = 0; blockId < seedBlockCount; ++blockId) {
+            TFastRng64 rand(randomSeeds[blockId]);
+            const int to = Min<int>((blockId + 1) * seedBlockSize, queryInfoSize);
+            for (int queryIndex = blockId * seedBlockSize; queryIndex < to; ++queryIndex) {
+                querySeeds[queryIndex] = rand.GenRand();
+            }
+        }
+    }
+
+    // blocks of consecutive queries with approximately equal document count
+    size_t totalDocCount = 0;
+    for (int queryIndex = 0; queryIndex < queryInfoSize; ++queryIndex) {
+        totalDocCount += (*queriesInfo)[queryIndex].End - (*queriesInfo)[queryIndex].Begin;
+    }
+    const size_t blockDocCount = Max<size_t>(1, totalDocCount / (4 * (localExecutor->GetThreadCount() + 1)));
+    TVector<int> blockStarts = {0};
+    size_t currentBlockDocCount = 0;
+    for (int queryIndex = 0; queryIndex < queryInfoSize; ++queryIndex) {
+        if (currentBlockDocCount >= blockDocCount) {
+            blockStarts.push_back(queryIndex);
+            currentBlockDocCount = 0;
+        }
+        currentBlockDocCount += (*queriesInfo)[queryIndex].End - (*queriesInfo)[queryIndex].Begin;
+    }
+    blockStarts.push_back(queryInfoSize);
 
-    NPar::TLocalExecutor::TExecRangeParams blockParams(0, queryInfoSize);
-    blockParams.SetBlockCount(CB_THREAD_LIMIT);
-    const int blockSize = blockParams.GetBlockSize();
-    const ui32 blockCount = blockParams.GetBlockCount();
-    const TVector<ui64> randomSeeds = GenRandUI64Vector(blockCount, randomSeed);
-    NPar::ParallelFor(*localExecutor, 0, blockCount, [&](int blockId) {
-        TFastRng64 rand(randomSeeds[blockId]);
-        const int from = blockId * blockSize;
-        const int to = Min<int>((blockId + 1) * blockSize, queryInfoSize);
-        for (int queryIndex = from; queryIndex < to; ++queryIndex) {
+    NPar::ParallelFor(*localExecutor, 0, blockStarts.size() - 1, [&](int blockId) {
+        TYetiRankScratch scratch;
+        for (int queryIndex = blockStarts[blockId]; queryIndex < blockStarts[blockId + 1]; ++queryIndex) {
             TQueryInfo& queryInfoRef = (*queriesInfo)[queryIndex];
             GenerateYetiRankPairsForQuery(
                 relevances.data() + queryInfoRef.Begin,
@@ -92,7 +145,8 @@ static void UpdatePairsForYetiRank(
                 queryInfoRef.End - queryInfoRef.Begin,
                 permutationCount,
                 decaySpeed,
-                rand.GenRand(),
+                querySeeds[queryIndex],
+                &scratch,
                 &queryInfoRef.Competitors
             );
         }
@@ -113,7 +167,8 @@ void YetiRankRecalculation(
         bt.Approx[0],
         ff.LearnTarget,
         bt.TailQueryFinish,
-        params,
+        NCatboostOptions::GetYetiRankPermutations(params.LossFunctionDescription),
+        NCatboostOptions::GetYetiRankDecay(params.LossFunctionDescription),
         randomSeed,
         recalculatedQueriesInfo,
         localExecutor
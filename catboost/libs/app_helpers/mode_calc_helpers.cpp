@@ -151,7 +151,10 @@ void NCB::CalcModelSingleHost(
         auto approx = Apply(model, *datasetPart, 0, iterationsLimit, evalPeriod, &executor);
         auto visibleLabelsHelper = BuildLabelsHelper<TExternalLabelsHelper>(model);
 
-        poolColumnsPrinter->UpdateColumnTypeInfo(datasetPart->MetaInfo.ColumnsInfo);
+        // there's no printer for inputs that can't be read again (like 'fd://0')
+        if (poolColumnsPrinter) {
+            poolColumnsPrinter->UpdateColumnTypeInfo(datasetPart->MetaInfo.ColumnsInfo);
+        }
 
         TSetLoggingSilent inThisScope;
         OutputEvalResultToFile(
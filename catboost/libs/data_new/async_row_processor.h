@@ -93,20 +93,40 @@ namespace NCB {
         // processFunc should accept 2 agrs: TData& and lineIdx
         template <class TProcessDataFunc>
         void ProcessBlock(TProcessDataFunc processFunc) {
+            ProcessBlock(
+                [] () { return 0; },
+                [processFunc = std::move(processFunc)] (TData& data, int lineIdx, int* /*context*/) {
+                    processFunc(data, lineIdx);
+                }
+            );
+        }
+
+        /*
+         * createContextFunc is called once for each part of the block processed in parallel, its result
+         *  is passed to processFunc by pointer (useful for reusing temporary buffers between lines)
+         * processFunc should accept 3 agrs: TData&, lineIdx and context pointer
+         */
+        template <class TCreateContextFunc, class TProcessDataFunc>
+        void ProcessBlock(TCreateContextFunc createContextFunc, TProcessDataFunc processFunc) {
             const int threadCount = LocalExecutor->GetThreadCount() + 1;
 
             NPar::TLocalExecutor::TExecRangeParams blockParams(0, ParseBuffer.ysize());
             blockParams.SetBlockCount(threadCount);
-            LocalExecutor->ExecRangeWithThrow([this, blockParams, processFunc = std::move(processFunc)](int blockIdx) {
-                const int blockOffset = blockIdx * blockParams.GetBlockSize();
-                for (int i = blockOffset; i < Min(blockOffset + blockParams.GetBlockSize(), ParseBuffer.ysize()); ++i) {
-                    processFunc(ParseBuffer[i], i);
-                }
-            }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
+            LocalExecutor->ExecRangeWithThrow(
+                [this, blockParams, &createContextFunc, &processFunc] (int blockIdx) {
+                    auto context = createContextFunc();
+                    const int blockOffset = blockIdx * blockParams.GetBlockSize();
+                    for (int i = blockOffset; i < Min(blockOffset + blockParams.GetBlockSize(), ParseBuffer.ysize()); ++i) {
+                        processFunc(ParseBuffer[i], i, &context);
+                    }
+                },
+                0,
+                blockParams.GetBlockCount(),
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
             LinesProcessed += ParseBuffer.ysize();
         }
 
-
         size_t GetParseBufferSize() const {
             return ParseBuffer.size();
         }
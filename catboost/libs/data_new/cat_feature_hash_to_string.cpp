@@ -0,0 +1,137 @@
+#include "cat_feature_hash_to_string.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/cast.h>
+#include <util/generic/xrange.h>
+#include <util/stream/format.h>
+
+#include <utility>
+
+
+namespace NCB {
+
+    // pools grow exponentially from this size, so small dictionaries take little memory
+    static constexpr size_t POOL_INITIAL_SIZE = 64;
+
+
+    TCatFeatureHashToString::TCatFeatureHashToString()
+        : Pool(MakeHolder<TMemoryPool>(POOL_INITIAL_SIZE))
+        , HashToString(Pool.Get())
+    {}
+
+    TCatFeatureHashToString::TCatFeatureHashToString(const THashMap<ui32, TString>& hashToString)
+        : TCatFeatureHashToString()
+    {
+        HashToString.reserve(hashToString.size());
+        for (const auto& [hashedValue, value] : hashToString) {
+            Insert(hashedValue, value);
+        }
+    }
+
+    TCatFeatureHashToString::TCatFeatureHashToString(const TCatFeatureHashToString& rhs)
+        : TCatFeatureHashToString()
+    {
+        HashToString.reserve(rhs.GetSize());
+        for (const auto& [hashedValue, value] : rhs) {
+            Insert(hashedValue, value);
+        }
+    }
+
+    TCatFeatureHashToString::TCatFeatureHashToString(TCatFeatureHashToString&& rhs) noexcept
+        : TCatFeatureHashToString()
+    {
+        Swap(rhs);
+    }
+
+    TCatFeatureHashToString& TCatFeatureHashToString::operator=(const TCatFeatureHashToString& rhs) {
+        if (this != &rhs) {
+            TCatFeatureHashToString copy(rhs);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    TCatFeatureHashToString& TCatFeatureHashToString::operator=(TCatFeatureHashToString&& rhs) noexcept {
+        Swap(rhs);
+        return *this;
+    }
+
+    void TCatFeatureHashToString::Swap(TCatFeatureHashToString& rhs) noexcept {
+        // allocators are swapped together with the hash tables
+        Pool.Swap(rhs.Pool);
+        HashToString.swap(rhs.HashToString);
+    }
+
+    bool TCatFeatureHashToString::operator==(const TCatFeatureHashToString& rhs) const {
+        if (GetSize() != rhs.GetSize()) {
+            return false;
+        }
+        for (const auto& [hashedValue, value] : HashToString) {
+            const auto rhsValue = rhs.Find(hashedValue);
+            if (!rhsValue || (*rhsValue != value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    TStringBuf TCatFeatureHashToString::At(ui32 hashedValue) const {
+        const auto it = HashToString.find(hashedValue);
+        CB_ENSURE(it != HashToString.end(), "No string for categorical feature hashed value " << Hex(hashedValue));
+        return it->second;
+    }
+
+    bool TCatFeatureHashToString::Insert(ui32 hashedValue, TStringBuf value) {
+        TStorage::insert_ctx insertCtx;
+        if (HashToString.contains(hashedValue, insertCtx)) {
+            return false;
+        }
+        HashToString.emplace_direct(insertCtx, hashedValue, Pool->AppendString(value));
+        return true;
+    }
+
+    void TCatFeatureHashToString::Merge(TCatFeatureHashToString&& rhs) {
+        if (IsEmpty()) {
+            Swap(rhs);
+        } else {
+            // copy only new values, so strings present in several parts are stored once
+            for (const auto& [hashedValue, value] : rhs) {
+                Insert(hashedValue, value);
+            }
+        }
+        rhs.Clear();
+    }
+
+    void TCatFeatureHashToString::Clear() {
+        TCatFeatureHashToString empty;
+        Swap(empty);
+    }
+
+    int TCatFeatureHashToString::operator&(IBinSaver& binSaver) {
+        ui64 size = GetSize();
+        binSaver.Add(0, &size);
+        if (binSaver.IsReading()) {
+            Clear();
+            HashToString.reserve(size);
+            for (auto i : xrange(size)) {
+                Y_UNUSED(i);
+                ui32 hashedValue = 0;
+                ui32 length = 0;
+                binSaver.AddMulti(hashedValue, length);
+                char* data = (char*)Pool->Allocate(length);
+                binSaver.AddRawData(0, data, length);
+                HashToString.emplace(hashedValue, TStringBuf(data, length));
+            }
+        } else {
+            for (const auto& [hashedValue, value] : HashToString) {
+                ui32 hashedValueCopy = hashedValue;
+                ui32 length = SafeIntegerCast<ui32>(value.size());
+                binSaver.AddMulti(hashedValueCopy, length);
+                binSaver.AddRawData(0, const_cast<char*>(value.data()), length);
+            }
+        }
+        return 0;
+    }
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <library/binsaver/bin_saver.h>
+
+#include <util/generic/hash.h>
+#include <util/generic/maybe.h>
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/strbuf.h>
+#include <util/memory/pool.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    /* Maps hashed values of one categorical feature to the original strings.
+     *
+     * Strings and hash table nodes are allocated from a memory pool owned by the map, so there's
+     * no separate heap allocation per unique value. The pool starts small and grows exponentially,
+     * so maps with a few values (e.g. binary features or per-thread parts) stay small.
+     * Memory is released only when the map is cleared or destroyed.
+     */
+    class TCatFeatureHashToString {
+    public:
+        using TStorage = THashMap<ui32, TStringBuf, THash<ui32>, TEqualTo<ui32>, TPoolAllocator>;
+        using const_iterator = TStorage::const_iterator;
+
+    public:
+        TCatFeatureHashToString();
+
+        // for tests and compatibility
+        explicit TCatFeatureHashToString(const THashMap<ui32, TString>& hashToString);
+
+        // copies all strings to a new pool
+        TCatFeatureHashToString(const TCatFeatureHashToString& rhs);
+        TCatFeatureHashToString(TCatFeatureHashToString&& rhs) noexcept;
+
+        TCatFeatureHashToString& operator=(const TCatFeatureHashToString& rhs);
+        TCatFeatureHashToString& operator=(TCatFeatureHashToString&& rhs) noexcept;
+
+        void Swap(TCatFeatureHashToString& rhs) noexcept;
+
+        bool operator==(const TCatFeatureHashToString& rhs) const;
+
+        size_t GetSize() const {
+            return HashToString.size();
+        }
+
+        bool IsEmpty() const {
+            return HashToString.empty();
+        }
+
+        bool Has(ui32 hashedValue) const {
+            return HashToString.contains(hashedValue);
+        }
+
+        TMaybe<TStringBuf> Find(ui32 hashedValue) const {
+            const auto it = HashToString.find(hashedValue);
+            if (it == HashToString.end()) {
+                return Nothing();
+            }
+            return it->second;
+        }
+
+        // throws if there's no such hashedValue
+        TStringBuf At(ui32 hashedValue) const;
+
+        // string is copied only if hashedValue is new, returns true in this case
+        bool Insert(ui32 hashedValue, TStringBuf value);
+
+        /* adds values from rhs that are not present in this map yet and clears rhs,
+         * if this map is empty rhs's data is just moved
+         */
+        void Merge(TCatFeatureHashToString&& rhs);
+
+        void Clear();
+
+        // unordered
+        const_iterator begin() const {
+            return HashToString.begin();
+        }
+
+        const_iterator end() const {
+            return HashToString.end();
+        }
+
+        int operator&(IBinSaver& binSaver);
+
+    private:
+        // must be destroyed after HashToString, held by pointer because HashToString's allocator refers to it
+        THolder<TMemoryPool> Pool;
+        TStorage HashToString;
+    };
+
+}
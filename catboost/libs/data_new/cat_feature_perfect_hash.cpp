@@ -1,6 +1,14 @@
 #include "cat_feature_perfect_hash.h"
 
+#include <util/generic/algorithm.h>
+#include <util/generic/bitops.h>
+#include <util/generic/utility.h>
+#include <util/generic/xrange.h>
+#include <util/memory/blob.h>
+#include <util/stream/file.h>
 #include <util/stream/output.h>
+#include <util/string/cast.h>
+#include <util/system/fs.h>
 
 
 template <>
@@ -11,6 +19,170 @@ void Out<NCB::TCatFeatureUniqueValuesCounts>(IOutputStream& out, NCB::TCatFeatur
 
 namespace NCB {
 
+    namespace {
+
+    class TBlobHolder : public IResourceHolder {
+    public:
+        explicit TBlobHolder(TBlob&& blob)
+            : Blob(std::move(blob))
+        {}
+
+        const TBlob& GetBlob() const {
+            return Blob;
+        }
+
+    private:
+        TBlob Blob;
+    };
+
+    }
+
+
+    TCatFeaturePerfectHashMap::TCatFeaturePerfectHashMap(const TMap<ui32, ui32>& perfectHash) {
+        TVector<ui32> hashedValues;
+        hashedValues.yresize(perfectHash.size());
+        TVector<bool> binIsSet(perfectHash.size(), false);
+        for (const auto& [hashedValue, bin] : perfectHash) {
+            CB_ENSURE_INTERNAL(
+                (bin < perfectHash.size()) && !binIsSet[bin],
+                "Perfect hash values are not a permutation of [0, " << perfectHash.size() << ')'
+            );
+            hashedValues[bin] = hashedValue;
+            binIsSet[bin] = true;
+        }
+        for (auto hashedValue : hashedValues) {
+            Insert(hashedValue);
+        }
+    }
+
+    TCatFeaturePerfectHashMap::TCatFeaturePerfectHashMap(
+        TConstArrayRef<ui32> hashedValues,
+        TConstArrayRef<ui32> buckets,
+        TIntrusivePtr<IResourceHolder> resourceHolder
+    )
+        : ExternalHashedValues(hashedValues)
+        , ExternalBuckets(buckets)
+        , ResourceHolder(std::move(resourceHolder))
+    {
+        CB_ENSURE_INTERNAL(ResourceHolder, "TCatFeaturePerfectHashMap: resourceHolder is empty");
+        CB_ENSURE_INTERNAL(
+            (buckets.size() & (buckets.size() - 1)) == 0,
+            "TCatFeaturePerfectHashMap: buckets count is not a power of 2"
+        );
+        CB_ENSURE_INTERNAL(
+            hashedValues.size() < buckets.size() || hashedValues.empty(),
+            "TCatFeaturePerfectHashMap: not enough buckets"
+        );
+    }
+
+    ui32 TCatFeaturePerfectHashMap::Insert(ui32 hashedValue) {
+        if (ResourceHolder) {
+            CopyExternalData();
+        }
+        // keep load factor <= 0.5
+        if (2 * (HashedValuesStorage.size() + 1) > BucketsStorage.size()) {
+            Rehash(Max<size_t>(16, 2 * BucketsStorage.size()));
+        }
+
+        const ui32 bucketMask = (ui32)BucketsStorage.size() - 1;
+        ui32 bucketIdx = GetFirstBucketIdx(hashedValue, bucketMask);
+        for (; BucketsStorage[bucketIdx] != EmptyBucket; bucketIdx = (bucketIdx + 1) & bucketMask) {
+            const ui32 bin = BucketsStorage[bucketIdx];
+            if (HashedValuesStorage[bin] == hashedValue) {
+                return bin;
+            }
+        }
+
+        CB_ENSURE(
+            HashedValuesStorage.size() < (size_t)EmptyBucket,
+            "Error: categorical feature has more than " << EmptyBucket
+            << " unique values, which is currently unsupported"
+        );
+        const ui32 bin = (ui32)HashedValuesStorage.size();
+        HashedValuesStorage.push_back(hashedValue);
+        BucketsStorage[bucketIdx] = bin;
+        return bin;
+    }
+
+    void TCatFeaturePerfectHashMap::CopyExternalData() {
+        HashedValuesStorage.assign(ExternalHashedValues.begin(), ExternalHashedValues.end());
+        BucketsStorage.assign(ExternalBuckets.begin(), ExternalBuckets.end());
+        ExternalHashedValues = TConstArrayRef<ui32>();
+        ExternalBuckets = TConstArrayRef<ui32>();
+        ResourceHolder.Reset();
+    }
+
+    void TCatFeaturePerfectHashMap::Rehash(size_t bucketCount) {
+        BucketsStorage.assign(bucketCount, EmptyBucket);
+        const ui32 bucketMask = (ui32)bucketCount - 1;
+        for (auto bin : xrange((ui32)HashedValuesStorage.size())) {
+            ui32 bucketIdx = GetFirstBucketIdx(HashedValuesStorage[bin], bucketMask);
+            while (BucketsStorage[bucketIdx] != EmptyBucket) {
+                bucketIdx = (bucketIdx + 1) & bucketMask;
+            }
+            BucketsStorage[bucketIdx] = bin;
+        }
+    }
+
+    // only hashed values are saved, buckets are rebuilt on load
+    void TCatFeaturePerfectHashMap::Save(IOutputStream* out) const {
+        const auto hashedValues = GetHashedValues();
+        ::Save(out, (ui32)hashedValues.size());
+        ::SavePodArray(out, hashedValues.data(), hashedValues.size());
+    }
+
+    void TCatFeaturePerfectHashMap::Load(IInputStream* in) {
+        ui32 size = 0;
+        ::Load(in, size);
+        TVector<ui32> hashedValues;
+        hashedValues.yresize(size);
+        ::LoadPodArray(in, hashedValues.data(), size);
+
+        *this = TCatFeaturePerfectHashMap();
+        HashedValuesStorage = std::move(hashedValues);
+        Rehash(FastClp2(Max<size_t>(16, 2 * (size_t)size + 1)));
+    }
+
+    int TCatFeaturePerfectHashMap::operator&(IBinSaver& binSaver) {
+        if (binSaver.IsReading()) {
+            TVector<ui32> hashedValues;
+            binSaver.Add(0, &hashedValues);
+
+            *this = TCatFeaturePerfectHashMap();
+            HashedValuesStorage = std::move(hashedValues);
+            Rehash(FastClp2(Max<size_t>(16, 2 * HashedValuesStorage.size() + 1)));
+        } else {
+            TVector<ui32> hashedValues(GetHashedValues().begin(), GetHashedValues().end());
+            binSaver.Add(0, &hashedValues);
+        }
+        return 0;
+    }
+
+    ui32 UpdateCheckSumImpl(ui32 init, const TCatFeaturePerfectHashMap& data) {
+        const auto hashedValues = data.GetHashedValues();
+        TVector<ui32> bins;
+        bins.yresize(hashedValues.size());
+        Iota(bins.begin(), bins.end(), 0u);
+        Sort(bins, [&] (ui32 lhs, ui32 rhs) { return hashedValues[lhs] < hashedValues[rhs]; });
+
+        ui32 checkSum = init;
+        for (auto bin : bins) {
+            checkSum = UpdateCheckSum(checkSum, hashedValues[bin]);
+            checkSum = UpdateCheckSum(checkSum, bin);
+        }
+        return checkSum;
+    }
+
+
+    TCatFeaturesPerfectHash::~TCatFeaturesPerfectHash() {
+        // release maps before removing the files they use
+        FeaturesPerfectHash.clear();
+        RemoveStaleStorageFiles();
+        if (StorageFileName != StorageTempFile.Name()) {
+            NFs::Remove(StorageFileName);
+        }
+    }
+
     bool TCatFeaturesPerfectHash::operator==(const TCatFeaturesPerfectHash& rhs) const {
         if (CatFeatureUniqValuesCountsVector != rhs.CatFeatureUniqValuesCountsVector) {
             return false;
@@ -28,7 +200,7 @@ namespace NCB {
 
     void TCatFeaturesPerfectHash::UpdateFeaturePerfectHash(
         const TCatFeatureIdx catFeatureIdx,
-        TMap<ui32, ui32>&& perfectHash
+        TCatFeaturePerfectHashMap&& perfectHash
     ) {
         CheckHasFeature(catFeatureIdx);
 
@@ -37,19 +209,109 @@ namespace NCB {
         if (counts.OnAll) {
             // already have some data
             // we must update with data that has not less elements than current
-            Y_VERIFY((size_t)counts.OnAll <= perfectHash.size());
+            Y_VERIFY(counts.OnAll <= perfectHash.GetSize());
         } else {
             // first initialization
-            counts.OnLearnOnly = (ui32)perfectHash.size();
+            counts.OnLearnOnly = perfectHash.GetSize();
         }
 
-        // cast is safe because map from ui32 keys can't have more than Max<ui32>() keys
-        counts.OnAll = (ui32)perfectHash.size();
+        counts.OnAll = perfectHash.GetSize();
 
         if (!HasHashInRam) {
             Load();
         }
         FeaturesPerfectHash[*catFeatureIdx] = std::move(perfectHash);
+        StorageFileIsUpToDate = false;
+    }
+
+    /* Storage file format (all values are ui32 in native byte order):
+     *   featureCount, then for each feature: size, bucketCount, hashedValues[size], buckets[bucketCount]
+     */
+    void TCatFeaturesPerfectHash::SaveToStorageFile() const {
+        // write to a new file, old one might still be memory-mapped (renaming over it fails on Windows)
+        const TString newFileName = StorageTempFile.Name() + '.' + ToString(StorageFileVersion + 1);
+        {
+            TOFStream out(newFileName);
+            ::Save(&out, (ui32)FeaturesPerfectHash.size());
+            for (const auto& featurePerfectHash : FeaturesPerfectHash) {
+                const auto hashedValues = featurePerfectHash.GetHashedValues();
+                const auto buckets = featurePerfectHash.GetBuckets();
+                ::Save(&out, (ui32)hashedValues.size());
+                ::Save(&out, (ui32)buckets.size());
+                ::SavePodArray(&out, hashedValues.data(), hashedValues.size());
+                ::SavePodArray(&out, buckets.data(), buckets.size());
+            }
+            out.Finish();
+        }
+        ++StorageFileVersion;
+        if (NFs::Exists(StorageFileName)) {
+            StaleStorageFiles.push_back(StorageFileName);
+        }
+        StorageFileName = newFileName;
+        StorageFileIsUpToDate = true;
+    }
+
+    void TCatFeaturesPerfectHash::RemoveStaleStorageFiles() const {
+        // file still can be mapped by a copy of some feature's map, try again next time
+        EraseIf(
+            StaleStorageFiles,
+            [] (const TString& fileName) { return NFs::Remove(fileName) || !NFs::Exists(fileName); }
+        );
+    }
+
+    void TCatFeaturesPerfectHash::Load() const {
+        if (!NFs::Exists(StorageFileName) || HasHashInRam) {
+            return;
+        }
+
+        auto blobHolder = MakeIntrusive<TBlobHolder>(TBlob::FromFile(StorageFileName));
+        const TBlob& blob = blobHolder->GetBlob();
+        CB_ENSURE_INTERNAL(
+            blob.Size() % sizeof(ui32) == 0,
+            "Perfect hash storage file " << StorageFileName << " is corrupted"
+        );
+        const TConstArrayRef<ui32> data((const ui32*)blob.Data(), blob.Size() / sizeof(ui32));
+
+        size_t offset = 0;
+        auto getArray = [&] (size_t size) {
+            CB_ENSURE_INTERNAL(
+                offset + size <= data.size(),
+                "Perfect hash storage file " << StorageFileName << " is truncated"
+            );
+            const TConstArrayRef<ui32> result(data.data() + offset, size);
+            offset += size;
+            return result;
+        };
+
+        const ui32 featureCount = getArray(1)[0];
+        TVector<TCatFeaturePerfectHashMap> featuresPerfectHash;
+        featuresPerfectHash.reserve(featureCount);
+        while (featuresPerfectHash.size() < featureCount) {
+            const auto sizes = getArray(2);
+            const auto hashedValues = getArray(sizes[0]);
+            const auto buckets = getArray(sizes[1]);
+            if (buckets.empty()) {
+                featuresPerfectHash.emplace_back();
+            } else {
+                featuresPerfectHash.emplace_back(hashedValues, buckets, blobHolder);
+            }
+        }
+
+        FeaturesPerfectHash.swap(featuresPerfectHash);
+        HasHashInRam = true;
+        StorageFileIsUpToDate = true;
+    }
+
+    void TCatFeaturesPerfectHash::Save(IOutputStream* out) const {
+        if (!HasHashInRam) {
+            Load();
+        }
+        ::SaveMany(out, CatFeatureUniqValuesCountsVector, FeaturesPerfectHash, HasHashInRam);
+    }
+
+    void TCatFeaturesPerfectHash::Load(IInputStream* in) {
+        ::LoadMany(in, CatFeatureUniqValuesCountsVector, FeaturesPerfectHash, HasHashInRam);
+        StorageFileIsUpToDate = false;
     }
 
     int TCatFeaturesPerfectHash::operator&(IBinSaver& binSaver) {
@@ -61,6 +323,7 @@ namespace NCB {
         binSaver.AddMulti(CatFeatureUniqValuesCountsVector, FeaturesPerfectHash, AllowWriteFiles);
         if (binSaver.IsReading()) {
             HasHashInRam = true;
+            StorageFileIsUpToDate = false;
         }
         return 0;
     }
@@ -4,14 +4,20 @@
 
 #include <catboost/libs/helpers/checksum.h>
 #include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/resource_holder.h>
 
 #include <library/binsaver/bin_saver.h>
+#include <library/dbg_output/dump.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/map.h>
+#include <util/generic/maybe.h>
+#include <util/generic/ptr.h>
 #include <util/generic/typetraits.h>
 #include <util/generic/vector.h>
-#include <util/stream/file.h>
-#include <util/system/fs.h>
+#include <util/generic/ylimits.h>
+#include <util/stream/input.h>
+#include <util/stream/output.h>
 #include <util/system/spinlock.h>
 #include <util/system/tempfile.h>
 #include <util/system/types.h>
@@ -41,10 +47,119 @@ Y_DECLARE_PODTYPE(NCB::TCatFeatureUniqueValuesCounts);
 
 namespace NCB {
 
+    /* Perfect hash of one categorical feature: maps hashed values to bins [0, GetSize()),
+     * bins are assigned in the order in which hashed values are inserted.
+     *
+     * Open-addressing table (linear probing) of bins + array of hashed values indexed by bin.
+     * Both are plain ui32 arrays so the map can be used right from a memory-mapped file.
+     */
+    class TCatFeaturePerfectHashMap {
+    public:
+        static constexpr ui32 EmptyBucket = Max<ui32>();
+
+    public:
+        TCatFeaturePerfectHashMap() = default;
+
+        // perfectHash values must be [0, perfectHash.size())
+        explicit TCatFeaturePerfectHashMap(const TMap<ui32, ui32>& perfectHash);
+
+        // data is not copied, resourceHolder must keep it alive
+        TCatFeaturePerfectHashMap(
+            TConstArrayRef<ui32> hashedValues,
+            TConstArrayRef<ui32> buckets,
+            TIntrusivePtr<IResourceHolder> resourceHolder
+        );
+
+        bool operator==(const TCatFeaturePerfectHashMap& rhs) const {
+            return GetHashedValues() == rhs.GetHashedValues();
+        }
+
+        ui32 GetSize() const {
+            return (ui32)GetHashedValues().size();
+        }
+
+        // thread-safe
+        TMaybe<ui32> Find(ui32 hashedValue) const {
+            const TConstArrayRef<ui32> buckets = GetBuckets();
+            if (buckets.empty()) {
+                return Nothing();
+            }
+            const TConstArrayRef<ui32> hashedValues = GetHashedValues();
+            const ui32 bucketMask = (ui32)buckets.size() - 1;
+            for (ui32 bucketIdx = GetFirstBucketIdx(hashedValue, bucketMask); ;
+                 bucketIdx = (bucketIdx + 1) & bucketMask)
+            {
+                const ui32 bin = buckets[bucketIdx];
+                if (bin == EmptyBucket) {
+                    return Nothing();
+                }
+                if (hashedValues[bin] == hashedValue) {
+                    return bin;
+                }
+            }
+        }
+
+        // returns bin for hashedValue, new values get the next bin
+        ui32 Insert(ui32 hashedValue);
+
+        // [bin] -> hashedValue
+        TConstArrayRef<ui32> GetHashedValues() const {
+            return ResourceHolder ? ExternalHashedValues : TConstArrayRef<ui32>(HashedValuesStorage);
+        }
+
+        TConstArrayRef<ui32> GetBuckets() const {
+            return ResourceHolder ? ExternalBuckets : TConstArrayRef<ui32>(BucketsStorage);
+        }
+
+        void Save(IOutputStream* out) const;
+        void Load(IInputStream* in);
+
+        int operator&(IBinSaver& binSaver);
+
+    private:
+        static ui32 GetFirstBucketIdx(ui32 hashedValue, ui32 bucketMask) {
+            return (ui32)((hashedValue * 0x9E3779B97F4A7C15ULL) >> 32) & bucketMask;
+        }
+
+        void CopyExternalData();
+        void Rehash(size_t bucketCount);
+
+    private:
+        TVector<ui32> HashedValuesStorage; // [bin]
+        TVector<ui32> BucketsStorage; // size is a power of 2
+
+        // used instead of storage if ResourceHolder is set
+        TConstArrayRef<ui32> ExternalHashedValues;
+        TConstArrayRef<ui32> ExternalBuckets;
+        TIntrusivePtr<IResourceHolder> ResourceHolder;
+    };
+
+    // same as for TMap<ui32, ui32> with the same content
+    ui32 UpdateCheckSumImpl(ui32 init, const TCatFeaturePerfectHashMap& data);
+}
+
+template <>
+struct TDumper<NCB::TCatFeaturePerfectHashMap> {
+    template <class S>
+    static inline void Dump(S& s, const NCB::TCatFeaturePerfectHashMap& perfectHashMap) {
+        const auto hashedValues = perfectHashMap.GetHashedValues();
+        s << '{';
+        for (size_t bin = 0; bin < hashedValues.size(); ++bin) {
+            s << (bin ? ", " : "") << hashedValues[bin] << " -> " << bin;
+        }
+        s << '}';
+    }
+};
+
+
+namespace NCB {
+
+
     class TCatFeaturesPerfectHash {
     public:
         TCatFeaturesPerfectHash(ui32 catFeatureCount, const TString& storageFile, bool allowWriteFiles)
             : StorageTempFile(storageFile)
+            , StorageFileName(storageFile)
             , CatFeatureUniqValuesCountsVector(catFeatureCount)
             , FeaturesPerfectHash(catFeatureCount)
             , AllowWriteFiles(allowWriteFiles)
@@ -52,11 +167,11 @@ namespace NCB {
             HasHashInRam = true;
         }
 
-        ~TCatFeaturesPerfectHash() = default;
+        ~TCatFeaturesPerfectHash();
 
         bool operator==(const TCatFeaturesPerfectHash& rhs) const;
 
-        const TMap<ui32, ui32>& GetFeaturePerfectHash(const TCatFeatureIdx catFeatureIdx) const {
+        const TCatFeaturePerfectHashMap& GetFeaturePerfectHash(const TCatFeatureIdx catFeatureIdx) const {
             CheckHasFeature(catFeatureIdx);
             if (!HasHashInRam) {
                 Load();
@@ -65,7 +180,10 @@ namespace NCB {
         }
 
         // for testing or setting from external sources
-        void UpdateFeaturePerfectHash(const TCatFeatureIdx catFeatureIdx, TMap<ui32, ui32>&& perfectHash);
+        void UpdateFeaturePerfectHash(
+            const TCatFeatureIdx catFeatureIdx,
+            TCatFeaturePerfectHashMap&& perfectHash
+        );
 
         TCatFeatureUniqueValuesCounts GetUniqueValuesCounts(const TCatFeatureIdx catFeatureIdx) const {
             CheckHasFeature(catFeatureIdx);
@@ -83,33 +201,31 @@ namespace NCB {
 
         void FreeRamIfPossible() const {
             if (AllowWriteFiles) {
-                Save();
-                TVector<TMap<ui32, ui32>> empty;
+                if (!StorageFileIsUpToDate) {
+                    SaveToStorageFile();
+                }
+                TVector<TCatFeaturePerfectHashMap> empty;
                 FeaturesPerfectHash.swap(empty);
                 HasHashInRam = false;
+                RemoveStaleStorageFiles();
             }
         }
 
-        void Load() const {
-            if (NFs::Exists(StorageTempFile.Name()) && !HasHashInRam) {
-                TIFStream inputStream(StorageTempFile.Name());
-                FeaturesPerfectHash.clear();
-                ::Load(&inputStream, FeaturesPerfectHash);
-                HasHashInRam = true;
-            }
-        }
+        // storage file is memory-mapped, data is not copied
+        void Load() const;
 
-        Y_SAVELOAD_DEFINE(CatFeatureUniqValuesCountsVector, FeaturesPerfectHash, HasHashInRam);
+        void Save(IOutputStream* out) const;
+        void Load(IInputStream* in);
 
         int operator&(IBinSaver& binSaver);
 
         ui32 CalcCheckSum() const;
 
     private:
-        void Save() const {
-            TOFStream out(StorageTempFile.Name());
-            ::Save(&out, FeaturesPerfectHash);
-        }
+        void SaveToStorageFile() const;
+
+        // old storage files can be removed only after maps that use them are released
+        void RemoveStaleStorageFiles() const;
 
     private:
         friend class TCatFeaturesPerfectHashHelper;
@@ -124,9 +240,16 @@ namespace NCB {
 
     private:
         TTempFile StorageTempFile;
+
+        // each save goes to a new file, old one might still be memory-mapped
+        mutable TString StorageFileName;
+        mutable ui32 StorageFileVersion = 0;
+        mutable TVector<TString> StaleStorageFiles;
+
         TVector<TCatFeatureUniqueValuesCounts> CatFeatureUniqValuesCountsVector; // [catFeatureIdx]
-        mutable TVector<TMap<ui32, ui32>> FeaturesPerfectHash; // [catFeatureIdx]
+        mutable TVector<TCatFeaturePerfectHashMap> FeaturesPerfectHash; // [catFeatureIdx]
         mutable bool HasHashInRam = true;
+        mutable bool StorageFileIsUpToDate = false; // FeaturesPerfectHash has not changed since Save or Load
         bool AllowWriteFiles;
     };
 }
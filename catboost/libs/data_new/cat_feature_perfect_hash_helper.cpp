@@ -2,18 +2,67 @@
 
 #include "util.h"
 
+#include <util/generic/cast.h>
+#include <util/generic/utility.h>
+#include <util/generic/ymath.h>
 #include <util/system/guard.h>
-#include <util/generic/map.h>
-
-#include <util/generic/ylimits.h>
 
 
 namespace NCB {
 
+    // smaller features are processed sequentially
+    constexpr ui32 MIN_SIZE_FOR_PARALLEL_PERFECT_HASH_UPDATE = 100000;
+
+
+    /* Values absent from perfectHashMap are collected for blocks of objects in parallel (each block keeps
+     * them in the order of first occurrence) and then added block by block, so bins are assigned in the
+     * order of first occurrence, the same as with sequential processing.
+     */
+    static void AddNewValuesInParallel(
+        const TMaybeOwningConstArraySubset<ui32, ui32>& hashedCatArraySubset,
+        NPar::TLocalExecutor* localExecutor,
+        TCatFeaturePerfectHashMap* perfectHashMap
+    ) {
+        const auto& subsetIndexing = *hashedCatArraySubset.GetSubsetIndexing();
+        const auto& srcData = *hashedCatArraySubset.GetSrc();
+
+        const auto parallelUnitRanges = subsetIndexing.GetParallelUnitRanges(
+            CeilDiv(subsetIndexing.Size(), (ui32)localExecutor->GetThreadCount() + 1)
+        );
+
+        TVector<TCatFeaturePerfectHashMap> newValuesPerBlock(parallelUnitRanges.RangesCount());
+
+        localExecutor->ExecRangeWithThrow(
+            [&] (int blockIdx) {
+                auto& newValues = newValuesPerBlock[blockIdx];
+                subsetIndexing.ForEachInSubRange(
+                    parallelUnitRanges.GetRange(blockIdx),
+                    [&] (ui32 /*idx*/, ui32 srcIdx) {
+                        const ui32 hashedCatValue = srcData[srcIdx];
+                        if (!perfectHashMap->Find(hashedCatValue)) {
+                            newValues.Insert(hashedCatValue);
+                        }
+                    }
+                );
+            },
+            0,
+            SafeIntegerCast<int>(parallelUnitRanges.RangesCount()),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+
+        for (const auto& newValues : newValuesPerBlock) {
+            for (auto hashedCatValue : newValues.GetHashedValues()) {
+                perfectHashMap->Insert(hashedCatValue);
+            }
+        }
+    }
+
+
     void TCatFeaturesPerfectHashHelper::UpdatePerfectHashAndMaybeQuantize(
         const TCatFeatureIdx catFeatureIdx,
         TMaybeOwningConstArraySubset<ui32, ui32> hashedCatArraySubset,
-        TMaybe<TArrayRef<ui32>*> dstBins
+        TMaybe<TArrayRef<ui32>*> dstBins,
+        NPar::TLocalExecutor* localExecutor
     ) {
         QuantizedFeaturesInfo->CheckCorrectPerTypeFeatureIdx(catFeatureIdx);
         auto& featuresHash = QuantizedFeaturesInfo->CatFeaturesPerfectHash;
@@ -31,47 +80,47 @@ namespace NCB {
             );
         }
 
-        TMap<ui32, ui32> perfectHashMap;
+        TCatFeaturePerfectHashMap perfectHashMap;
         {
             TWriteGuard guard(QuantizedFeaturesInfo->GetRWMutex());
             if (!featuresHash.HasHashInRam) {
                 featuresHash.Load();
             }
-            perfectHashMap.swap(featuresHash.FeaturesPerfectHash[*catFeatureIdx]);
+            DoSwap(perfectHashMap, featuresHash.FeaturesPerfectHash[*catFeatureIdx]);
         }
 
-        constexpr size_t MAX_UNIQ_CAT_VALUES =
-            static_cast<size_t>(Max<ui32>()) + ((sizeof(size_t) > sizeof(ui32)) ? 1 : 0);
-
-        hashedCatArraySubset.ForEach(
-            [&] (ui32 idx, ui32 hashedCatValue) {
-                auto it = perfectHashMap.find(hashedCatValue);
-                if (it == perfectHashMap.end()) {
-                    CB_ENSURE(
-                        perfectHashMap.size() != MAX_UNIQ_CAT_VALUES,
-                        "Error: categorical feature with id #" << *catFeatureIdx
-                        << " has more than " << MAX_UNIQ_CAT_VALUES
-                        << " unique values, which is currently unsupported"
-                    );
-                    ui32 bin = (ui32)perfectHashMap.size();
+        if ((localExecutor->GetThreadCount() > 0) &&
+            (hashedCatArraySubset.Size() >= MIN_SIZE_FOR_PARALLEL_PERFECT_HASH_UPDATE))
+        {
+            AddNewValuesInParallel(hashedCatArraySubset, localExecutor, &perfectHashMap);
+            if (dstBins) {
+                hashedCatArraySubset.ParallelForEach(
+                    [&] (ui32 idx, ui32 hashedCatValue) {
+                        dstBinsValue[idx] = *perfectHashMap.Find(hashedCatValue);
+                    },
+                    localExecutor
+                );
+            }
+        } else {
+            hashedCatArraySubset.ForEach(
+                [&] (ui32 idx, ui32 hashedCatValue) {
+                    const ui32 bin = perfectHashMap.Insert(hashedCatValue);
                     if (dstBins) {
                         dstBinsValue[idx] = bin;
                     }
-                    perfectHashMap.emplace_hint(it, hashedCatValue, bin);
-                } else if (dstBins) {
-                    dstBinsValue[idx] = it->second;
                 }
-            }
-        );
+            );
+        }
 
         {
             TWriteGuard guard(QuantizedFeaturesInfo->GetRWMutex());
             auto& uniqValuesCounts = featuresHash.CatFeatureUniqValuesCountsVector[*catFeatureIdx];
             if (!uniqValuesCounts.OnAll) {
-                uniqValuesCounts.OnLearnOnly = perfectHashMap.size();
+                uniqValuesCounts.OnLearnOnly = perfectHashMap.GetSize();
             }
-            uniqValuesCounts.OnAll = perfectHashMap.size();
-            featuresHash.FeaturesPerfectHash[*catFeatureIdx].swap(perfectHashMap);
+            uniqValuesCounts.OnAll = perfectHashMap.GetSize();
+            DoSwap(featuresHash.FeaturesPerfectHash[*catFeatureIdx], perfectHashMap);
+            featuresHash.StorageFileIsUpToDate = false;
         }
     }
 
@@ -4,6 +4,8 @@
 
 #include <catboost/libs/helpers/array_subset.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
 #include <util/generic/array_ref.h>
 #include <util/generic/maybe.h>
 #include <util/generic/ptr.h>
@@ -25,11 +27,14 @@ namespace NCB {
             return QuantizedFeaturesInfo->CatFeaturesPerfectHash.GetUniqueValuesCounts(catFeatureIdx);
         }
 
-        // thread-safe w.r.t. QuantizedFeaturesInfo
+        /* thread-safe w.r.t. QuantizedFeaturesInfo
+         * big features are processed in parallel using localExecutor
+         */
         void UpdatePerfectHashAndMaybeQuantize(
             const TCatFeatureIdx catFeatureIdx,
             TMaybeOwningConstArraySubset<ui32, ui32> hashedCatArraySubset,
-            TMaybe<TArrayRef<ui32>*> dstBins
+            TMaybe<TArrayRef<ui32>*> dstBins,
+            NPar::TLocalExecutor* localExecutor
         );
 
     private:
@@ -0,0 +1,259 @@
+#include "loader.h"
+
+#include <catboost/libs/column_description/column.h>
+#include <catboost/libs/data_types/groupid.h>
+#include <catboost/libs/data_util/exists_checker.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/maybe_owning_array_holder.h>
+#include <catboost/libs/helpers/resource_holder.h>
+
+#include <util/folder/path.h>
+#include <util/generic/cast.h>
+#include <util/generic/maybe.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ylimits.h>
+#include <util/string/cast.h>
+#include <util/system/filemap.h>
+#include <util/system/fstat.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    namespace {
+
+    class TFileMapHolder : public IResourceHolder {
+    public:
+        explicit TFileMapHolder(const TString& path)
+            : FileMap(path)
+        {
+            if (FileMap.Length()) {
+                FileMap.Map(0, SafeIntegerCast<size_t>(FileMap.Length()));
+            }
+        }
+
+        TConstArrayRef<char> GetData() const {
+            return TConstArrayRef<char>((const char*)FileMap.Ptr(), FileMap.MappedSize());
+        }
+
+    private:
+        TFileMap FileMap;
+    };
+
+    }
+
+
+    /* Raw features dataset stored as a directory with a binary file for each column, scheme is 'columnar'
+     *
+     * File names are column indices ("0", "1", ...), column types are taken from the column description.
+     * Each file contains values for all objects as an array in native (little-endian) byte order:
+     *   Num, Label, Weight, GroupWeight, Baseline - float
+     *   Categ - ui32 hashes of values computed with CalcCatFeatureHash
+     *   GroupId - TGroupId (ui64), SubgroupId - TSubgroupId (ui32), Timestamp - ui64
+     * Auxiliary and DocId columns are skipped, their files are not required.
+     *
+     * Files are memory-mapped, float and categorical features data is used without copying or parsing.
+     */
+    class TCBColumnarDataLoader final : public IRawFeaturesOrderDatasetLoader {
+    public:
+        explicit TCBColumnarDataLoader(TDatasetLoaderPullArgs&& args);
+
+        void Do(IRawFeaturesOrderDataVisitor* visitor) override;
+
+    private:
+        static TMaybe<size_t> GetElementSize(EColumn columnType);
+
+        TString GetColumnPath(ui32 columnIdx) const {
+            return TFsPath(PoolPath) / ToString(columnIdx);
+        }
+
+        template <class T>
+        TMaybeOwningConstArrayHolder<T> MapColumn(ui32 columnIdx) const {
+            auto fileMapHolder = MakeIntrusive<TFileMapHolder>(GetColumnPath(columnIdx));
+            TConstArrayRef<char> data = fileMapHolder->GetData();
+            CB_ENSURE(
+                data.size() == (size_t)ObjectCount * sizeof(T),
+                "Column " << columnIdx << " file size changed after the dataset loader was created"
+            );
+            return TMaybeOwningConstArrayHolder<T>::CreateOwning(
+                TConstArrayRef<T>((const T*)data.data(), ObjectCount),
+                std::move(fileMapHolder)
+            );
+        }
+
+    private:
+        TString PoolPath;
+        TDatasetLoaderCommonArgs Args;
+        TVector<TColumn> ColumnsDescription;
+        ui32 ObjectCount;
+        TDataMetaInfo DataMetaInfo;
+        TVector<bool> FeatureIgnored;
+    };
+
+
+    TCBColumnarDataLoader::TCBColumnarDataLoader(TDatasetLoaderPullArgs&& args)
+        : PoolPath(args.PoolPath.Path)
+        , Args(std::move(args.CommonArgs))
+        , ObjectCount(0) // inited later
+    {
+        CB_ENSURE(TFsPath(PoolPath).IsDirectory(), "columnar pool '" << PoolPath << "' is not a directory");
+        CB_ENSURE(!Args.PairsFilePath.Inited() || CheckExists(Args.PairsFilePath),
+                  "TCBColumnarDataLoader:PairsFilePath does not exist");
+        CB_ENSURE(!Args.GroupWeightsFilePath.Inited() || CheckExists(Args.GroupWeightsFilePath),
+                  "TCBColumnarDataLoader:GroupWeightsFilePath does not exist");
+
+        TVector<TString> fileNames;
+        TFsPath(PoolPath).ListNames(fileNames);
+        ui32 columnsCount = 0;
+        for (const auto& fileName : fileNames) {
+            ui32 columnIdx;
+            if (TryFromString(fileName, columnIdx)) {
+                columnsCount = Max(columnsCount, columnIdx + 1);
+            }
+        }
+        CB_ENSURE(columnsCount, "columnar pool '" << PoolPath << "' contains no column files");
+
+        ColumnsDescription = Args.CdProvider->GetColumnsDescription(columnsCount);
+
+        TMaybe<ui64> objectCount;
+        for (auto columnIdx : xrange(ColumnsDescription.size())) {
+            const EColumn columnType = ColumnsDescription[columnIdx].Type;
+            const TMaybe<size_t> elementSize = GetElementSize(columnType);
+            if (!elementSize) {
+                continue;
+            }
+            const TFsPath columnPath = GetColumnPath(columnIdx);
+            CB_ENSURE(columnPath.Exists(), "No data file for column " << columnIdx << " (" << columnType << ")");
+
+            const ui64 fileSize = TFileStat(columnPath).Size;
+            CB_ENSURE(
+                fileSize % *elementSize == 0,
+                "Column " << columnIdx << " file size " << fileSize << " is not a multiple of "
+                << *elementSize << " (element size for column type " << columnType << ")"
+            );
+            const ui64 columnObjectCount = fileSize / *elementSize;
+            if (objectCount) {
+                CB_ENSURE(
+                    columnObjectCount == *objectCount,
+                    "Column " << columnIdx << " contains " << columnObjectCount << " objects, but previous columns contain "
+                    << *objectCount
+                );
+            } else {
+                objectCount = columnObjectCount;
+            }
+        }
+        CB_ENSURE(objectCount && *objectCount, "Pool is empty");
+        CB_ENSURE(
+            *objectCount <= (ui64)Max<ui32>(),
+            "CatBoost does not support datasets with more than " << Max<ui32>() << " objects"
+        );
+        ObjectCount = (ui32)*objectCount;
+
+        auto columnsInfo = TDataColumnsMetaInfo{ColumnsDescription};
+        auto featureIds = columnsInfo.GenerateFeatureIds(Nothing());
+
+        DataMetaInfo = TDataMetaInfo(
+            std::move(columnsInfo),
+            Args.GroupWeightsFilePath.Inited(),
+            Args.PairsFilePath.Inited(),
+            &featureIds
+        );
+
+        ProcessIgnoredFeaturesList(Args.IgnoredFeatures, &DataMetaInfo, &FeatureIgnored);
+    }
+
+    TMaybe<size_t> TCBColumnarDataLoader::GetElementSize(EColumn columnType) {
+        switch (columnType) {
+            case EColumn::Num:
+            case EColumn::Label:
+            case EColumn::Weight:
+            case EColumn::GroupWeight:
+            case EColumn::Baseline:
+                return sizeof(float);
+            case EColumn::Categ:
+                return sizeof(ui32);
+            case EColumn::GroupId:
+                return sizeof(TGroupId);
+            case EColumn::SubgroupId:
+                return sizeof(TSubgroupId);
+            case EColumn::Timestamp:
+                return sizeof(ui64);
+            case EColumn::Auxiliary:
+            case EColumn::DocId:
+                return Nothing();
+            default:
+                CB_ENSURE(false, "Column type " << columnType << " is not supported for columnar pools");
+        }
+    }
+
+    void TCBColumnarDataLoader::Do(IRawFeaturesOrderDataVisitor* visitor) {
+        visitor->Start(DataMetaInfo, ObjectCount, Args.ObjectsOrder, {});
+
+        ui32 featureIdx = 0;
+        ui32 baselineIdx = 0;
+        for (auto columnIdx : xrange<ui32>(ColumnsDescription.size())) {
+            switch (ColumnsDescription[columnIdx].Type) {
+                case EColumn::Num:
+                    if (!FeatureIgnored[featureIdx]) {
+                        visitor->AddFloatFeature(featureIdx, MapColumn<float>(columnIdx));
+                    }
+                    ++featureIdx;
+                    break;
+                case EColumn::Categ:
+                    if (!FeatureIgnored[featureIdx]) {
+                        visitor->AddCatFeature(featureIdx, MapColumn<ui32>(columnIdx));
+                    }
+                    ++featureIdx;
+                    break;
+                case EColumn::Label:
+                    visitor->AddTarget(*MapColumn<float>(columnIdx));
+                    break;
+                case EColumn::Weight:
+                    visitor->AddWeights(*MapColumn<float>(columnIdx));
+                    break;
+                case EColumn::GroupWeight:
+                    visitor->AddGroupWeights(*MapColumn<float>(columnIdx));
+                    break;
+                case EColumn::Baseline:
+                    visitor->AddBaseline(baselineIdx, *MapColumn<float>(columnIdx));
+                    ++baselineIdx;
+                    break;
+                case EColumn::GroupId: {
+                    auto groupIds = MapColumn<TGroupId>(columnIdx);
+                    for (auto objectIdx : xrange(ObjectCount)) {
+                        visitor->AddGroupId(objectIdx, groupIds[objectIdx]);
+                    }
+                    break;
+                }
+                case EColumn::SubgroupId: {
+                    auto subgroupIds = MapColumn<TSubgroupId>(columnIdx);
+                    for (auto objectIdx : xrange(ObjectCount)) {
+                        visitor->AddSubgroupId(objectIdx, subgroupIds[objectIdx]);
+                    }
+                    break;
+                }
+                case EColumn::Timestamp: {
+                    auto timestamps = MapColumn<ui64>(columnIdx);
+                    for (auto objectIdx : xrange(ObjectCount)) {
+                        visitor->AddTimestamp(objectIdx, timestamps[objectIdx]);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        SetGroupWeights(Args.GroupWeightsFilePath, ObjectCount, visitor);
+        SetPairs(Args.PairsFilePath, ObjectCount, visitor);
+
+        visitor->Finish();
+    }
+
+
+    namespace {
+        TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSColumnarExistsCheckerReg("columnar");
+        TDatasetLoaderFactory::TRegistrator<TCBColumnarDataLoader> CBColumnarDataLoaderReg("columnar");
+    }
+}
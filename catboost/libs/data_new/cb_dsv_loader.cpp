@@ -14,6 +14,8 @@
 #include <util/string/split.h>
 #include <util/system/types.h>
 
+#include <cstring>
+
 
 namespace NCB {
 
@@ -70,7 +72,7 @@ namespace NCB {
 
 
     void TCBDsvDataLoader::StartBuilder(bool inBlock,
-                                          ui32 objectCount, ui32 /*offset*/,
+                                          TMaybe<ui32> objectCount, ui32 /*offset*/,
                                           IRawObjectsOrderDataVisitor* visitor)
     {
         visitor->Start(inBlock, DataMetaInfo, objectCount, Args.ObjectsOrder, {});
@@ -82,22 +84,47 @@ namespace NCB {
 
         auto& columnsDescription = DataMetaInfo.ColumnsInfo->Columns;
 
-        auto parseBlock = [&](TString& line, int lineIdx) {
-            const auto& featuresLayout = *DataMetaInfo.FeaturesLayout;
+        const auto& featuresLayout = *DataMetaInfo.FeaturesLayout;
+
+        // per-line buffers, reused for all lines in a part of the block processed by one thread
+        struct TParseContext {
+            TVector<float> FloatFeatures;
+            TVector<ui32> CatFeatures;
+        };
 
+        auto createParseContext = [&] () {
+            TParseContext context;
+            context.FloatFeatures.yresize(featuresLayout.GetFloatFeatureCount());
+            context.CatFeatures.yresize(featuresLayout.GetCatFeatureCount());
+            return context;
+        };
+
+        auto parseBlock = [&](TString& line, int lineIdx, TParseContext* context) {
             ui32 featureId = 0;
             ui32 baselineIdx = 0;
 
-            TVector<float> floatFeatures;
-            floatFeatures.yresize(featuresLayout.GetFloatFeatureCount());
-
-            TVector<ui32> catFeatures;
-            catFeatures.yresize(featuresLayout.GetCatFeatureCount());
+            TVector<float>& floatFeatures = context->FloatFeatures;
+            TVector<ui32>& catFeatures = context->CatFeatures;
 
             size_t tokenCount = 0;
-            TVector<TStringBuf> tokens = StringSplitter(line).Split(FieldDelimiter);
+            const char* tokenBegin = line.data();
+            const char* const lineEnd = line.data() + line.size();
             try {
-                for (const auto& token : tokens) {
+                // split by FieldDelimiter in place, empty tokens are preserved
+                for (bool lastToken = false; !lastToken; ++tokenCount) {
+                    const char* tokenEnd = (const char*)memchr(tokenBegin, FieldDelimiter, lineEnd - tokenBegin);
+                    if (!tokenEnd) {
+                        tokenEnd = lineEnd;
+                        lastToken = true;
+                    }
+                    const TStringBuf token(tokenBegin, tokenEnd);
+                    tokenBegin = tokenEnd + 1;
+
+                    CB_ENSURE(
+                        tokenCount < columnsDescription.size(),
+                        "wrong columns number: expected " << columnsDescription.ysize()
+                        << ", found more"
+                    );
                     try {
                         switch (columnsDescription[tokenCount].Type) {
                             case EColumn::Categ: {
@@ -180,7 +207,6 @@ namespace NCB {
                             << columnsDescription[tokenCount].Type << ", value = \"" << token
                             << "\"): " << e.what();
                     }
-                    ++tokenCount;
                 }
                 if (!floatFeatures.empty()) {
                     visitor->AddAllFloatFeatures(lineIdx, floatFeatures);
@@ -199,12 +225,21 @@ namespace NCB {
             }
         };
 
-        AsyncRowProcessor.ProcessBlock(parseBlock);
+        AsyncRowProcessor.ProcessBlock(createParseContext, parseBlock);
     }
 
     namespace {
         TDatasetLoaderFactory::TRegistrator<TCBDsvDataLoader> DefDataLoaderReg("");
         TDatasetLoaderFactory::TRegistrator<TCBDsvDataLoader> CBDsvDataLoaderReg("dsv");
+        TDatasetLoaderFactory::TRegistrator<TCBDsvDataLoader> CBDsvGZipDataLoaderReg("dsv+gz");
+        TDatasetLoaderFactory::TRegistrator<TCBDsvDataLoader> CBDsvZstdDataLoaderReg("dsv+zst");
+        TDatasetLoaderFactory::TRegistrator<TCBDsvDataLoader> CBDsvLzDataLoaderReg("dsv+lz");
+
+        // dsv data from a file descriptor (e.g. 'fd://0' - stdin), can be read only once
+        TDatasetLoaderFactory::TRegistrator<TCBDsvDataLoader> CBDsvFdDataLoaderReg("fd");
+        TDatasetLoaderFactory::TRegistrator<TCBDsvDataLoader> CBDsvFdGZipDataLoaderReg("fd+gz");
+        TDatasetLoaderFactory::TRegistrator<TCBDsvDataLoader> CBDsvFdZstdDataLoaderReg("fd+zst");
+        TDatasetLoaderFactory::TRegistrator<TCBDsvDataLoader> CBDsvFdLzDataLoaderReg("fd+lz");
     }
 }
 
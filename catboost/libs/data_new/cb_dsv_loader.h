@@ -6,10 +6,10 @@
 #include <catboost/libs/data_util/line_data_reader.h>
 #include <catboost/libs/helpers/exception.h>
 
+#include <util/generic/maybe.h>
 #include <util/generic/ptr.h>
 #include <util/generic/string.h>
 #include <util/generic/vector.h>
-#include <util/generic/ylimits.h>
 #include <util/system/types.h>
 
 
@@ -48,19 +48,9 @@ namespace NCB {
 
         TVector<TColumn> CreateColumnsDescription(ui32 columnsCount);
 
-        ui32 GetObjectCount() override {
-            const ui64 dataLineCount = LineDataReader->GetDataLineCount();
-            CB_ENSURE(
-                dataLineCount <= Max<ui32>(), "CatBoost does not support datasets with more than "
-                << Max<ui32>() << " objects"
-            );
-            // cast is safe - was checked above
-            return (ui32)dataLineCount;
-        }
-
         void StartBuilder(
             bool inBlock,
-            ui32 objectCount,
+            TMaybe<ui32> objectCount,
             ui32 offset,
             IRawObjectsOrderDataVisitor* visitor
         ) override;
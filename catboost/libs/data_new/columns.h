@@ -5,11 +5,13 @@
 #include <catboost/libs/helpers/array_subset.h>
 #include <catboost/libs/helpers/compression.h>
 #include <catboost/libs/helpers/maybe_owning_array_holder.h>
+#include <catboost/libs/helpers/sparse_array.h>
 
 #include <library/threading/local_executor/local_executor.h>
 
 #include <util/system/types.h>
 #include <util/generic/noncopyable.h>
+#include <util/generic/ptr.h>
 #include <util/generic/string.h>
 #include <util/generic/vector.h>
 #include <util/generic/yexception.h>
@@ -115,12 +117,60 @@ namespace NCB {
             CB_ENSURE(SubsetIndexing, "subsetIndexing is empty");
         }
 
+        // srcData is indexed like the source data of subsetIndexing
+        TArrayValuesHolder(ui32 featureId,
+                           TAtomicSharedPtr<const TSparseArray<T>> sparseSrcData,
+                           const TFeaturesArraySubsetIndexing* subsetIndexing)
+            : IFeatureValuesHolder(TType,
+                                   featureId,
+                                   subsetIndexing->Size())
+            , SrcData(TMaybeOwningConstArrayHolder<T>::CreateNonOwning({}))
+            , SparseSrcData(std::move(sparseSrcData))
+            , SubsetIndexing(subsetIndexing)
+        {
+            CB_ENSURE(SubsetIndexing, "subsetIndexing is empty");
+        }
+
+        THolder<TArrayValuesHolder> CloneWithNewSubsetIndexing(
+            const TFeaturesArraySubsetIndexing* subsetIndexing
+        ) const {
+            auto result = MakeHolder<TArrayValuesHolder>(GetId(), SrcData, subsetIndexing);
+            result->SparseSrcData = SparseSrcData;
+            return result;
+        }
+
+        bool IsSparse() const {
+            return SparseSrcData.Get();
+        }
+
+        // indexed like the source data of the subset indexing
+        const TSparseArray<T>& GetSparseSrcData() const {
+            Y_VERIFY(IsSparse());
+            return *SparseSrcData;
+        }
+
+        // O(number of non-default values) for sparse data with TFullSubset or TRangesSubset indexing
+        TSparseArray<T> GetSparseData() const {
+            return GetSparseSrcData().GetSubset(*SubsetIndexing);
+        }
+
+        // only for dense data, use GetSparseData() or ExtractValues() for sparse data
         const TMaybeOwningConstArraySubset<T, ui32> GetArrayData() const {
+            CB_ENSURE_INTERNAL(!IsSparse(), "GetArrayData() is not supported for sparse feature data");
             return {&SrcData, SubsetIndexing};
         }
 
+        // in subset order, for sparse data a new dense array is built on each call
+        TVector<T> ExtractValues() const {
+            if (IsSparse()) {
+                return GetSparseData().ExtractValues();
+            }
+            return GetSubset<T>(*SrcData, *SubsetIndexing);
+        }
+
     private:
-        TMaybeOwningConstArrayHolder<T> SrcData;
+        TMaybeOwningConstArrayHolder<T> SrcData; // empty if data is sparse
+        TAtomicSharedPtr<const TSparseArray<T>> SparseSrcData;
         const TFeaturesArraySubsetIndexing* SubsetIndexing;
     };
 
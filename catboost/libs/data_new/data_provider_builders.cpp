@@ -3,6 +3,7 @@
 #include "data_provider.h"
 #include "feature_index.h"
 #include "objects.h"
+#include "quantization.h"
 #include "target.h"
 #include "util.h"
 #include "visitor.h"
@@ -11,6 +12,7 @@
 #include <catboost/libs/helpers/compression.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/resource_holder.h>
+#include <catboost/libs/helpers/sparse_array.h>
 #include <catboost/libs/logging/logging.h>
 #include <catboost/libs/options/restrictions.h>
 #include <catboost/libs/quantization/utils.h>
@@ -27,6 +29,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <type_traits>
 
 
 namespace NCB {
@@ -45,6 +49,47 @@ namespace NCB {
     };
 
 
+    static bool IsDefaultForSparseFloatFeature(float value) {
+        // -0.0f is not default because TSparseArray compares values bitwise
+        return (value == 0.0f) && !std::signbit(value);
+    }
+
+    static void MakeSparseFloatFeatures(
+        float maxDensity,
+        const TFeaturesArraySubsetIndexing* subsetIndexing,
+        NPar::TLocalExecutor* localExecutor,
+        TVector<THolder<TFloatValuesHolder>>* floatFeatures
+    ) {
+        localExecutor->ExecRangeWithThrow(
+            [&] (int floatFeatureIdx) {
+                auto& floatFeature = (*floatFeatures)[floatFeatureIdx];
+                if (!floatFeature || floatFeature->IsSparse()) {
+                    return;
+                }
+                const auto arrayData = floatFeature->GetArrayData();
+                TConstArrayRef<float> srcData = **arrayData.GetSrc();
+
+                const size_t maxNonDefaultCount = (size_t)(maxDensity * srcData.size());
+                size_t nonDefaultCount = 0;
+                for (float value : srcData) {
+                    if (!IsDefaultForSparseFloatFeature(value) && (++nonDefaultCount > maxNonDefaultCount)) {
+                        return;
+                    }
+                }
+
+                floatFeature = MakeHolder<TFloatValuesHolder>(
+                    floatFeature->GetId(),
+                    MakeAtomicShared<const TSparseArray<float>>(TSparseArray<float>::FromDense(srcData, 0.0f)),
+                    subsetIndexing
+                );
+            },
+            0,
+            SafeIntegerCast<int>(floatFeatures->size()),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+    }
+
+
     class TRawObjectsOrderDataProviderBuilder : public IDataProviderBuilder,
                                                 public IRawObjectsOrderDataVisitor
     {
@@ -54,6 +99,7 @@ namespace NCB {
             NPar::TLocalExecutor* localExecutor
         )
             : InBlock(false)
+            , ObjectCountIsKnown(true)
             , ObjectCount(0)
             , CatFeatureCount(0)
             , Cursor(NotSet)
@@ -67,17 +113,19 @@ namespace NCB {
         void Start(
             bool inBlock,
             const TDataMetaInfo& metaInfo,
-            ui32 objectCount,
+            TMaybe<ui32> objectCount,
             EObjectsOrder objectsOrder,
 
             // keep necessary resources for data to be available (memory mapping for a file for example)
             TVector<TIntrusivePtr<IResourceHolder>> resourceHolders
         ) override {
             CB_ENSURE(!InProcess, "Attempt to start new processing without finishing the last");
+            CB_ENSURE_INTERNAL(objectCount || !inBlock, "Object count must be defined for block processing");
             InProcess = true;
             ResultTaken = false;
 
             InBlock = inBlock;
+            ObjectCountIsKnown = objectCount.Defined();
 
             ui32 prevTailSize = 0;
             if (InBlock) {
@@ -88,7 +136,7 @@ namespace NCB {
             } else {
                 NextCursor = 0;
             }
-            ObjectCount = objectCount + prevTailSize;
+            ObjectCount = objectCount.GetOrElse(0) + prevTailSize;
             CatFeatureCount = metaInfo.FeaturesLayout->GetCatFeatureCount();
 
             Cursor = NotSet;
@@ -101,7 +149,17 @@ namespace NCB {
             Data.CommonObjectsData.ResourceHolders = std::move(resourceHolders);
             Data.CommonObjectsData.Order = objectsOrder;
 
-            FloatFeaturesStorage.PrepareForInitialization(*metaInfo.FeaturesLayout, ObjectCount, prevTailSize);
+            QuantizedFeaturesInfo = Options.StreamingQuantizedFeaturesInfo;
+            if (QuantizedFeaturesInfo) {
+                CB_ENSURE_INTERNAL(!InBlock, "Streaming quantization is not supported in block processing");
+                PrepareForStreamingQuantization(*metaInfo.FeaturesLayout);
+            } else {
+                FloatFeaturesStorage.PrepareForInitialization(
+                    *metaInfo.FeaturesLayout,
+                    ObjectCount,
+                    prevTailSize
+                );
+            }
             CatFeaturesStorage.PrepareForInitialization(*metaInfo.FeaturesLayout, ObjectCount, prevTailSize);
 
             if (metaInfo.HasWeights) {
@@ -113,8 +171,15 @@ namespace NCB {
         }
 
         void StartNextBlock(ui32 blockSize) override {
+            CB_ENSURE(
+                (ui64)NextCursor + blockSize <= Max<ui32>(),
+                "CatBoost does not support datasets with more than " << Max<ui32>() << " objects"
+            );
             Cursor = NextCursor;
             NextCursor = Cursor + blockSize;
+            if (!ObjectCountIsKnown && (NextCursor > ObjectCount)) {
+                ResizeStorages(NextCursor, /*exactCapacity*/ false);
+            }
         }
 
         // TCommonObjectsData
@@ -132,15 +197,26 @@ namespace NCB {
 
         // TRawObjectsData
         void AddFloatFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, float feature) override {
-            FloatFeaturesStorage.Set(
-                GetInternalFeatureIdx<EFeatureType::Float>(flatFeatureIdx),
-                Cursor + localObjectIdx,
-                feature
-            );
+            auto floatFeatureIdx = GetInternalFeatureIdx<EFeatureType::Float>(flatFeatureIdx);
+            if (QuantizedFeaturesInfo) {
+                AddQuantizedFloatFeature(floatFeatureIdx, Cursor + localObjectIdx, feature);
+            } else {
+                FloatFeaturesStorage.Set(floatFeatureIdx, Cursor + localObjectIdx, feature);
+            }
         }
 
         void AddAllFloatFeatures(ui32 localObjectIdx, TConstArrayRef<float> features) override {
             auto objectIdx = Cursor + localObjectIdx;
+            if (QuantizedFeaturesInfo) {
+                for (auto perTypeFeatureIdx : xrange(features.size())) {
+                    AddQuantizedFloatFeature(
+                        TFloatFeatureIdx(perTypeFeatureIdx),
+                        objectIdx,
+                        features[perTypeFeatureIdx]
+                    );
+                }
+                return;
+            }
             for (auto perTypeFeatureIdx : xrange(features.size())) {
                 FloatFeaturesStorage.Set(
                     TFloatFeatureIdx(perTypeFeatureIdx),
@@ -151,18 +227,16 @@ namespace NCB {
         }
 
         ui32 GetCatFeatureValue(ui32 flatFeatureIdx, TStringBuf feature) override {
-            auto catFeatureIdx = GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx);
             ui32 hashVal = CalcCatFeatureHash(feature);
+            if (!Options.StoreCatFeaturesHashToString) {
+                return hashVal;
+            }
+            auto catFeatureIdx = GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx);
             int hashPartIdx = LocalExecutor->GetWorkerThreadId();
             CB_ENSURE(hashPartIdx < CB_THREAD_LIMIT, "Internal error: thread ID exceeds CB_THREAD_LIMIT");
             auto& catFeatureHashes = HashMapParts[hashPartIdx].CatFeatureHashes;
             catFeatureHashes.resize(CatFeatureCount);
-            auto& catFeatureHash = catFeatureHashes[*catFeatureIdx];
-
-            THashMap<ui32, TString>::insert_ctx insertCtx;
-            if (!catFeatureHash.contains(hashVal, insertCtx)) {
-                catFeatureHash.emplace_direct(insertCtx, hashVal, feature);
-            }
+            catFeatureHashes[*catFeatureIdx].Insert(hashVal, feature);
             return hashVal;
         }
         void AddCatFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, TStringBuf feature) override {
@@ -242,6 +316,10 @@ namespace NCB {
                 RollbackNextCursorToLastGroupStart();
             }
 
+            if (!ObjectCountIsKnown) {
+                ResizeStorages(NextCursor, /*exactCapacity*/ true);
+            }
+
             InProcess = false;
         }
 
@@ -271,11 +349,22 @@ namespace NCB {
                 TFullSubset<ui32>(ObjectCount)
             );
 
-            FloatFeaturesStorage.GetResult(
-                *Data.MetaInfo.FeaturesLayout,
-                Data.CommonObjectsData.SubsetIndexing.Get(),
-                &Data.ObjectsData.FloatFeatures
-            );
+            // float features are already quantized in streaming quantization mode
+            if (!QuantizedFeaturesInfo) {
+                FloatFeaturesStorage.GetResult(
+                    *Data.MetaInfo.FeaturesLayout,
+                    Data.CommonObjectsData.SubsetIndexing.Get(),
+                    &Data.ObjectsData.FloatFeatures
+                );
+                if (Options.SparseFloatFeaturesMaxDensity > 0.0f) {
+                    MakeSparseFloatFeatures(
+                        Options.SparseFloatFeaturesMaxDensity,
+                        Data.CommonObjectsData.SubsetIndexing.Get(),
+                        LocalExecutor,
+                        &Data.ObjectsData.FloatFeatures
+                    );
+                }
+            }
 
             CatFeaturesStorage.GetResult(
                 *Data.MetaInfo.FeaturesLayout,
@@ -286,21 +375,30 @@ namespace NCB {
             if (CatFeatureCount) {
                 auto& catFeaturesHashToString = *Data.CommonObjectsData.CatFeaturesHashToString;
                 catFeaturesHashToString.resize(CatFeatureCount);
-                for (const auto& part : HashMapParts) {
-                    if (part.CatFeatureHashes.empty()) {
-                        continue;
-                    }
-                    for (auto catFeatureIdx : xrange(CatFeatureCount)) {
-                        catFeaturesHashToString[catFeatureIdx].insert(
-                            part.CatFeatureHashes[catFeatureIdx].begin(),
-                            part.CatFeatureHashes[catFeatureIdx].end()
-                        );
-                    }
-                }
+
+                // features are merged in parallel, parts are released as soon as they are merged
+                LocalExecutor->ExecRangeWithThrow(
+                    [&] (int catFeatureIdx) {
+                        for (auto& part : HashMapParts) {
+                            if (!part.CatFeatureHashes.empty()) {
+                                catFeaturesHashToString[catFeatureIdx].Merge(
+                                    std::move(part.CatFeatureHashes[catFeatureIdx])
+                                );
+                            }
+                        }
+                    },
+                    0,
+                    SafeIntegerCast<int>(CatFeatureCount),
+                    NPar::TLocalExecutor::WAIT_COMPLETE
+                );
             }
 
             ResultTaken = true;
 
+            if (QuantizedFeaturesInfo) {
+                return GetStreamingQuantizedResult();
+            }
+
             if (InBlock && Data.MetaInfo.HasGroupId) {
                 auto fullData = MakeDataProvider<TRawObjectsDataProvider>(
                     /*objectsGrouping*/ Nothing(), // will init from data
@@ -366,6 +464,130 @@ namespace NCB {
         }
 
     private:
+        // used only if object count is not known in advance
+        void ResizeStorages(ui32 objectCount, bool exactCapacity) {
+            ObjectCount = objectCount;
+
+            auto resizeStorage = [&] (auto* data) {
+                ResizeStorage(ObjectCount, exactCapacity, data);
+            };
+
+            if (Data.TargetData.Target) {
+                resizeStorage(&*Data.TargetData.Target);
+            }
+            for (auto& baselinePart : Data.TargetData.Baseline) {
+                resizeStorage(&baselinePart);
+            }
+            Data.TargetData.SetTrivialWeights(ObjectCount);
+
+            if (Data.CommonObjectsData.GroupIds) {
+                resizeStorage(&*Data.CommonObjectsData.GroupIds);
+            }
+            if (Data.CommonObjectsData.SubgroupIds) {
+                resizeStorage(&*Data.CommonObjectsData.SubgroupIds);
+            }
+            if (Data.CommonObjectsData.Timestamp) {
+                resizeStorage(&*Data.CommonObjectsData.Timestamp);
+            }
+
+            FloatFeaturesStorage.Resize(ObjectCount, exactCapacity);
+            QuantizedFloatFeaturesStorage.Resize(ObjectCount, exactCapacity);
+            CatFeaturesStorage.Resize(ObjectCount, exactCapacity);
+
+            if (Data.MetaInfo.HasWeights) {
+                resizeStorage(&WeightsBuffer);
+            }
+            if (Data.MetaInfo.HasGroupWeight) {
+                resizeStorage(&GroupWeightsBuffer);
+            }
+        }
+
+        void PrepareForStreamingQuantization(const TFeaturesLayout& featuresLayout) {
+            const auto& quantizedFeaturesLayout = *QuantizedFeaturesInfo->GetFeaturesLayout();
+            CheckCompatibleForApply(quantizedFeaturesLayout, featuresLayout, "data to quantize");
+
+            // features ignored during quantization (e.g. constant ones) are not stored
+            QuantizedFloatFeaturesStorage.PrepareForInitialization(quantizedFeaturesLayout, ObjectCount, 0);
+
+            const size_t floatFeatureCount = (size_t)quantizedFeaturesLayout.GetFloatFeatureCount();
+            FloatFeaturesBorders.assign(floatFeatureCount, TConstArrayRef<float>());
+            FloatFeaturesNanModes.assign(floatFeatureCount, ENanMode::Forbidden);
+            quantizedFeaturesLayout.IterateOverAvailableFeatures<EFeatureType::Float>(
+                [&] (TFloatFeatureIdx floatFeatureIdx) {
+                    CB_ENSURE_INTERNAL(
+                        QuantizedFeaturesInfo->HasBorders(floatFeatureIdx),
+                        "Streaming quantization: borders for float feature #" << *floatFeatureIdx
+                        << " are not set"
+                    );
+                    FloatFeaturesBorders[*floatFeatureIdx] = QuantizedFeaturesInfo->GetBorders(floatFeatureIdx);
+                    FloatFeaturesNanModes[*floatFeatureIdx] = QuantizedFeaturesInfo->GetNanMode(floatFeatureIdx);
+                }
+            );
+            FloatFeaturesAllowNansInTestOnly = QuantizedFeaturesInfo->GetFloatFeaturesAllowNansInTestOnly();
+        }
+
+        void AddQuantizedFloatFeature(TFloatFeatureIdx floatFeatureIdx, ui32 objectIdx, float feature) {
+            if (!QuantizedFloatFeaturesStorage.IsAvailable[*floatFeatureIdx]) {
+                return;
+            }
+            const ENanMode nanMode = FloatFeaturesNanModes[*floatFeatureIdx];
+            QuantizedFloatFeaturesStorage.Set(
+                floatFeatureIdx,
+                objectIdx,
+                QuantizeValue(
+                    feature,
+                    (nanMode != ENanMode::Forbidden) || FloatFeaturesAllowNansInTestOnly,
+                    nanMode,
+                    Data.MetaInfo.FeaturesLayout->GetExternalFeatureIdx(*floatFeatureIdx, EFeatureType::Float),
+                    FloatFeaturesBorders[*floatFeatureIdx]
+                )
+            );
+        }
+
+        TDataProviderPtr GetStreamingQuantizedResult() {
+            TQuantizedBuilderData quantizedData;
+            quantizedData.MetaInfo = std::move(Data.MetaInfo);
+            quantizedData.TargetData = std::move(Data.TargetData);
+            quantizedData.CommonObjectsData = std::move(Data.CommonObjectsData);
+
+            const auto* subsetIndexing = quantizedData.CommonObjectsData.SubsetIndexing.Get();
+
+            QuantizedFloatFeaturesStorage.GetCompressedResult(
+                ObjectCount,
+                *QuantizedFeaturesInfo->GetFeaturesLayout(),
+                subsetIndexing,
+                &quantizedData.ObjectsData.FloatFeatures
+            );
+
+            TQuantizationOptions quantizationOptions;
+            quantizationOptions.GpuCompatibleFormat = false;
+            QuantizeCatFeatures(
+                quantizationOptions,
+                subsetIndexing,
+                QuantizedFeaturesInfo,
+                LocalExecutor,
+                &Data.ObjectsData.CatFeatures,
+                &quantizedData.ObjectsData.CatFeatures
+            );
+
+            // because some features can become unavailable/ignored due to quantization
+            auto featuresLayout = QuantizedFeaturesInfo->GetFeaturesLayout();
+            CB_ENSURE(
+                featuresLayout->HasAvailableAndNotIgnoredFeatures(),
+                "All features are either constant or ignored."
+            );
+            quantizedData.MetaInfo.FeaturesLayout = featuresLayout;
+            quantizedData.CommonObjectsData.FeaturesLayout = featuresLayout;
+            quantizedData.ObjectsData.QuantizedFeaturesInfo = QuantizedFeaturesInfo;
+
+            return MakeDataProvider<TQuantizedForCPUObjectsDataProvider>(
+                /*objectsGrouping*/ Nothing(), // will init from data
+                std::move(quantizedData),
+                Options.SkipCheck,
+                LocalExecutor
+            )->CastMoveTo<TObjectsDataProvider>();
+        }
+
         void RollbackNextCursorToLastGroupStart() {
             const auto& groupIds = *Data.CommonObjectsData.GroupIds;
             if (ObjectCount == 0) {
@@ -390,7 +612,7 @@ namespace NCB {
 
     private:
         struct THashPart {
-            TVector<THashMap<ui32, TString>> CatFeatureHashes;
+            TVector<TCatFeatureHashToString> CatFeatureHashes;
         };
 
 
@@ -451,6 +673,17 @@ namespace NCB {
                 }
             }
 
+            // preserves already set values
+            void Resize(ui32 objectCount, bool exactCapacity) {
+                for (auto perTypeFeatureIdx : xrange(Storage.size())) {
+                    if (IsAvailable[perTypeFeatureIdx]) {
+                        auto& data = Storage[perTypeFeatureIdx]->Data;
+                        ResizeStorage(objectCount, exactCapacity, &data);
+                        DstView[perTypeFeatureIdx] = data;
+                    }
+                }
+            }
+
             void Set(TFeatureIdx<FeatureType> perTypeFeatureIdx, ui32 objectIdx, T value) {
                 if (IsAvailable[*perTypeFeatureIdx]) {
                     DstView[*perTypeFeatureIdx][objectIdx] = value;
@@ -493,11 +726,64 @@ namespace NCB {
                     }
                 }
             }
+
+            // for quantized values stored with 8 bits per key
+            template <class IColumnType>
+            void GetCompressedResult(
+                ui32 objectCount,
+                const TFeaturesLayout& featuresLayout,
+                const TFeaturesArraySubsetIndexing* subsetIndexing,
+                TVector<THolder<IColumnType>>* result
+            ) {
+                static_assert(std::is_same<T, ui8>::value, "Only 8 bits per key are supported");
+
+                const TIndexHelper<ui64> indexHelper(8);
+                const size_t compressedSize = indexHelper.CompressedSize(objectCount);
+
+                const size_t featureCount = (size_t)featuresLayout.GetFeatureCount(FeatureType);
+
+                CB_ENSURE_INTERNAL(
+                    Storage.size() == featureCount,
+                    "Storage is inconsistent with feature Layout"
+                );
+
+                result->clear();
+                result->reserve(featureCount);
+                for (auto perTypeFeatureIdx : xrange(featureCount)) {
+                    if (IsAvailable[perTypeFeatureIdx]) {
+                        // TCompressedArray reads data by whole ui64 words
+                        auto& data = Storage[perTypeFeatureIdx]->Data;
+                        data.resize(compressedSize * sizeof(ui64));
+
+                        result->push_back(
+                            MakeHolder<TCompressedValuesHolderImpl<IColumnType>>(
+                                /* featureId */ featuresLayout.GetExternalFeatureIdx(
+                                    perTypeFeatureIdx, FeatureType
+                                ),
+                                TCompressedArray(
+                                    objectCount,
+                                    indexHelper.GetBitsPerKey(),
+                                    TMaybeOwningArrayHolder<ui64>::CreateOwning(
+                                        // heap allocated data is suitably aligned for ui64
+                                        TArrayRef<ui64>(reinterpret_cast<ui64*>(data.data()), compressedSize),
+                                        Storage[perTypeFeatureIdx]
+                                    )
+                                ),
+                                subsetIndexing
+                            )
+                        );
+                    } else {
+                        result->push_back(nullptr);
+                    }
+                }
+            }
         };
 
     private:
         bool InBlock;
 
+        // if false ObjectCount is the currently allocated size, it grows in StartNextBlock
+        bool ObjectCountIsKnown;
         ui32 ObjectCount;
         ui32 CatFeatureCount;
 
@@ -512,6 +798,15 @@ namespace NCB {
 
         std::array<THashPart, CB_THREAD_LIMIT> HashMapParts;
 
+        // used only in streaming quantization mode
+        TQuantizedFeaturesInfoPtr QuantizedFeaturesInfo;
+        TFeaturesStorage<EFeatureType::Float, ui8> QuantizedFloatFeaturesStorage;
+
+        // copied from QuantizedFeaturesInfo for fast access
+        TVector<TConstArrayRef<float>> FloatFeaturesBorders; // [floatFeatureIdx]
+        TVector<ENanMode> FloatFeaturesNanModes; // [floatFeatureIdx]
+        bool FloatFeaturesAllowNansInTestOnly = false;
+
 
         static constexpr const ui32 NotSet = Max<ui32>();
         ui32 Cursor;
@@ -599,6 +894,20 @@ namespace NCB {
             );
         }
 
+        void AddFloatFeature(ui32 flatFeatureIdx, TSparseArray<float> features) override {
+            CB_ENSURE(
+                features.GetSize() == ObjectCount,
+                "Sparse float feature #" << flatFeatureIdx << " has size " << features.GetSize()
+                << " but object count is " << ObjectCount
+            );
+            auto floatFeatureIdx = GetInternalFeatureIdx<EFeatureType::Float>(flatFeatureIdx);
+            Data.ObjectsData.FloatFeatures[*floatFeatureIdx] = MakeHolder<TFloatValuesHolder>(
+                flatFeatureIdx,
+                MakeAtomicShared<const TSparseArray<float>>(std::move(features)),
+                Data.CommonObjectsData.SubsetIndexing.Get()
+            );
+        }
+
         void AddCatFeature(ui32 flatFeatureIdx, TConstArrayRef<TString> feature) override {
             AddCatFeatureImpl(flatFeatureIdx, feature);
         }
@@ -672,6 +981,15 @@ namespace NCB {
 
             ResultTaken = true;
 
+            if (Options.SparseFloatFeaturesMaxDensity > 0.0f) {
+                MakeSparseFloatFeatures(
+                    Options.SparseFloatFeaturesMaxDensity,
+                    Data.CommonObjectsData.SubsetIndexing.Get(),
+                    LocalExecutor,
+                    &Data.ObjectsData.FloatFeatures
+                );
+            }
+
             return MakeDataProvider<TRawObjectsDataProvider>(
                 /*objectsGrouping*/ Nothing(), // will init from data
                 std::move(Data),
@@ -703,13 +1021,11 @@ namespace NCB {
                 NPar::TLocalExecutor::WAIT_COMPLETE
             );
 
-            auto& catFeatureHash = (*Data.CommonObjectsData.CatFeaturesHashToString)[*catFeatureIdx];
+            if (Options.StoreCatFeaturesHashToString) {
+                auto& catFeatureHash = (*Data.CommonObjectsData.CatFeaturesHashToString)[*catFeatureIdx];
 
-            for (auto objectIdx : xrange(ObjectCount)) {
-                const ui32 hashedValue = hashedCatValues[objectIdx];
-                THashMap<ui32, TString>::insert_ctx insertCtx;
-                if (!catFeatureHash.contains(hashedValue, insertCtx)) {
-                    catFeatureHash.emplace_direct(insertCtx, hashedValue, feature[objectIdx]);
+                for (auto objectIdx : xrange(ObjectCount)) {
+                    catFeatureHash.Insert(hashedCatValues[objectIdx], feature[objectIdx]);
                 }
             }
 
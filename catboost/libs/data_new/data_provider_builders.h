@@ -30,6 +30,23 @@ namespace NCB {
         bool CpuCompatibleFormat = true;
         bool GpuCompatibleFormat = true;
         bool SkipCheck = false; // to increase speed, esp. when applying
+
+        /* float features with at most this fraction of non-zero values are stored as sparse,
+         * 0 means that all features are stored as dense
+         */
+        float SparseFloatFeaturesMaxDensity = 0.0f;
+
+        /* original strings of categorical features values are needed only for output (eval columns,
+         * model export to code), if false only hashed values are kept
+         */
+        bool StoreCatFeaturesHashToString = true;
+
+        /* if set, float features are quantized as soon as they are added using borders and nan modes
+         * from it (they must be already set for all available float features), raw float values are not
+         * stored and the result is TQuantizedForCPUObjectsDataProvider.
+         * Supported only by RawObjectsOrder builder and not in block processing
+         */
+        TQuantizedFeaturesInfoPtr StreamingQuantizedFeaturesInfo;
     };
 
     // can return nullptr if IDataProviderBuilder for such visitor type hasn't been implemented yet
@@ -69,14 +69,14 @@ namespace NCB {
 
         TMaybeOwningConstArraySubset<ui32, ui32>(&SrcData, SubsetIndexing).ParallelForEach(
             [&] (ui32 idx, ui32 srcValue) {
-                auto it = perfectHash.find(srcValue); // find is guaranteed to be thread-safe
+                const auto bin = perfectHash.Find(srcValue); // Find is guaranteed to be thread-safe
 
                 // TODO(akhropov): replace by assert for performance?
-                CB_ENSURE(it != perfectHash.end(),
+                CB_ENSURE(bin.Defined(),
                           "Error: hash for feature #" << GetId() << " was not found "
                           << srcValue);
 
-                result[idx] = it->second;
+                result[idx] = *bin;
             },
             localExecutor,
             BINARIZATION_BLOCK_SIZE
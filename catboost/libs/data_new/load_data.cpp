@@ -2,18 +2,24 @@
 
 #include "cb_dsv_loader.h"
 #include "data_provider_builders.h"
+#include "visitor.h"
 
 #include <catboost/libs/column_description/cd_parser.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/int_cast.h>
 #include <catboost/libs/logging/logging.h>
+#include <catboost/libs/quantization/utils.h>
 
 #include <util/datetime/base.h>
+#include <util/generic/ptr.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ylimits.h>
+#include <util/system/atomic.h>
 
 
 namespace NCB {
 
-    TDataProviderPtr ReadDataset(
+    static THolder<IDatasetLoader> CreateDatasetLoader(
         const TPathWithScheme& poolPath,
         const TPathWithScheme& pairsFilePath, // can be uninited
         const TPathWithScheme& groupWeightsFilePath, // can be uninited
@@ -22,7 +28,7 @@ namespace NCB {
         EObjectsOrder objectsOrder,
         NPar::TLocalExecutor* localExecutor
     ) {
-        auto datasetLoader = GetProcessor<IDatasetLoader>(
+        return GetProcessor<IDatasetLoader>(
             poolPath, // for choosing processor
 
             // processor args
@@ -41,6 +47,27 @@ namespace NCB {
                 }
             }
         );
+    }
+
+
+    TDataProviderPtr ReadDataset(
+        const TPathWithScheme& poolPath,
+        const TPathWithScheme& pairsFilePath, // can be uninited
+        const TPathWithScheme& groupWeightsFilePath, // can be uninited
+        const NCatboostOptions::TDsvPoolFormatParams& dsvPoolFormatParams,
+        const TVector<ui32>& ignoredFeatures,
+        EObjectsOrder objectsOrder,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        auto datasetLoader = CreateDatasetLoader(
+            poolPath,
+            pairsFilePath,
+            groupWeightsFilePath,
+            dsvPoolFormatParams,
+            ignoredFeatures,
+            objectsOrder,
+            localExecutor
+        );
 
         THolder<IDataProviderBuilder> dataProviderBuilder = CreateDataProviderBuilder(
             datasetLoader->GetVisitorType(),
@@ -126,6 +153,422 @@ namespace NCB {
         return dataProviderBuilder->GetResult();
     }
 
+    // Base class for visitors that use only float features values to calculate borders and nan modes
+    class TFloatFeaturesBordersVisitor : public IRawObjectsOrderDataVisitor {
+    public:
+        void Start(
+            bool inBlock,
+            const TDataMetaInfo& metaInfo,
+            TMaybe<ui32> /*objectCount*/,
+            EObjectsOrder /*objectsOrder*/,
+            TVector<TIntrusivePtr<IResourceHolder>> /*resourceHolders*/
+        ) override {
+            CB_ENSURE_INTERNAL(!inBlock, "TFloatFeaturesBordersVisitor does not support block processing");
+
+            FeaturesLayout = metaInfo.FeaturesLayout;
+
+            const ui32 floatFeatureCount = FeaturesLayout->GetFloatFeatureCount();
+            IsAvailable.yresize(floatFeatureCount);
+            for (auto floatFeatureIdx : xrange(floatFeatureCount)) {
+                IsAvailable[floatFeatureIdx] = FeaturesLayout->GetInternalFeatureMetaInfo(
+                    floatFeatureIdx,
+                    EFeatureType::Float
+                ).IsAvailable;
+            }
+            StartImpl();
+        }
+
+        void AddGroupId(ui32 /*localObjectIdx*/, TGroupId /*value*/) override {}
+        void AddSubgroupId(ui32 /*localObjectIdx*/, TSubgroupId /*value*/) override {}
+        void AddTimestamp(ui32 /*localObjectIdx*/, ui64 /*value*/) override {}
+
+        // categorical features values are not needed for float features borders
+        ui32 GetCatFeatureValue(ui32 /*flatFeatureIdx*/, TStringBuf /*feature*/) override {
+            return 0;
+        }
+        void AddCatFeature(ui32 /*localObjectIdx*/, ui32 /*flatFeatureIdx*/, TStringBuf /*feature*/) override {}
+        void AddAllCatFeatures(ui32 /*localObjectIdx*/, TConstArrayRef<ui32> /*features*/) override {}
+
+        void AddTarget(ui32 /*localObjectIdx*/, const TString& /*value*/) override {}
+        void AddTarget(ui32 /*localObjectIdx*/, float /*value*/) override {}
+        void AddBaseline(ui32 /*localObjectIdx*/, ui32 /*baselineIdx*/, float /*value*/) override {}
+        void AddWeight(ui32 /*localObjectIdx*/, float /*value*/) override {}
+        void AddGroupWeight(ui32 /*localObjectIdx*/, float /*value*/) override {}
+
+        void SetGroupWeights(TVector<float>&& /*groupWeights*/) override {}
+        void SetPairs(TVector<TPair>&& /*pairs*/) override {}
+        TMaybeData<TConstArrayRef<TGroupId>> GetGroupIds() const override {
+            return Nothing();
+        }
+
+        void Finish() override {}
+
+        TFeaturesLayoutPtr GetFeaturesLayout() const {
+            return FeaturesLayout;
+        }
+
+        // collected data is released
+        virtual void CalcBordersAndNanModes(
+            TQuantizedFeaturesInfo* quantizedFeaturesInfo,
+            NPar::TLocalExecutor* localExecutor
+        ) = 0;
+
+    protected:
+        // called at the end of Start, FeaturesLayout and IsAvailable are already set
+        virtual void StartImpl() = 0;
+
+        static TVector<TFloatFeatureIdx> GetAvailableFloatFeatures(
+            const TQuantizedFeaturesInfo& quantizedFeaturesInfo
+        ) {
+            TVector<TFloatFeatureIdx> floatFeatureIndices;
+            quantizedFeaturesInfo.GetFeaturesLayout()->IterateOverAvailableFeatures<EFeatureType::Float>(
+                [&] (TFloatFeatureIdx floatFeatureIdx) {
+                    floatFeatureIndices.push_back(floatFeatureIdx);
+                }
+            );
+            return floatFeatureIndices;
+        }
+
+    protected:
+        TFeaturesLayoutPtr FeaturesLayout;
+        TVector<bool> IsAvailable; // [floatFeatureIdx]
+    };
+
+
+    /* Keeps float features values only for a uniform random sample of at most SampleSize objects
+     * (reservoir sampling), all other data is discarded.
+     * Sample slots are assigned sequentially in StartNextBlock so the sample does not depend on the order
+     * in which objects inside a block are processed.
+     */
+    class TFloatFeaturesSampler : public TFloatFeaturesBordersVisitor {
+    public:
+        TFloatFeaturesSampler(ui32 sampleSize, TRestorableFastRng64* rand)
+            : SampleSize(sampleSize)
+            , Rand(rand)
+            , ObjectCount(0)
+        {}
+
+        void StartNextBlock(ui32 blockSize) override {
+            const ui32 sampleSize = (ui32)Min<ui64>(SampleSize, ObjectCount + blockSize);
+            if (sampleSize > SlotOwners.size()) {
+                SlotOwners.resize(sampleSize);
+                for (auto floatFeatureIdx : xrange(Sample.size())) {
+                    if (IsAvailable[floatFeatureIdx]) {
+                        Sample[floatFeatureIdx].resize(sampleSize);
+                    }
+                }
+            }
+
+            Slots.yresize(blockSize);
+            for (auto localObjectIdx : xrange(blockSize)) {
+                const ui64 objectIdx = ObjectCount + localObjectIdx;
+                ui32 slot = NotSampled;
+                if (objectIdx < SampleSize) {
+                    slot = (ui32)objectIdx;
+                } else {
+                    const ui64 randomIdx = Rand->Uniform(objectIdx + 1);
+                    if (randomIdx < SampleSize) {
+                        slot = (ui32)randomIdx;
+                    }
+                }
+                Slots[localObjectIdx] = slot;
+                if (slot != NotSampled) {
+                    SlotOwners[slot] = objectIdx;
+                }
+            }
+            // if several objects in this block got the same slot only the last of them is kept
+            for (auto localObjectIdx : xrange(blockSize)) {
+                auto& slot = Slots[localObjectIdx];
+                if ((slot != NotSampled) && (SlotOwners[slot] != ObjectCount + localObjectIdx)) {
+                    slot = NotSampled;
+                }
+            }
+
+            ObjectCount += blockSize;
+        }
+
+        void AddFloatFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, float feature) override {
+            const ui32 floatFeatureIdx = FeaturesLayout->GetInternalFeatureIdx(flatFeatureIdx);
+            if (!IsAvailable[floatFeatureIdx]) {
+                return;
+            }
+            if (IsNan(feature)) {
+                AtomicSet(HasNans[floatFeatureIdx], 1);
+            }
+            const ui32 slot = Slots[localObjectIdx];
+            if (slot != NotSampled) {
+                Sample[floatFeatureIdx][slot] = feature;
+            }
+        }
+        void AddAllFloatFeatures(ui32 localObjectIdx, TConstArrayRef<float> features) override {
+            const ui32 slot = Slots[localObjectIdx];
+            for (auto floatFeatureIdx : xrange(features.size())) {
+                if (!IsAvailable[floatFeatureIdx]) {
+                    continue;
+                }
+                if (IsNan(features[floatFeatureIdx])) {
+                    AtomicSet(HasNans[floatFeatureIdx], 1);
+                }
+                if (slot != NotSampled) {
+                    Sample[floatFeatureIdx][slot] = features[floatFeatureIdx];
+                }
+            }
+        }
+
+        void CalcBordersAndNanModes(
+            TQuantizedFeaturesInfo* quantizedFeaturesInfo,
+            NPar::TLocalExecutor* localExecutor
+        ) override {
+            const auto floatFeatureIndices = GetAvailableFloatFeatures(*quantizedFeaturesInfo);
+
+            localExecutor->ExecRangeWithThrow(
+                [&] (int i) {
+                    const auto floatFeatureIdx = floatFeatureIndices[i];
+                    CalcBordersAndNanModeFromSample(
+                        floatFeatureIdx,
+                        Sample[*floatFeatureIdx],
+                        AtomicGet(HasNans[*floatFeatureIdx]) != 0,
+                        quantizedFeaturesInfo
+                    );
+                    TVector<float>().swap(Sample[*floatFeatureIdx]);
+                },
+                0,
+                SafeIntegerCast<int>(floatFeatureIndices.size()),
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+        }
+
+    protected:
+        void StartImpl() override {
+            ObjectCount = 0;
+            SlotOwners.clear();
+            Sample.assign(IsAvailable.size(), TVector<float>());
+            HasNans.Reset(new TAtomic[IsAvailable.size()]());
+        }
+
+    private:
+        static constexpr ui32 NotSampled = Max<ui32>();
+
+        const ui32 SampleSize;
+        TRestorableFastRng64* Rand;
+
+        ui64 ObjectCount; // processed so far
+        TVector<ui64> SlotOwners; // [slot] -> objectIdx of the object currently in this slot
+        TVector<ui32> Slots; // [localObjectIdx] for the current block, NotSampled if not in sample
+        TVector<TVector<float>> Sample; // [floatFeatureIdx][slot]
+
+        // for all objects, not only sampled ones, set concurrently
+        TArrayHolder<TAtomic> HasNans; // [floatFeatureIdx]
+    };
+
+
+    /* Builds quantile sketches of all float features values for EBorderSelectionType::QuantileSketch.
+     * Values of the current block are buffered and added to the sketches (in parallel by features) when
+     * the next block starts, so the result does not depend on the order in which objects are processed.
+     */
+    class TFloatFeaturesSketcher : public TFloatFeaturesBordersVisitor {
+    public:
+        explicit TFloatFeaturesSketcher(NPar::TLocalExecutor* localExecutor)
+            : LocalExecutor(localExecutor)
+            , BlockSize(0)
+        {}
+
+        void StartNextBlock(ui32 blockSize) override {
+            AddBlockToSketches();
+
+            for (auto floatFeatureIdx : xrange(Block.size())) {
+                if (IsAvailable[floatFeatureIdx]) {
+                    Block[floatFeatureIdx].yresize(blockSize);
+                }
+            }
+            BlockSize = blockSize;
+        }
+
+        void AddFloatFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, float feature) override {
+            const ui32 floatFeatureIdx = FeaturesLayout->GetInternalFeatureIdx(flatFeatureIdx);
+            if (IsAvailable[floatFeatureIdx]) {
+                Block[floatFeatureIdx][localObjectIdx] = feature;
+            }
+        }
+        void AddAllFloatFeatures(ui32 localObjectIdx, TConstArrayRef<float> features) override {
+            for (auto floatFeatureIdx : xrange(features.size())) {
+                if (IsAvailable[floatFeatureIdx]) {
+                    Block[floatFeatureIdx][localObjectIdx] = features[floatFeatureIdx];
+                }
+            }
+        }
+
+        void Finish() override {
+            AddBlockToSketches();
+            Block.clear();
+        }
+
+        void CalcBordersAndNanModes(
+            TQuantizedFeaturesInfo* quantizedFeaturesInfo,
+            NPar::TLocalExecutor* localExecutor
+        ) override {
+            const auto floatFeatureIndices = GetAvailableFloatFeatures(*quantizedFeaturesInfo);
+
+            localExecutor->ExecRangeWithThrow(
+                [&] (int i) {
+                    const auto floatFeatureIdx = floatFeatureIndices[i];
+                    CalcBordersAndNanModeFromSketch(
+                        floatFeatureIdx,
+                        Sketches[*floatFeatureIdx],
+                        quantizedFeaturesInfo
+                    );
+                    Sketches[*floatFeatureIdx] = NSplitSelection::TQuantileSketch();
+                },
+                0,
+                SafeIntegerCast<int>(floatFeatureIndices.size()),
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+        }
+
+    protected:
+        void StartImpl() override {
+            Sketches.assign(IsAvailable.size(), NSplitSelection::TQuantileSketch());
+            Block.assign(IsAvailable.size(), TVector<float>());
+            BlockSize = 0;
+        }
+
+    private:
+        void AddBlockToSketches() {
+            if (!BlockSize) {
+                return;
+            }
+            LocalExecutor->ExecRangeWithThrow(
+                [&] (int floatFeatureIdx) {
+                    if (IsAvailable[floatFeatureIdx]) {
+                        auto& sketch = Sketches[floatFeatureIdx];
+                        for (float value : Block[floatFeatureIdx]) {
+                            sketch.Add(value);
+                        }
+                    }
+                },
+                0,
+                SafeIntegerCast<int>(Block.size()),
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+            BlockSize = 0;
+        }
+
+    private:
+        NPar::TLocalExecutor* LocalExecutor;
+
+        TVector<NSplitSelection::TQuantileSketch> Sketches; // [floatFeatureIdx]
+        TVector<TVector<float>> Block; // [floatFeatureIdx][localObjectIdx] for the current block
+        ui32 BlockSize;
+    };
+
+
+    static bool NeedToCalcBorders(const TQuantizedFeaturesInfo& quantizedFeaturesInfo) {
+        bool needToCalcBorders = false;
+        quantizedFeaturesInfo.GetFeaturesLayout()->IterateOverAvailableFeatures<EFeatureType::Float>(
+            [&] (TFloatFeatureIdx floatFeatureIdx) {
+                if (!quantizedFeaturesInfo.HasBorders(floatFeatureIdx)) {
+                    needToCalcBorders = true;
+                }
+            }
+        );
+        return needToCalcBorders;
+    }
+
+
+    TDataProviderPtr ReadAndQuantizeDataset(
+        const TPathWithScheme& poolPath,
+        const TPathWithScheme& pairsFilePath, // can be uninited
+        const TPathWithScheme& groupWeightsFilePath, // can be uninited
+        const NCatboostOptions::TDsvPoolFormatParams& dsvPoolFormatParams,
+        const TVector<ui32>& ignoredFeatures,
+        EObjectsOrder objectsOrder,
+        const TQuantizationOptions& quantizationOptions,
+        TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
+        const NCatboostOptions::TBinarizationOptions& floatFeaturesBinarization,
+        const TInitQuantizedFeaturesInfoFunc& initQuantizedFeaturesInfo,
+        TRestorableFastRng64* rand,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        auto createDatasetLoader = [&] (const TPathWithScheme& pairs, const TPathWithScheme& groupWeights) {
+            auto datasetLoader = CreateDatasetLoader(
+                poolPath,
+                pairs,
+                groupWeights,
+                dsvPoolFormatParams,
+                ignoredFeatures,
+                objectsOrder,
+                localExecutor
+            );
+            CB_ENSURE(
+                datasetLoader->GetVisitorType() == EDatasetVisitorType::RawObjectsOrder,
+                "Streaming quantization is supported only for datasets loaded in objects order (e.g. dsv)"
+            );
+            return datasetLoader;
+        };
+
+        if (!quantizedFeaturesInfo || NeedToCalcBorders(*quantizedFeaturesInfo)) {
+            CB_ENSURE(
+                !IsSinglePassPath(poolPath),
+                "Streaming quantization of data from " << poolPath << " is not supported: it can be read only"
+                " once, but an additional pass is needed to get features layout and calculate borders"
+            );
+
+            THolder<TFloatFeaturesBordersVisitor> bordersVisitor;
+            if (floatFeaturesBinarization.BorderSelectionType == EBorderSelectionType::QuantileSketch) {
+                CATBOOST_DEBUG_LOG << "Building float features quantile sketches for borders calculation..."
+                    << Endl;
+                bordersVisitor = MakeHolder<TFloatFeaturesSketcher>(localExecutor);
+            } else {
+                const ui32 sampleSize = Min(
+                    GetSampleSizeForBorderSelectionType(
+                        Max<ui32>(),
+                        floatFeaturesBinarization.BorderSelectionType,
+                        quantizationOptions.MaxSubsetSizeForSlowBuildBordersAlgorithms
+                    ),
+                    quantizationOptions.MaxSubsetSizeForStreamingBuildBorders
+                );
+
+                CATBOOST_DEBUG_LOG << "Sampling float features values for borders calculation..." << Endl;
+                bordersVisitor = MakeHolder<TFloatFeaturesSampler>(sampleSize, rand);
+            }
+            createDatasetLoader(TPathWithScheme(), TPathWithScheme())->DoIfCompatible(bordersVisitor.Get());
+
+            if (!quantizedFeaturesInfo) {
+                quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+                    *bordersVisitor->GetFeaturesLayout(),
+                    ignoredFeatures,
+                    floatFeaturesBinarization,
+                    /*floatFeaturesAllowNansInTestOnly*/ true,
+                    quantizationOptions.AllowWriteFiles
+                );
+                if (initQuantizedFeaturesInfo) {
+                    initQuantizedFeaturesInfo(quantizedFeaturesInfo.Get());
+                }
+            }
+            bordersVisitor->CalcBordersAndNanModes(quantizedFeaturesInfo.Get(), localExecutor);
+        }
+
+        TDataProviderBuilderOptions builderOptions;
+        builderOptions.StreamingQuantizedFeaturesInfo = quantizedFeaturesInfo;
+        builderOptions.StoreCatFeaturesHashToString = false;
+
+        THolder<IDataProviderBuilder> dataProviderBuilder = CreateDataProviderBuilder(
+            EDatasetVisitorType::RawObjectsOrder,
+            builderOptions,
+            localExecutor
+        );
+        CB_ENSURE_INTERNAL(
+            dataProviderBuilder,
+            "Failed to create data provider builder for visitor of type RawObjectsOrder"
+        );
+
+        createDatasetLoader(pairsFilePath, groupWeightsFilePath)->DoIfCompatible(
+            dynamic_cast<IDatasetVisitor*>(dataProviderBuilder.Get())
+        );
+        return dataProviderBuilder->GetResult();
+    }
+
+
     TDataProviders ReadTrainDatasets(
         const NCatboostOptions::TPoolLoadParams& loadOptions,
         EObjectsOrder objectsOrder,
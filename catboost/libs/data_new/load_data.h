@@ -2,11 +2,15 @@
 
 #include "data_provider.h"
 #include "objects.h"
+#include "quantization.h"
+#include "quantized_features_info.h"
 
 #include <catboost/libs/column_description/column.h>
 #include <catboost/libs/data_util/line_data_reader.h>
 #include <catboost/libs/data_util/path_with_scheme.h>
+#include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/libs/logging/profile_info.h>
+#include <catboost/libs/options/binarization_options.h>
 #include <catboost/libs/options/load_options.h>
 
 #include <library/threading/local_executor/local_executor.h>
@@ -16,6 +20,8 @@
 #include <util/generic/vector.h>
 #include <util/system/types.h>
 
+#include <functional>
+
 
 namespace NCB {
     // use from C++ code
@@ -53,6 +59,45 @@ namespace NCB {
         NPar::TLocalExecutor* localExecutor
     );
 
+    // can set borders and nan modes for some float features, the rest are calculated
+    using TInitQuantizedFeaturesInfoFunc = std::function<void(TQuantizedFeaturesInfo*)>;
+
+    /* Streaming quantization: float features are quantized as soon as they are parsed, so raw float
+     * values are not stored for the whole dataset.
+     * If borders and nan modes have to be calculated the dataset is read twice: the first pass keeps only
+     * a random sample (of the same size as in non-streaming quantization, but at most
+     * quantizationOptions.MaxSubsetSizeForStreamingBuildBorders objects) of float features values to
+     * calculate them, or, for EBorderSelectionType::QuantileSketch, quantile sketches of all float features
+     * values.
+     *
+     * Only datasets that are loaded in objects order (e.g. dsv) are supported.
+     * The result is TQuantizedForCPUObjectsDataProvider, original strings of categorical features values
+     * are not stored in it.
+     *
+     * Used only by quantize mode for now, fit still loads raw datasets with ReadTrainDatasets and quantizes
+     * them afterwards, so its peak memory usage does not change. A pool saved by quantize mode can be
+     * passed to fit as quantized://.
+     */
+    TDataProviderPtr ReadAndQuantizeDataset(
+        const TPathWithScheme& poolPath,
+        const TPathWithScheme& pairsFilePath, // can be uninited
+        const TPathWithScheme& groupWeightsFilePath, // can be uninited
+        const NCatboostOptions::TDsvPoolFormatParams& dsvPoolFormatParams,
+        const TVector<ui32>& ignoredFeatures,
+        EObjectsOrder objectsOrder,
+        const TQuantizationOptions& quantizationOptions,
+
+        /* if nullptr, it is created for the dataset's features layout with floatFeaturesBinarization
+         * and then initQuantizedFeaturesInfo (if not empty) is called for it
+         * pass learn dataset's quantizedFeaturesInfo here to read test datasets
+         */
+        TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
+        const NCatboostOptions::TBinarizationOptions& floatFeaturesBinarization,
+        const TInitQuantizedFeaturesInfoFunc& initQuantizedFeaturesInfo,
+        TRestorableFastRng64* rand,
+        NPar::TLocalExecutor* localExecutor
+    );
+
     TDataProviders ReadTrainDatasets(
         const NCatboostOptions::TPoolLoadParams& loadOptions,
         EObjectsOrder objectsOrder,
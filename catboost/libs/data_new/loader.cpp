@@ -4,6 +4,7 @@
 #include <catboost/libs/helpers/mem_usage.h>
 
 #include <util/generic/ptr.h>
+#include <util/string/ascii.h>
 #include <util/string/cast.h>
 #include <util/string/iterator.h>
 #include <util/system/types.h>
@@ -167,8 +168,102 @@ namespace NCB {
         return s == "nan" || s == "NaN" || s == "NAN" || s == "NA" || s == "Na" || s == "na";
     }
 
+    /* Parses plain decimal values like "-12.345" or "1.5e-3" with at most 15 significant digits and
+     * decimal exponent in [-22, 22].
+     * Both the mantissa and the power of 10 are exactly representable as doubles then, so a single
+     * multiplication or division gives the correctly rounded double and the result is the same as
+     * TryFromString<float> (that also converts the parsed double to float) but much faster.
+     * Returns false if the value is not in this simple format, it has to be parsed by the generic code then.
+     */
+    static bool TryParseSimpleFloat(TStringBuf stringValue, float* value) {
+        constexpr int MAX_SIGNIFICANT_DIGITS = 15;
+        constexpr int MAX_EXACT_POWER_OF_10 = 22;
+        static constexpr double POWERS_OF_10[MAX_EXACT_POWER_OF_10 + 1] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        const char* ptr = stringValue.begin();
+        const char* const end = stringValue.end();
+
+        const bool negative = (ptr != end) && (*ptr == '-');
+        if (negative) {
+            ++ptr;
+        }
+
+        ui64 mantissa = 0;
+        int significantDigits = 0;
+        int exponent = 0;
+
+        auto addDigit = [&] (char c) {
+            if (mantissa || (c != '0')) {
+                if (significantDigits == MAX_SIGNIFICANT_DIGITS) {
+                    return false;
+                }
+                mantissa = mantissa * 10 + (c - '0');
+                ++significantDigits;
+            }
+            return true;
+        };
+
+        const char* integerPartBegin = ptr;
+        for (; (ptr != end) && IsAsciiDigit(*ptr); ++ptr) {
+            if (!addDigit(*ptr)) {
+                return false;
+            }
+        }
+        if (ptr == integerPartBegin) {
+            return false;
+        }
+
+        if ((ptr != end) && (*ptr == '.')) {
+            ++ptr;
+            const char* fractionalPartBegin = ptr;
+            for (; (ptr != end) && IsAsciiDigit(*ptr); ++ptr) {
+                if (!addDigit(*ptr)) {
+                    return false;
+                }
+                --exponent;
+            }
+            if (ptr == fractionalPartBegin) {
+                return false;
+            }
+        }
+
+        if ((ptr != end) && ((*ptr == 'e') || (*ptr == 'E'))) {
+            ++ptr;
+            const bool negativeExponent = (ptr != end) && (*ptr == '-');
+            if ((ptr != end) && ((*ptr == '-') || (*ptr == '+'))) {
+                ++ptr;
+            }
+            const char* exponentBegin = ptr;
+            int explicitExponent = 0;
+            for (; (ptr != end) && IsAsciiDigit(*ptr) && (ptr - exponentBegin < 3); ++ptr) {
+                explicitExponent = explicitExponent * 10 + (*ptr - '0');
+            }
+            if (ptr == exponentBegin) {
+                return false;
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+
+        if (ptr != end) {
+            return false;
+        }
+
+        double result = (double)mantissa;
+        if (mantissa) {
+            if (exponent < -MAX_EXACT_POWER_OF_10 || exponent > MAX_EXACT_POWER_OF_10) {
+                return false;
+            }
+            result = (exponent < 0) ? (result / POWERS_OF_10[-exponent]) : (result * POWERS_OF_10[exponent]);
+        }
+        *value = (float)(negative ? -result : result);
+        return true;
+    }
+
     bool TryParseFloatFeatureValue(TStringBuf stringValue, float* value) {
-        if (!TryFromString<float>(stringValue, *value)) {
+        if (!TryParseSimpleFloat(stringValue, value) && !TryFromString<float>(stringValue, *value)) {
             if (IsNanValue(stringValue)) {
                 *value = std::numeric_limits<float>::quiet_NaN();
             } else if (stringValue.length() == 0) {
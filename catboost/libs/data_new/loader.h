@@ -14,6 +14,7 @@
 #include <library/object_factory/object_factory.h>
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/maybe.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/string.h>
 #include <util/generic/vector.h>
@@ -78,7 +79,13 @@ namespace NCB {
 
     struct IRawFeaturesOrderDatasetLoader : public IDatasetLoader {
         virtual EDatasetVisitorType GetVisitorType() const override {
-            return EDatasetVisitorType::RawObjectsOrder;
+            return EDatasetVisitorType::RawFeaturesOrder;
+        }
+
+        void DoIfCompatible(IDatasetVisitor* visitor) override {
+            auto compatibleVisitor = dynamic_cast<IRawFeaturesOrderDataVisitor*>(visitor);
+            CB_ENSURE_INTERNAL(compatibleVisitor, "visitor is incompatible with dataset loader");
+            Do(compatibleVisitor);
         }
 
         // Process all data
@@ -138,7 +145,7 @@ namespace NCB {
      *   Args, FeatureIds and DataMetaInfo are provided as commonly needed
      *   (but not related to async processing)
      *
-     *  Derived classes must implement GetObjectDount, StartBuilder and ProcessBlock
+     *  Derived classes must implement StartBuilder and ProcessBlock
      *  (and might redefine FinalizeBuilder, but common implementation is provided)
      *  and then implement IRawObjectsOrderDatasetLoader like this:
      *
@@ -159,9 +166,10 @@ namespace NCB {
         {}
 
     protected:
+        // data is read in one pass, object count becomes known only at the end
         template <class TReadDataFunc>
         void Do(TReadDataFunc readFunc, IRawObjectsOrderDataVisitor* visitor) {
-            StartBuilder(false, GetObjectCount(), 0, visitor);
+            StartBuilder(false, /*objectCount*/ Nothing(), 0, visitor);
             while (AsyncRowProcessor.ReadBlock(readFunc)) {
                 ProcessBlock(visitor);
             }
@@ -179,7 +187,7 @@ namespace NCB {
                 return false;
 
             StartBuilder(true,
-                         AsyncRowProcessor.GetParseBufferSize(),
+                         (ui32)AsyncRowProcessor.GetParseBufferSize(),
                          AsyncRowProcessor.GetLinesProcessed(),
                          visitor);
             ProcessBlock(visitor);
@@ -189,18 +197,18 @@ namespace NCB {
         }
 
 
-        virtual ui32 GetObjectCount() = 0;
-
         virtual void StartBuilder(bool inBlock,
-                                  ui32 objectCount, ui32 offset,
+                                  TMaybe<ui32> objectCount, // Nothing() if unknown in advance
+                                  ui32 offset,
                                   IRawObjectsOrderDataVisitor* visitor) = 0;
 
         virtual void ProcessBlock(IRawObjectsOrderDataVisitor* visitor) = 0;
 
         virtual void FinalizeBuilder(bool inBlock, IRawObjectsOrderDataVisitor* visitor) {
             if (!inBlock) {
-                SetGroupWeights(Args.GroupWeightsFilePath, GetObjectCount(), visitor);
-                SetPairs(Args.PairsFilePath, GetObjectCount(), visitor);
+                const ui32 objectCount = (ui32)AsyncRowProcessor.GetLinesProcessed();
+                SetGroupWeights(Args.GroupWeightsFilePath, objectCount, visitor);
+                SetPairs(Args.PairsFilePath, objectCount, visitor);
             }
             visitor->Finish();
         }
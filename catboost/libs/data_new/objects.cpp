@@ -134,7 +134,7 @@ void NCB::TCommonObjectsData::PrepareForInitialization(
     const size_t catFeatureCount = (size_t)metaInfo.FeaturesLayout->GetCatFeatureCount();
     if (catFeatureCount) {
         if (!CatFeaturesHashToString) {
-            CatFeaturesHashToString = MakeAtomicShared<TVector<THashMap<ui32, TString>>>();
+            CatFeaturesHashToString = MakeAtomicShared<TVector<TCatFeatureHashToString>>();
         }
         CatFeaturesHashToString->resize(catFeatureCount);
     }
@@ -234,7 +234,7 @@ void NCB::TCommonObjectsData::SaveNonSharedPart(IBinSaver* binSaver) const {
     SaveMulti(binSaver, Order, GroupIds, SubgroupIds, Timestamp);
     AddWithShared(
         binSaver,
-        const_cast<TAtomicSharedPtr<TVector<THashMap<ui32, TString>>>*>(&CatFeaturesHashToString)
+        const_cast<TAtomicSharedPtr<TVector<TCatFeatureHashToString>>*>(&CatFeaturesHashToString)
     );
 }
 
@@ -299,6 +299,9 @@ static bool AreFeaturesValuesEqual(
     const TArrayValuesHolder<T, TType>& lhs,
     const TArrayValuesHolder<T, TType>& rhs
 ) {
+    if (lhs.IsSparse() || rhs.IsSparse()) {
+        return lhs.ExtractValues() == rhs.ExtractValues();
+    }
     auto lhsArrayData = lhs.GetArrayData();
     auto lhsData = GetSubset<T>(*lhsArrayData.GetSrc(), *lhsArrayData.GetSubsetIndexing());
     return Equal<T>(lhsData, rhs.GetArrayData());
@@ -409,7 +412,7 @@ static void CheckDataSizes(
 void NCB::TRawObjectsData::Check(
     ui32 objectCount,
     const TFeaturesLayout& featuresLayout,
-    const TVector<THashMap<ui32, TString>>* catFeaturesHashToString,
+    const TVector<TCatFeatureHashToString>* catFeaturesHashToString,
     NPar::TLocalExecutor* localExecutor
 ) const {
     CheckDataSizes(objectCount, featuresLayout, EFeatureType::Float, FloatFeatures);
@@ -431,13 +434,13 @@ void NCB::TRawObjectsData::Check(
             auto* catFeaturePtr = CatFeatures[catFeatureIdx].Get();
             if (catFeaturePtr) {
                 const auto& hashToStringMap = (*catFeaturesHashToString)[catFeatureIdx];
-                if (hashToStringMap.empty()) {
+                if (hashToStringMap.IsEmpty()) {
                     return;
                 }
                 catFeaturePtr->GetArrayData().ParallelForEach(
                     [&] (ui32 objectIdx, ui32 hashValue) {
                         CB_ENSURE_INTERNAL(
-                            hashToStringMap.contains(hashValue),
+                            hashToStringMap.Has(hashValue),
                             "catFeature #" << catFeatureIdx << ", object #" << objectIdx << ": value "
                             << Hex(hashValue) << " is missing from CatFeaturesHashToString"
                         );
@@ -464,13 +467,7 @@ static void CreateSubsetFeatures(
     for (const auto& feature : src) {
         auto* srcDataPtr = feature.Get();
         if (srcDataPtr) {
-            dst->emplace_back(
-                MakeHolder<TArrayValuesHolder<T, TType>>(
-                    srcDataPtr->GetId(),
-                    *(srcDataPtr->GetArrayData().GetSrc()),
-                    subsetIndexing
-                )
-            );
+            dst->emplace_back(srcDataPtr->CloneWithNewSubsetIndexing(subsetIndexing));
         } else {
             dst->push_back(nullptr);
         }
@@ -557,7 +554,7 @@ TVector<float> NCB::TRawObjectsDataProvider::GetFeatureDataOldFormat(ui32 flatFe
 
     if (featureMetaInfo.Type == EFeatureType::Float) {
         const auto& feature = **GetFloatFeature(featuresLayout.GetInternalFeatureIdx(flatFeatureIdx));
-        feature.GetArrayData().ForEach([&result](ui32 idx, float value) { result[idx] = value; });
+        result = feature.ExtractValues();
     } else {
         const auto& feature = **GetCatFeature(featuresLayout.GetInternalFeatureIdx(flatFeatureIdx));
         feature.GetArrayData().ForEach(
@@ -1005,7 +1002,7 @@ THashMap<ui32, TString> NCB::MergeCatFeaturesHashToString(const NCB::TObjectsDat
             = objectsData.GetCatFeaturesHashToString(catFeatureIdx);
         for (const auto& [hashedCatValue, catValueString] : perFeatureCatFeaturesHashToString) {
             // TODO(kirillovs): remove this cast, needed only for MSVC 14.12 compiler bug
-            result[(ui32)hashedCatValue] = catValueString;
+            result[(ui32)hashedCatValue] = TString(catValueString);
         }
     }
 
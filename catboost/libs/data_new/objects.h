@@ -1,5 +1,6 @@
 #pragma once
 
+#include "cat_feature_hash_to_string.h"
 #include "columns.h"
 #include "features_layout.h"
 #include "meta_info.h"
@@ -68,8 +69,10 @@ namespace NCB {
 
         /* can be empty if there's no cat features
            elements can be empty, it is allowed for some cat features to have hashed representation only
+           (all elements are empty if strings are not needed, see
+            TDataProviderBuilderOptions::StoreCatFeaturesHashToString)
         */
-        TAtomicSharedPtr<TVector<THashMap<ui32, TString>>> CatFeaturesHashToString; // [catFeatureIdx]
+        TAtomicSharedPtr<TVector<TCatFeatureHashToString>> CatFeaturesHashToString; // [catFeatureIdx]
 
     public:
         bool operator==(const TCommonObjectsData& rhs) const;
@@ -147,7 +150,7 @@ namespace NCB {
             return CommonData.Timestamp;
         }
 
-        const THashMap<ui32, TString>& GetCatFeaturesHashToString(ui32 catFeatureIdx) const {
+        const TCatFeatureHashToString& GetCatFeaturesHashToString(ui32 catFeatureIdx) const {
             return (*CommonData.CatFeaturesHashToString)[catFeatureIdx];
         }
 
@@ -198,7 +201,7 @@ namespace NCB {
             const TFeaturesLayout& featuresLayout,
 
             // can be nullptr is there's no categorical features
-            const TVector<THashMap<ui32, TString>>* catFeaturesHashToString,
+            const TVector<TCatFeatureHashToString>* catFeaturesHashToString,
             NPar::TLocalExecutor* localExecutor
         ) const;
     };
@@ -1,5 +1,6 @@
 #include "objects_grouping.h"
 
+#include <catboost/libs/helpers/counter_rng.h>
 #include <catboost/libs/helpers/permutation.h>
 
 #include <util/generic/xrange.h>
@@ -194,10 +195,11 @@ TObjectsGroupingSubset NCB::GetGroupingSubsetFromObjectsSubset(
 }
 
 
+template <class TRng>
 TObjectsGroupingSubset NCB::Shuffle(
     TObjectsGroupingPtr objectsGrouping,
     ui32 permuteBlockSize,
-    TRestorableFastRng64* rand
+    TRng* rand
 ) {
     const ui32 objectCount = objectsGrouping->GetObjectCount();
 
@@ -262,6 +264,9 @@ TObjectsGroupingSubset NCB::Shuffle(
     }
 }
 
+template TObjectsGroupingSubset NCB::Shuffle<TRestorableFastRng64>(TObjectsGroupingPtr, ui32, TRestorableFastRng64*);
+template TObjectsGroupingSubset NCB::Shuffle<TCounterRng64>(TObjectsGroupingPtr, ui32, TCounterRng64*);
+
 
 TVector<TArraySubsetIndexing<ui32>> NCB::Split(
     const TObjectsGrouping& objectsGrouping,
@@ -220,10 +220,12 @@ namespace NCB {
     }
 
 
+    // instantiated for TRestorableFastRng64 and TCounterRng64
+    template <class TRng>
     TObjectsGroupingSubset Shuffle(
         TObjectsGroupingPtr objectsGrouping,
         ui32 permuteBlockSize,
-        TRestorableFastRng64* rand
+        TRng* rand
     );
 
     // returns groups (possibly trivial groups) subsets
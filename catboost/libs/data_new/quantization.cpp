@@ -8,12 +8,14 @@
 #include <catboost/libs/helpers/array_subset.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/resource_constrained_executor.h>
+#include <catboost/libs/helpers/sparse_array.h>
 #include <catboost/libs/logging/logging.h>
 #include <catboost/libs/quantization/utils.h>
 #include <catboost/libs/quantization_schema/quantize.h>
 
 #include <library/grid_creator/binarization.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
 #include <util/generic/maybe.h>
 #include <util/generic/vector.h>
@@ -123,44 +125,19 @@ namespace NCB {
     }
 
 
-    static void CalcBordersAndNanMode(
-        const TFloatValuesHolder& srcFeature,
-        const TFeaturesArraySubsetIndexing* subsetForBuildBorders,
-        const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
+    // calcBorderSet is called with the number of borders to select for non-nan values
+    static void CalcBordersAndNanModeImpl(
+        ui32 featureId, // for error message
+        const NCatboostOptions::TBinarizationOptions& binarizationOptions,
+        bool hasNans,
+        const std::function<THashSet<float>(int)>& calcBorderSet,
         ENanMode* nanMode,
         TVector<float>* borders
     ) {
-        const auto& binarizationOptions = quantizedFeaturesInfo.GetFloatFeatureBinarization();
-
-        Y_VERIFY(binarizationOptions.BorderCount > 0);
-
-        TMaybeOwningConstArraySubset<float, ui32> srcFeatureData = srcFeature.GetArrayData();
-
-        TMaybeOwningConstArraySubset<float, ui32> srcDataForBuildBorders(
-            srcFeatureData.GetSrc(),
-            subsetForBuildBorders
-        );
-
-        // does not contain nans
-        TVector<float> srcFeatureValuesForBuildBorders;
-        srcFeatureValuesForBuildBorders.reserve(srcDataForBuildBorders.Size());
-
-        bool hasNans = false;
-
-        srcDataForBuildBorders.ForEach(
-            [&] (ui32 /*idx*/, float value) {
-                if (IsNan(value)) {
-                    hasNans = true;
-                } else {
-                    srcFeatureValuesForBuildBorders.push_back(value);
-                }
-            }
-        );
-
         CB_ENSURE(
             (binarizationOptions.NanMode != ENanMode::Forbidden) ||
             !hasNans,
-            "Feature #" << srcFeature.GetId() << ": There are nan factors and nan values for "
+            "Feature #" << featureId << ": There are nan factors and nan values for "
             " float features are not allowed. Set nan_mode != Forbidden."
         );
 
@@ -175,11 +152,7 @@ namespace NCB {
         THashSet<float> borderSet;
 
         if (nonNanValuesBorderCount > 0) {
-            borderSet = BestSplit(
-                srcFeatureValuesForBuildBorders,
-                nonNanValuesBorderCount,
-                binarizationOptions.BorderSelectionType
-            );
+            borderSet = calcBorderSet(nonNanValuesBorderCount);
 
             if (borderSet.contains(-0.0f)) { // BestSplit might add negative zeros
                 borderSet.erase(-0.0f);
@@ -200,6 +173,119 @@ namespace NCB {
     }
 
 
+    static void CalcBordersAndNanModeFromValues(
+        ui32 featureId, // for error message
+        const NCatboostOptions::TBinarizationOptions& binarizationOptions,
+        bool hasNans,
+        bool valuesAreSorted,
+        TVector<float>&& values, // does not contain nans
+        ENanMode* nanMode,
+        TVector<float>* borders
+    ) {
+        CalcBordersAndNanModeImpl(
+            featureId,
+            binarizationOptions,
+            hasNans,
+            [&] (int nonNanValuesBorderCount) {
+                return BestSplit(
+                    values,
+                    nonNanValuesBorderCount,
+                    binarizationOptions.BorderSelectionType,
+                    /*nanValueIsInfty*/ false,
+                    valuesAreSorted
+                );
+            },
+            nanMode,
+            borders
+        );
+    }
+
+
+    static void CalcBordersAndNanMode(
+        const TFloatValuesHolder& srcFeature,
+        const TFeaturesArraySubsetIndexing* subsetForBuildBorders,
+        const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
+        ENanMode* nanMode,
+        TVector<float>* borders
+    ) {
+        const auto& binarizationOptions = quantizedFeaturesInfo.GetFloatFeatureBinarization();
+
+        Y_VERIFY(binarizationOptions.BorderCount > 0);
+
+        // does not contain nans
+        TVector<float> srcFeatureValuesForBuildBorders;
+        bool srcFeatureValuesAreSorted = false;
+
+        bool hasNans = false;
+
+        if (srcFeature.IsSparse()) {
+            const TSparseArray<float> srcDataForBuildBorders
+                = srcFeature.GetSparseSrcData().GetSubset(*subsetForBuildBorders);
+
+            srcFeatureValuesForBuildBorders.reserve(srcDataForBuildBorders.GetSize());
+
+            srcDataForBuildBorders.ForEachNonDefault(
+                [&] (ui32 /*idx*/, float value) {
+                    if (IsNan(value)) {
+                        hasNans = true;
+                    } else {
+                        srcFeatureValuesForBuildBorders.push_back(value);
+                    }
+                }
+            );
+            Sort(srcFeatureValuesForBuildBorders.begin(), srcFeatureValuesForBuildBorders.end());
+
+            // sort only non-default values and insert default ones at their place
+            const ui32 defaultValueCount
+                = srcDataForBuildBorders.GetSize() - srcDataForBuildBorders.GetNonDefaultSize();
+            const float defaultValue = srcDataForBuildBorders.GetDefaultValue();
+            if (defaultValueCount && IsNan(defaultValue)) {
+                hasNans = true;
+            } else if (defaultValueCount) {
+                srcFeatureValuesForBuildBorders.insert(
+                    LowerBound(
+                        srcFeatureValuesForBuildBorders.begin(),
+                        srcFeatureValuesForBuildBorders.end(),
+                        defaultValue
+                    ),
+                    defaultValueCount,
+                    defaultValue
+                );
+            }
+            srcFeatureValuesAreSorted = true;
+        } else {
+            TMaybeOwningConstArraySubset<float, ui32> srcFeatureData = srcFeature.GetArrayData();
+
+            TMaybeOwningConstArraySubset<float, ui32> srcDataForBuildBorders(
+                srcFeatureData.GetSrc(),
+                subsetForBuildBorders
+            );
+
+            srcFeatureValuesForBuildBorders.reserve(srcDataForBuildBorders.Size());
+
+            srcDataForBuildBorders.ForEach(
+                [&] (ui32 /*idx*/, float value) {
+                    if (IsNan(value)) {
+                        hasNans = true;
+                    } else {
+                        srcFeatureValuesForBuildBorders.push_back(value);
+                    }
+                }
+            );
+        }
+
+        CalcBordersAndNanModeFromValues(
+            srcFeature.GetId(),
+            binarizationOptions,
+            hasNans,
+            srcFeatureValuesAreSorted,
+            std::move(srcFeatureValuesForBuildBorders),
+            nanMode,
+            borders
+        );
+    }
+
+
     static void ProcessFloatFeature(
         TFloatFeatureIdx floatFeatureIdx,
         const TFloatValuesHolder& srcFeature,
@@ -253,46 +339,62 @@ namespace NCB {
         }
 
         if (!calcBordersAndNanModeOnly && !borders.Empty()) {
-            TMaybeOwningConstArraySubset<float, ui32> srcFeatureData = srcFeature.GetArrayData();
-
             if (!options.CpuCompatibleFormat && !clearSrcData) {
-                // use GPU-only external columns
+                // use GPU-only external columns, they need dense source data
                 *dstQuantizedFeature = MakeHolder<TExternalFloatValuesHolder>(
                     srcFeature.GetId(),
-                    *srcFeatureData.GetSrc(),
+                    srcFeature.IsSparse() ?
+                        TMaybeOwningConstArrayHolder<float>::CreateOwning(
+                            srcFeature.GetSparseSrcData().ExtractValues()
+                        )
+                        : *srcFeature.GetArrayData().GetSrc(),
                     dstSubsetIndexing,
                     quantizedFeaturesInfo
                 );
             } else {
+                const ui32 objectCount = srcFeature.GetSize();
+
                 // TODO(akhropov): support other bitsPerKey. MLTOOLS-2425
                 const ui32 bitsPerKey = 8;
                 TIndexHelper<ui64> indexHelper(bitsPerKey);
                 TVector<ui64> quantizedDataStorage;
-                quantizedDataStorage.yresize(indexHelper.CompressedSize(srcFeatureData.Size()));
+                quantizedDataStorage.yresize(indexHelper.CompressedSize(objectCount));
 
                 TArrayRef<ui8> quantizedData(
                     reinterpret_cast<ui8*>(quantizedDataStorage.data()),
-                    srcFeatureData.Size()
+                    objectCount
                 );
 
                 // it's ok even if it is learn data, for learn nans are checked at CalcBordersAndNanMode stage
                 bool allowNans = (nanMode != ENanMode::Forbidden) ||
                     quantizedFeaturesInfo->GetFloatFeaturesAllowNansInTestOnly();
 
-                Quantize(
-                    srcFeatureData,
-                    allowNans,
-                    nanMode,
-                    srcFeature.GetId(),
-                    borders,
-                    localExecutor,
-                    &quantizedData
-                );
+                if (srcFeature.IsSparse()) {
+                    // quantized data is dense because CPU training reads bins of all objects
+                    Quantize(
+                        srcFeature.GetSparseData(),
+                        allowNans,
+                        nanMode,
+                        srcFeature.GetId(),
+                        borders,
+                        &quantizedData
+                    );
+                } else {
+                    Quantize(
+                        srcFeature.GetArrayData(),
+                        allowNans,
+                        nanMode,
+                        srcFeature.GetId(),
+                        borders,
+                        localExecutor,
+                        &quantizedData
+                    );
+                }
 
                 *dstQuantizedFeature = MakeHolder<TQuantizedFloatValuesHolder>(
                     srcFeature.GetId(),
                     TCompressedArray(
-                        srcFeatureData.Size(),
+                        objectCount,
                         indexHelper.GetBitsPerKey(),
                         TMaybeOwningArrayHolder<ui64>::CreateOwning(std::move(quantizedDataStorage))
                     ),
@@ -348,6 +450,7 @@ namespace NCB {
         const TQuantizationOptions& options,
         bool clearSrcData,
         const TFeaturesArraySubsetIndexing* dstSubsetIndexing,
+        NPar::TLocalExecutor* localExecutor,
         TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
         THolder<IQuantizedCatValuesHolder>* dstQuantizedFeature
     ) {
@@ -376,7 +479,8 @@ namespace NCB {
             catFeaturesPerfectHashHelper.UpdatePerfectHashAndMaybeQuantize(
                 catFeatureIdx,
                 srcFeatureData,
-                !storeAsExternalValuesHolder ? TMaybe<TArrayRef<ui32>*>(&quantizedDataValue) : Nothing()
+                !storeAsExternalValuesHolder ? TMaybe<TArrayRef<ui32>*>(&quantizedDataValue) : Nothing(),
+                localExecutor
             );
         }
 
@@ -544,6 +648,7 @@ namespace NCB {
                                             options,
                                             clearSrcObjectsData,
                                             subsetIndexing.Get(),
+                                            localExecutor,
                                             quantizedFeaturesInfo,
                                             &(data->ObjectsData.CatFeatures[*catFeatureIdx])
                                         );
@@ -711,4 +816,151 @@ namespace NCB {
         return result;
     }
 
+
+    // returns false if borders for this feature are already set
+    static bool PrepareToCalcBordersAndNanMode(
+        TFloatFeatureIdx floatFeatureIdx,
+        TQuantizedFeaturesInfo* quantizedFeaturesInfo,
+        ui32* featureId
+    ) {
+        {
+            TReadGuard readGuard(quantizedFeaturesInfo->GetRWMutex());
+            if (quantizedFeaturesInfo->HasBorders(floatFeatureIdx)) {
+                return false;
+            }
+        }
+
+        Y_VERIFY(quantizedFeaturesInfo->GetFloatFeatureBinarization().BorderCount > 0);
+
+        *featureId = quantizedFeaturesInfo->GetFeaturesLayout()->GetExternalFeatureIdx(
+            *floatFeatureIdx,
+            EFeatureType::Float
+        );
+        return true;
+    }
+
+    static void SetBordersAndNanMode(
+        TFloatFeatureIdx floatFeatureIdx,
+        ui32 featureId,
+        ENanMode nanMode,
+        TVector<float>&& borders,
+        TQuantizedFeaturesInfo* quantizedFeaturesInfo
+    ) {
+        TWriteGuard writeGuard(quantizedFeaturesInfo->GetRWMutex());
+        quantizedFeaturesInfo->SetNanMode(floatFeatureIdx, nanMode);
+        if (borders.empty()) {
+            CATBOOST_DEBUG_LOG << "Float Feature #" << featureId << " is empty" << Endl;
+
+            quantizedFeaturesInfo->GetFeaturesLayout()->IgnoreExternalFeature(featureId);
+        }
+        quantizedFeaturesInfo->SetBorders(floatFeatureIdx, std::move(borders));
+    }
+
+
+    void CalcBordersAndNanModeFromSample(
+        TFloatFeatureIdx floatFeatureIdx,
+        TConstArrayRef<float> sample,
+        bool hasNans,
+        TQuantizedFeaturesInfo* quantizedFeaturesInfo
+    ) {
+        ui32 featureId = 0;
+        if (!PrepareToCalcBordersAndNanMode(floatFeatureIdx, quantizedFeaturesInfo, &featureId)) {
+            return;
+        }
+
+        TVector<float> values;
+        values.reserve(sample.size());
+        for (float value : sample) {
+            if (IsNan(value)) {
+                Y_ASSERT(hasNans);
+            } else {
+                values.push_back(value);
+            }
+        }
+
+        ENanMode nanMode = ENanMode::Forbidden;
+        TVector<float> borders;
+        CalcBordersAndNanModeFromValues(
+            featureId,
+            quantizedFeaturesInfo->GetFloatFeatureBinarization(),
+            hasNans,
+            /*valuesAreSorted*/ false,
+            std::move(values),
+            &nanMode,
+            &borders
+        );
+
+        SetBordersAndNanMode(floatFeatureIdx, featureId, nanMode, std::move(borders), quantizedFeaturesInfo);
+    }
+
+
+    void CalcBordersAndNanModeFromSketch(
+        TFloatFeatureIdx floatFeatureIdx,
+        const NSplitSelection::TQuantileSketch& sketch,
+        TQuantizedFeaturesInfo* quantizedFeaturesInfo
+    ) {
+        ui32 featureId = 0;
+        if (!PrepareToCalcBordersAndNanMode(floatFeatureIdx, quantizedFeaturesInfo, &featureId)) {
+            return;
+        }
+
+        ENanMode nanMode = ENanMode::Forbidden;
+        TVector<float> borders;
+        CalcBordersAndNanModeImpl(
+            featureId,
+            quantizedFeaturesInfo->GetFloatFeatureBinarization(),
+            /*hasNans*/ sketch.GetNanCount() > 0,
+            [&] (int nonNanValuesBorderCount) {
+                return sketch.GetBorders(nonNanValuesBorderCount);
+            },
+            &nanMode,
+            &borders
+        );
+
+        SetBordersAndNanMode(floatFeatureIdx, featureId, nanMode, std::move(borders), quantizedFeaturesInfo);
+    }
+
+
+    void QuantizeCatFeatures(
+        const TQuantizationOptions& options,
+        const TFeaturesArraySubsetIndexing* dstSubsetIndexing,
+        TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
+        NPar::TLocalExecutor* localExecutor,
+        TVector<THolder<THashedCatValuesHolder>>* srcCatFeatures,
+        TVector<THolder<IQuantizedCatValuesHolder>>* dstCatFeatures
+    ) {
+        const auto& featuresLayout = *quantizedFeaturesInfo->GetFeaturesLayout();
+
+        dstCatFeatures->clear();
+        dstCatFeatures->resize(featuresLayout.GetCatFeatureCount());
+
+        TVector<TCatFeatureIdx> catFeatureIndices;
+        featuresLayout.IterateOverAvailableFeatures<EFeatureType::Categorical>(
+            [&] (TCatFeatureIdx catFeatureIdx) {
+                catFeatureIndices.push_back(catFeatureIdx);
+            }
+        );
+
+        localExecutor->ExecRangeWithThrow(
+            [&] (int i) {
+                const auto catFeatureIdx = catFeatureIndices[i];
+                auto& srcCatFeatureHolder = (*srcCatFeatures)[*catFeatureIdx];
+                ProcessCatFeature(
+                    catFeatureIdx,
+                    *srcCatFeatureHolder,
+                    options,
+                    /*clearSrcData*/ true,
+                    dstSubsetIndexing,
+                    localExecutor,
+                    quantizedFeaturesInfo,
+                    &((*dstCatFeatures)[*catFeatureIdx])
+                );
+                srcCatFeatureHolder.Destroy();
+            },
+            0,
+            SafeIntegerCast<int>(catFeatureIndices.size()),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+    }
+
 }
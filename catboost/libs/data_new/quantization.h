@@ -1,12 +1,18 @@
 #pragma once
 
+#include "columns.h"
 #include "data_provider.h"
+#include "feature_index.h"
 #include "quantized_features_info.h"
 
 #include <catboost/libs/helpers/restorable_rng.h>
 
+#include <library/grid_creator/quantile_sketch.h>
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
+#include <util/generic/ptr.h>
+#include <util/generic/vector.h>
 #include <util/generic/ylimits.h>
 
 
@@ -19,6 +25,11 @@ namespace NCB {
         ui32 MaxSubsetSizeForSlowBuildBordersAlgorithms = 200000;
         bool AllowWriteFiles = true;
 
+        /* streaming quantization keeps only a sample of float features values for borders calculation,
+         * it is the same as in non-streaming quantization, this option can only limit it further
+         */
+        ui32 MaxSubsetSizeForStreamingBuildBorders = Max<ui32>();
+
         // TODO(akhropov): remove after checking global tests consistency
         bool CpuCompatibilityShuffleOverFullData = true;
     };
@@ -59,4 +70,39 @@ namespace NCB {
         NPar::TLocalExecutor* localExecutor
     );
 
+
+    /* Functions for streaming quantization, when float features are quantized right when they are loaded
+     * (see TDataProviderBuilderOptions::StreamingQuantizedFeaturesInfo)
+     */
+
+    /* sample is a subset of feature values (can contain NaNs), hasNans is for all feature values
+     * because NaNs can be absent in the sample
+     * does nothing if borders for this feature are already set in quantizedFeaturesInfo
+     */
+    void CalcBordersAndNanModeFromSample(
+        TFloatFeatureIdx floatFeatureIdx,
+        TConstArrayRef<float> sample,
+        bool hasNans,
+        TQuantizedFeaturesInfo* quantizedFeaturesInfo
+    );
+
+    /* sketch summarizes all feature values, used for EBorderSelectionType::QuantileSketch
+     * does nothing if borders for this feature are already set in quantizedFeaturesInfo
+     */
+    void CalcBordersAndNanModeFromSketch(
+        TFloatFeatureIdx floatFeatureIdx,
+        const NSplitSelection::TQuantileSketch& sketch,
+        TQuantizedFeaturesInfo* quantizedFeaturesInfo
+    );
+
+    // srcCatFeatures data is released after processing
+    void QuantizeCatFeatures(
+        const TQuantizationOptions& options,
+        const TFeaturesArraySubsetIndexing* dstSubsetIndexing,
+        TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
+        NPar::TLocalExecutor* localExecutor,
+        TVector<THolder<THashedCatValuesHolder>>* srcCatFeatures, // [catFeatureIdx]
+        TVector<THolder<IQuantizedCatValuesHolder>>* dstCatFeatures // [catFeatureIdx]
+    );
+
 }
@@ -74,9 +74,15 @@ namespace NCB {
         if (FloatFeaturesBinarization.NanMode == ENanMode::Forbidden) {
             return ENanMode::Forbidden;
         }
-        TMaybeOwningConstArraySubset<float, ui32> arrayData = feature.GetArrayData();
-
-        bool hasNans = arrayData.Find([] (size_t /*idx*/, float value) { return IsNan(value); });
+        bool hasNans = false;
+        if (feature.IsSparse()) {
+            const auto sparseData = feature.GetSparseData();
+            hasNans = (sparseData.GetNonDefaultSize() < sparseData.GetSize()) && IsNan(sparseData.GetDefaultValue());
+            sparseData.ForEachNonDefault([&] (ui32 /*idx*/, float value) { hasNans |= IsNan(value); });
+        } else {
+            TMaybeOwningConstArraySubset<float, ui32> arrayData = feature.GetArrayData();
+            hasNans = arrayData.Find([] (size_t /*idx*/, float value) { return IsNan(value); });
+        }
         if (hasNans) {
             return FloatFeaturesBinarization.NanMode;
         }
@@ -122,11 +128,8 @@ namespace NCB {
                 const auto& catFeaturePerfectHash = GetCategoricalFeaturesPerfectHash(
                     TCatFeatureIdx((ui32)catFeatureIdx)
                 );
-                auto& perFeatureResult = result[catFeatureIdx];
-                perFeatureResult.yresize(catFeaturePerfectHash.size());
-                for (const auto [hashedCatValue, perfectHash] : catFeaturePerfectHash) {
-                    perFeatureResult[perfectHash] = hashedCatValue;
-                }
+                const auto hashedCatValues = catFeaturePerfectHash.GetHashedValues();
+                result[catFeatureIdx].assign(hashedCatValues.begin(), hashedCatValues.end());
             },
             0,
             SafeIntegerCast<int>(featuresLayout.GetCatFeatureCount()),
@@ -128,13 +128,15 @@ namespace NCB {
             return CatFeaturesPerfectHash.GetUniqueValuesCounts(catFeatureIdx);
         }
 
-        const TMap<ui32, ui32>& GetCategoricalFeaturesPerfectHash(const TCatFeatureIdx catFeatureIdx) const {
+        const TCatFeaturePerfectHashMap& GetCategoricalFeaturesPerfectHash(
+            const TCatFeatureIdx catFeatureIdx
+        ) const {
             CheckCorrectPerTypeFeatureIdx(catFeatureIdx);
             return CatFeaturesPerfectHash.GetFeaturePerfectHash(catFeatureIdx);
         };
 
         void UpdateCategoricalFeaturesPerfectHash(const TCatFeatureIdx catFeatureIdx,
-                                                  TMap<ui32, ui32>&& perfectHash) {
+                                                  TCatFeaturePerfectHashMap&& perfectHash) {
             CheckCorrectPerTypeFeatureIdx(catFeatureIdx);
             CatFeaturesPerfectHash.UpdateFeaturePerfectHash(catFeatureIdx, std::move(perfectHash));
         };
@@ -0,0 +1,101 @@
+#include <catboost/libs/data_new/cat_feature_hash_to_string.h>
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <library/binsaver/util_stream_io.h>
+
+#include <util/generic/hash.h>
+#include <util/generic/string.h>
+#include <util/generic/xrange.h>
+#include <util/stream/buffer.h>
+#include <util/string/cast.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(TCatFeatureHashToString) {
+    Y_UNIT_TEST(InsertAndFind) {
+        TCatFeatureHashToString hashToString;
+        UNIT_ASSERT(hashToString.IsEmpty());
+
+        {
+            TString value = "a";
+            UNIT_ASSERT(hashToString.Insert(10, value));
+            value = "b"; // must be copied to the map
+        }
+        UNIT_ASSERT(hashToString.Insert(20, "bb"));
+        UNIT_ASSERT(!hashToString.Insert(10, "c"));
+
+        UNIT_ASSERT_VALUES_EQUAL(hashToString.GetSize(), 2);
+        UNIT_ASSERT(hashToString.Has(20));
+        UNIT_ASSERT(!hashToString.Has(30));
+        UNIT_ASSERT_VALUES_EQUAL(hashToString.At(10), "a");
+        UNIT_ASSERT_VALUES_EQUAL(*hashToString.Find(20), "bb");
+        UNIT_ASSERT(!hashToString.Find(30));
+        UNIT_ASSERT_EXCEPTION(hashToString.At(30), TCatBoostException);
+
+        // enough strings to use several pool chunks
+        THashMap<ui32, TString> expectedHashToString;
+        for (auto i : xrange<ui32>(100000)) {
+            expectedHashToString.emplace(i, ToString(i));
+        }
+        TCatFeatureHashToString bigHashToString;
+        for (const auto& [hashedValue, value] : expectedHashToString) {
+            bigHashToString.Insert(hashedValue, value);
+        }
+        UNIT_ASSERT_EQUAL(bigHashToString, TCatFeatureHashToString(expectedHashToString));
+        UNIT_ASSERT_EQUAL(TCatFeatureHashToString(bigHashToString), bigHashToString);
+    }
+
+    Y_UNIT_TEST(Merge) {
+        const THashMap<ui32, TString> part1 = {{1, "1"}, {2, "2"}, {3, "3"}};
+        const THashMap<ui32, TString> part2 = {{3, "3"}, {4, "4"}};
+        const THashMap<ui32, TString> part3 = {{5, "5"}};
+
+        TCatFeatureHashToString hashToString;
+        for (const auto& part : {part1, part2, part3}) {
+            TCatFeatureHashToString partHashToString(part);
+            hashToString.Merge(std::move(partHashToString));
+            UNIT_ASSERT(partHashToString.IsEmpty());
+        }
+        UNIT_ASSERT(hashToString.Insert(6, "6"));
+
+        const THashMap<ui32, TString> expectedHashToString = {
+            {1, "1"}, {2, "2"}, {3, "3"}, {4, "4"}, {5, "5"}, {6, "6"}
+        };
+        UNIT_ASSERT_EQUAL(hashToString, TCatFeatureHashToString(expectedHashToString));
+    }
+
+    Y_UNIT_TEST(MoveAndReuse) {
+        TCatFeatureHashToString hashToString(THashMap<ui32, TString>{{1, "a"}, {2, "b"}});
+        TCatFeatureHashToString movedHashToString(std::move(hashToString));
+        UNIT_ASSERT(hashToString.IsEmpty());
+        UNIT_ASSERT(hashToString.Insert(3, "c"));
+
+        hashToString = std::move(movedHashToString);
+        hashToString.Clear();
+        UNIT_ASSERT(hashToString.Insert(4, "d"));
+        UNIT_ASSERT_EQUAL(hashToString, TCatFeatureHashToString(THashMap<ui32, TString>{{4, "d"}}));
+    }
+
+    Y_UNIT_TEST(Serialization) {
+        TCatFeatureHashToString hashToString(THashMap<ui32, TString>{{1, "a"}, {2, ""}, {7, "long string"}});
+
+        TBuffer buffer;
+        {
+            TBufferOutput out(buffer);
+            SerializeToStream(out, hashToString);
+        }
+
+        TCatFeatureHashToString loadedHashToString;
+        loadedHashToString.Insert(5, "will be cleared");
+        {
+            TBufferInput in(buffer);
+            SerializeFromStream(in, loadedHashToString);
+        }
+        UNIT_ASSERT_EQUAL(loadedHashToString, hashToString);
+    }
+}
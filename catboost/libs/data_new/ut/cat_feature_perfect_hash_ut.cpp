@@ -0,0 +1,148 @@
+#include <catboost/libs/data_new/cat_feature_perfect_hash.h>
+#include <catboost/libs/data_new/cat_feature_perfect_hash_helper.h>
+#include <catboost/libs/data_new/quantized_features_info.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/map.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(TCatFeaturePerfectHashMap) {
+    Y_UNIT_TEST(InsertAndFind) {
+        TCatFeaturePerfectHashMap perfectHashMap;
+        UNIT_ASSERT_VALUES_EQUAL(perfectHashMap.GetSize(), 0);
+        UNIT_ASSERT(!perfectHashMap.Find(0));
+
+        // enough values to rehash several times
+        TFastRng<ui32> rng(0);
+        TVector<ui32> hashedValues;
+        for (auto i : xrange(1000)) {
+            Y_UNUSED(i);
+            hashedValues.push_back(rng.GenRand());
+        }
+        for (auto bin : xrange(hashedValues.size())) {
+            UNIT_ASSERT_VALUES_EQUAL(perfectHashMap.Insert(hashedValues[bin]), bin);
+            UNIT_ASSERT_VALUES_EQUAL(perfectHashMap.Insert(hashedValues[bin]), bin);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(perfectHashMap.GetSize(), hashedValues.size());
+        UNIT_ASSERT_EQUAL(perfectHashMap.GetHashedValues(), TConstArrayRef<ui32>(hashedValues));
+
+        TMap<ui32, ui32> perfectHash;
+        for (auto bin : xrange(hashedValues.size())) {
+            UNIT_ASSERT_VALUES_EQUAL(*perfectHashMap.Find(hashedValues[bin]), bin);
+            perfectHash.emplace(hashedValues[bin], bin);
+        }
+        UNIT_ASSERT_EQUAL(TCatFeaturePerfectHashMap(perfectHash), perfectHashMap);
+    }
+
+    Y_UNIT_TEST(FreeRamAndLoad) {
+        TFeaturesLayout featuresLayout(ui32(2), TVector<ui32>{0, 1}, TVector<TString>{});
+        TQuantizedFeaturesInfo quantizedFeaturesInfo(
+            featuresLayout,
+            TConstArrayRef<ui32>(),
+            NCatboostOptions::TBinarizationOptions()
+        );
+
+        const TVector<TMap<ui32, ui32>> perfectHashes = {
+            {{12, 0}, {7, 1}, {100, 2}},
+            {{3, 1}, {5, 0}}
+        };
+        for (auto i : xrange(perfectHashes.size())) {
+            quantizedFeaturesInfo.UpdateCategoricalFeaturesPerfectHash(
+                TCatFeatureIdx(i),
+                TCatFeaturePerfectHashMap(perfectHashes[i])
+            );
+        }
+
+        for (auto iteration : xrange(2)) {
+            Y_UNUSED(iteration);
+            quantizedFeaturesInfo.UnloadCatFeaturePerfectHashFromRamIfPossible();
+            for (auto i : xrange(perfectHashes.size())) {
+                const auto& perfectHashMap = quantizedFeaturesInfo.GetCategoricalFeaturesPerfectHash(
+                    TCatFeatureIdx(i)
+                );
+                UNIT_ASSERT_EQUAL(perfectHashMap, TCatFeaturePerfectHashMap(perfectHashes[i]));
+                for (const auto& [hashedValue, bin] : perfectHashes[i]) {
+                    UNIT_ASSERT_VALUES_EQUAL(*perfectHashMap.Find(hashedValue), bin);
+                }
+                UNIT_ASSERT(!perfectHashMap.Find(1));
+            }
+        }
+
+        // update data loaded from the storage file
+        TCatFeaturePerfectHashMap updatedPerfectHashMap = quantizedFeaturesInfo.GetCategoricalFeaturesPerfectHash(
+            TCatFeatureIdx(1)
+        );
+        UNIT_ASSERT_VALUES_EQUAL(updatedPerfectHashMap.Insert(4), 2);
+        quantizedFeaturesInfo.UpdateCategoricalFeaturesPerfectHash(
+            TCatFeatureIdx(1),
+            TCatFeaturePerfectHashMap(updatedPerfectHashMap)
+        );
+        quantizedFeaturesInfo.UnloadCatFeaturePerfectHashFromRamIfPossible();
+        UNIT_ASSERT_EQUAL(
+            quantizedFeaturesInfo.GetCategoricalFeaturesPerfectHash(TCatFeatureIdx(1)),
+            updatedPerfectHashMap
+        );
+        UNIT_ASSERT_VALUES_EQUAL(quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(1)).OnAll, 3);
+    }
+
+    Y_UNIT_TEST(ParallelUpdateIsSameAsSequential) {
+        TFastRng<ui32> rng(0);
+        TVector<ui32> hashedCatValues;
+        for (auto i : xrange(300000)) {
+            Y_UNUSED(i);
+            hashedCatValues.push_back(rng.Uniform(50000));
+        }
+        const auto hashedCatValuesHolder = TMaybeOwningConstArrayHolder<ui32>::CreateNonOwning(hashedCatValues);
+        const TArraySubsetIndexing<ui32> subsetIndexing(TFullSubset<ui32>(hashedCatValues.size()));
+
+        TVector<TVector<ui32>> bins; // [threadCount]
+        TVector<TQuantizedFeaturesInfoPtr> quantizedFeaturesInfos; // [threadCount]
+        for (auto threadCount : {0, 3}) {
+            NPar::TLocalExecutor localExecutor;
+            localExecutor.RunAdditionalThreads(threadCount);
+
+            TFeaturesLayout featuresLayout(ui32(1), TVector<ui32>{0}, TVector<TString>{});
+            quantizedFeaturesInfos.push_back(
+                MakeIntrusive<TQuantizedFeaturesInfo>(
+                    featuresLayout,
+                    TConstArrayRef<ui32>(),
+                    NCatboostOptions::TBinarizationOptions()
+                )
+            );
+
+            bins.emplace_back(hashedCatValues.size());
+            TArrayRef<ui32> dstBins = bins.back();
+
+            TCatFeaturesPerfectHashHelper catFeaturesPerfectHashHelper(quantizedFeaturesInfos.back());
+            catFeaturesPerfectHashHelper.UpdatePerfectHashAndMaybeQuantize(
+                TCatFeatureIdx(0),
+                TMaybeOwningConstArraySubset<ui32, ui32>(&hashedCatValuesHolder, &subsetIndexing),
+                &dstBins,
+                &localExecutor
+            );
+        }
+
+        UNIT_ASSERT_EQUAL(bins[0], bins[1]);
+        UNIT_ASSERT_EQUAL(
+            quantizedFeaturesInfos[0]->GetCategoricalFeaturesPerfectHash(TCatFeatureIdx(0)),
+            quantizedFeaturesInfos[1]->GetCategoricalFeaturesPerfectHash(TCatFeatureIdx(0))
+        );
+
+        // bins are assigned in the order of first occurrence
+        UNIT_ASSERT_VALUES_EQUAL(bins[0][0], 0);
+        ui32 maxBin = 0;
+        for (auto bin : bins[0]) {
+            UNIT_ASSERT(bin <= maxBin + 1);
+            maxBin = Max(maxBin, bin);
+        }
+    }
+}
@@ -37,6 +37,33 @@ Y_UNIT_TEST_SUITE(Columns) {
         UNIT_ASSERT(!IsIn(visitedIndices, false));
     }
 
+    Y_UNIT_TEST(TSparseFloatValuesHolder) {
+        TVector<float> v = {0.0f, 0.0f, 12.2f, 0.0f, 0.0f, 15.5f, 0.0f, 0.0f, 0.0f, 19.9f};
+
+        NCB::TArraySubsetIndexing<ui32> vSubsetIndexing( NCB::TFullSubset<ui32>{(ui32)v.size()} );
+
+        TFloatValuesHolder floatValuesHolder(
+            10,
+            MakeAtomicShared<const TSparseArray<float>>(TSparseArray<float>::FromDense(v, 0.0f)),
+            &vSubsetIndexing
+        );
+
+        UNIT_ASSERT(floatValuesHolder.IsSparse());
+        UNIT_ASSERT_EQUAL(floatValuesHolder.GetSize(), v.size());
+        UNIT_ASSERT_EQUAL(floatValuesHolder.GetSparseData().GetNonDefaultSize(), 3);
+
+        TFeaturesArraySubsetIndexing subsetIndexing( TIndexedSubset<ui32>{9, 0, 5, 1} );
+        auto subsetHolder = floatValuesHolder.CloneWithNewSubsetIndexing(&subsetIndexing);
+
+        TVector<float> expectedSubset = {19.9f, 0.0f, 15.5f, 0.0f};
+        UNIT_ASSERT(subsetHolder->IsSparse());
+        UNIT_ASSERT_EQUAL(subsetHolder->GetSparseData().ExtractValues(), expectedSubset);
+        UNIT_ASSERT_EQUAL(subsetHolder->ExtractValues(), expectedSubset);
+
+        // no dense copy of sparse data is made implicitly
+        UNIT_ASSERT_EXCEPTION(subsetHolder->GetArrayData(), TCatBoostException);
+    }
+
     Y_UNIT_TEST(TQuantizedFloatValuesHolder) {
         TVector<ui8> src = {
             0xDE, 0xAD, 0xBE, 0xEF, 0xAB, 0xCD, 0xEF, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07
@@ -134,7 +134,7 @@ static void CreateQuantizedObjectsDataProviderTestData(
         auto catFeatureIdx = TCatFeatureIdx(i);
         quantizedObjectsData.QuantizedFeaturesInfo->UpdateCategoricalFeaturesPerfectHash(
             catFeatureIdx,
-            std::move(expectedPerfectHash[i])
+            TCatFeaturePerfectHashMap(expectedPerfectHash[i])
         );
     }
 
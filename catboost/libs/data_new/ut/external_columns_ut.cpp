@@ -95,12 +95,16 @@ Y_UNIT_TEST_SUITE(ExternalColumns) {
 
         const ui32 featureId = 0;
 
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(2);
+
         TCatFeaturesPerfectHashHelper catFeaturesPerfectHashHelper(quantizedFeaturesInfo);
 
         catFeaturesPerfectHashHelper.UpdatePerfectHashAndMaybeQuantize(
             TCatFeatureIdx(featureId),
             arraySubset,
-            Nothing()
+            Nothing(),
+            &localExecutor
         );
 
         TExternalCatValuesHolder externalCatValuesHolder(
@@ -110,9 +114,6 @@ Y_UNIT_TEST_SUITE(ExternalColumns) {
             quantizedFeaturesInfo
         );
 
-        NPar::TLocalExecutor localExecutor;
-        localExecutor.RunAdditionalThreads(2);
-
         TMaybeOwningArrayHolder<ui32> bins = externalCatValuesHolder.ExtractValues(&localExecutor);
 
         TVector<ui32> expectedBins = {0, 1, 2, 3, 1, 2, 4};
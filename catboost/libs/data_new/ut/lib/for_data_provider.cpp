@@ -141,14 +141,14 @@ namespace NCB {
                 // check that hashes for expected data are present in objectsData.GetCatFeaturesHashToString
                 const auto& catFeaturesHashToString = objectsData.GetCatFeaturesHashToString(catFeatureIdx);
                 for (const auto& [key, value] : expectedCatFeaturesHashToString[catFeatureIdx]) {
-                    auto it = catFeaturesHashToString.find(key);
-                    UNIT_ASSERT(it != catFeaturesHashToString.end());
-                    UNIT_ASSERT_VALUES_EQUAL(value, it->second);
+                    auto catFeatureString = catFeaturesHashToString.Find(key);
+                    UNIT_ASSERT(catFeatureString);
+                    UNIT_ASSERT_VALUES_EQUAL(value, *catFeatureString);
                 }
             } else {
-                UNIT_ASSERT_VALUES_EQUAL(
+                UNIT_ASSERT_EQUAL(
                     objectsData.GetCatFeaturesHashToString(catFeatureIdx),
-                    expectedCatFeaturesHashToString[catFeatureIdx]
+                    TCatFeatureHashToString(expectedCatFeaturesHashToString[catFeatureIdx])
                 );
             }
         }
@@ -0,0 +1,81 @@
+#include <catboost/libs/data_new/load_data.h>
+
+#include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/data_types/groupid.h>
+#include <catboost/libs/helpers/array_subset.h>
+
+#include <util/folder/path.h>
+#include <util/folder/tempdir.h>
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/stream/file.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+template <class T>
+static void SaveColumn(const TString& poolDir, ui32 columnIdx, TConstArrayRef<T> values) {
+    TFileOutput out(TFsPath(poolDir) / ToString(columnIdx));
+    out.Write(values.data(), values.size() * sizeof(T));
+}
+
+
+Y_UNIT_TEST_SUITE(LoadDataFromColumnar) {
+    Y_UNIT_TEST(ReadDataset) {
+        TTempDir tempDir;
+        const TString poolDir = TFsPath(tempDir.Name()) / "pool";
+        TFsPath(poolDir).MkDir();
+
+        const TVector<float> target = {0.0f, 1.0f, 1.0f, 0.0f};
+        const TVector<float> float0 = {0.1f, 0.2f, 0.3f, 0.4f};
+        const TVector<ui32> cat0 = {11, 22, 11, 33};
+        const TVector<float> float1 = {1.5f, 2.5f, 3.5f, 4.5f};
+        const TVector<TGroupId> groupIds = {7, 7, 9, 9};
+        const TVector<float> weights = {1.0f, 0.5f, 2.0f, 1.0f};
+
+        SaveColumn<float>(poolDir, 0, target);
+        SaveColumn<float>(poolDir, 1, float0);
+        SaveColumn<ui32>(poolDir, 2, cat0);
+        SaveColumn<float>(poolDir, 3, float1);
+        SaveColumn<TGroupId>(poolDir, 5, groupIds);
+        SaveColumn<float>(poolDir, 6, weights);
+
+        const TString cdPath = TFsPath(tempDir.Name()) / "pool.cd";
+        TFileOutput(cdPath).Write("0\tLabel\n1\tNum\n2\tCateg\n3\tNum\n4\tAuxiliary\n5\tGroupId\n6\tWeight\n");
+
+        NCatboostOptions::TDsvPoolFormatParams dsvPoolFormatParams;
+        dsvPoolFormatParams.CdFilePath = TPathWithScheme(cdPath);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        TDataProviderPtr dataProvider = ReadDataset(
+            TPathWithScheme("columnar://" + poolDir),
+            TPathWithScheme(),
+            TPathWithScheme(),
+            dsvPoolFormatParams,
+            /*ignoredFeatures*/ {2},
+            EObjectsOrder::Undefined,
+            &localExecutor
+        );
+
+        UNIT_ASSERT_VALUES_EQUAL(dataProvider->GetObjectCount(), 4);
+
+        const auto& rawObjectsData = dynamic_cast<const TRawObjectsDataProvider&>(*dataProvider->ObjectsData);
+        UNIT_ASSERT(Equal<float>(float0, (*rawObjectsData.GetFloatFeature(0))->GetArrayData()));
+        UNIT_ASSERT(Equal<ui32>(cat0, (*rawObjectsData.GetCatFeature(0))->GetArrayData()));
+        UNIT_ASSERT(!rawObjectsData.GetFloatFeature(1));
+        UNIT_ASSERT_EQUAL(*rawObjectsData.GetGroupIds(), TConstArrayRef<TGroupId>(groupIds));
+
+        const TVector<TString> expectedTarget = {"0", "1", "1", "0"};
+        UNIT_ASSERT_EQUAL(*dataProvider->RawTargetData.GetTarget(), TConstArrayRef<TString>(expectedTarget));
+        UNIT_ASSERT_EQUAL(
+            dataProvider->RawTargetData.GetWeights().GetNonTrivialData(),
+            TConstArrayRef<float>(weights)
+        );
+    }
+}
@@ -0,0 +1,46 @@
+#include <catboost/libs/data_new/loader.h>
+
+#include <util/generic/strbuf.h>
+#include <util/string/cast.h>
+
+#include <library/unittest/registar.h>
+
+#include <cmath>
+#include <cstring>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(TryParseFloatFeatureValue) {
+    Y_UNIT_TEST(SameAsGenericParsing) {
+        const TStringBuf values[] = {
+            "0", "-0", "0.0", "-0.000", "1", "-1", "0.1", "0.3", "3.14159", "-2.5e-3", "1e10", "1E+10",
+            "7e-22", "8.5e22", "123456789012345", "1234567890123456789", "0.000000000000000000000000001",
+            "1e-45", "3.4028235e38", "1e39", "16777217", "0.30000000000000004", "007.25", "1e05",
+            "+1.5", ".5", "5.", " 2", "0x10", "1e", "1e-", "1e1000"
+        };
+        for (auto value : values) {
+            float expected;
+            if (TryFromString<float>(value, expected)) {
+                if (expected == 0.0f) {
+                    expected = 0.0f;
+                }
+                float parsed;
+                UNIT_ASSERT_C(TryParseFloatFeatureValue(value, &parsed), value);
+                UNIT_ASSERT_C(!std::memcmp(&parsed, &expected, sizeof(float)), value);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(NanAndEmpty) {
+        for (TStringBuf value : {"", "nan", "NaN", "NA", "na"}) {
+            float parsed = 0.0f;
+            UNIT_ASSERT_C(TryParseFloatFeatureValue(value, &parsed), value);
+            UNIT_ASSERT_C(std::isnan(parsed), value);
+        }
+        float parsed;
+        UNIT_ASSERT(!TryParseFloatFeatureValue("1.5abc", &parsed));
+        UNIT_ASSERT(!TryParseFloatFeatureValue("abc", &parsed));
+    }
+}
@@ -276,8 +276,9 @@ Y_UNIT_TEST_SUITE(TRawObjectsData) {
             if (useFeatureTypes.second) {
                 ui32 catFeaturesIndicesStart = featureId;
 
-                commonDataCopy.CatFeaturesHashToString = MakeAtomicShared<TVector<THashMap<ui32, TString>>>(
-                    catFeaturesHashToString
+                commonDataCopy.CatFeaturesHashToString = MakeAtomicShared<TVector<TCatFeatureHashToString>>(
+                    catFeaturesHashToString.begin(),
+                    catFeaturesHashToString.end()
                 );
                 InitFeatures(srcCatFeatures, *commonData.SubsetIndexing, &featureId, &data.CatFeatures);
 
@@ -748,6 +749,9 @@ Y_UNIT_TEST_SUITE(TQuantizedObjectsData) {
                 }
 
                 if (useFeatureTypes.second) {
+                    NPar::TLocalExecutor localExecutor;
+                    localExecutor.RunAdditionalThreads(2);
+
                     TCatFeaturesPerfectHashHelper catFeaturesPerfectHashHelper(data.QuantizedFeaturesInfo);
 
                     for (auto catFeatureIdx : xrange(srcCatFeatures.size())) {
@@ -766,7 +770,8 @@ Y_UNIT_TEST_SUITE(TQuantizedObjectsData) {
                                 &hashedCatValues,
                                 &fullSubsetForUpdatingPerfectHash
                             ),
-                            Nothing()
+                            Nothing(),
+                            &localExecutor
                         );
 
                         ui32 bitsPerKey =
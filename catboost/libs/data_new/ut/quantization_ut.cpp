@@ -418,7 +418,10 @@ Y_UNIT_TEST_SUITE(Quantization) {
             }
 
             srcData.CommonObjectsData.CatFeaturesHashToString
-                = MakeAtomicShared<TVector<THashMap<ui32, TString>>>(catFeaturesHashToString);
+                = MakeAtomicShared<TVector<TCatFeatureHashToString>>(
+                    catFeaturesHashToString.begin(),
+                    catFeaturesHashToString.end()
+                );
 
 
             NCatboostOptions::TBinarizationOptions binarizationOptions(
@@ -458,7 +461,7 @@ Y_UNIT_TEST_SUITE(Quantization) {
                 auto catFeatureIdx = TCatFeatureIdx(i);
                 expectedData.Objects.QuantizedFeaturesInfo->UpdateCategoricalFeaturesPerfectHash(
                     catFeatureIdx,
-                    std::move(expectedPerfectHash[i])
+                    TCatFeaturePerfectHashMap(expectedPerfectHash[i])
                 );
             }
 
@@ -541,7 +544,10 @@ Y_UNIT_TEST_SUITE(Quantization) {
             }
 
             srcData.CommonObjectsData.CatFeaturesHashToString
-                = MakeAtomicShared<TVector<THashMap<ui32, TString>>>(catFeaturesHashToString);
+                = MakeAtomicShared<TVector<TCatFeatureHashToString>>(
+                    catFeaturesHashToString.begin(),
+                    catFeaturesHashToString.end()
+                );
 
 
             NCatboostOptions::TBinarizationOptions binarizationOptions(
@@ -601,7 +607,7 @@ Y_UNIT_TEST_SUITE(Quantization) {
                 auto catFeatureIdx = TCatFeatureIdx(i);
                 expectedData.Objects.QuantizedFeaturesInfo->UpdateCategoricalFeaturesPerfectHash(
                     catFeatureIdx,
-                    std::move(expectedPerfectHash[i])
+                    TCatFeaturePerfectHashMap(expectedPerfectHash[i])
                 );
             }
 
@@ -683,7 +689,10 @@ Y_UNIT_TEST_SUITE(Quantization) {
             }
 
             srcData.CommonObjectsData.CatFeaturesHashToString
-                = MakeAtomicShared<TVector<THashMap<ui32, TString>>>(catFeaturesHashToString);
+                = MakeAtomicShared<TVector<TCatFeatureHashToString>>(
+                    catFeaturesHashToString.begin(),
+                    catFeaturesHashToString.end()
+                );
 
 
             NCatboostOptions::TBinarizationOptions binarizationOptions(
@@ -726,7 +735,7 @@ Y_UNIT_TEST_SUITE(Quantization) {
                 auto catFeatureIdx = TCatFeatureIdx(i);
                 testCase.QuantizedFeaturesInfo->UpdateCategoricalFeaturesPerfectHash(
                     catFeatureIdx,
-                    TMap<ui32, ui32>(srcPerfectHash[i])
+                    TCatFeaturePerfectHashMap(srcPerfectHash[i])
                 );
             }
 
@@ -768,11 +777,11 @@ Y_UNIT_TEST_SUITE(Quantization) {
                 auto catFeatureIdx = TCatFeatureIdx(i);
                 expectedData.Objects.QuantizedFeaturesInfo->UpdateCategoricalFeaturesPerfectHash(
                     catFeatureIdx,
-                    TMap<ui32, ui32>(srcPerfectHash[i])
+                    TCatFeaturePerfectHashMap(srcPerfectHash[i])
                 );
                 expectedData.Objects.QuantizedFeaturesInfo->UpdateCategoricalFeaturesPerfectHash(
                     catFeatureIdx,
-                    std::move(expectedPerfectHash[i])
+                    TCatFeaturePerfectHashMap(expectedPerfectHash[i])
                 );
             }
 
@@ -0,0 +1,179 @@
+#include <catboost/libs/data_new/ut/lib/for_loader.h>
+
+#include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/data_new/load_data.h>
+#include <catboost/libs/data_new/quantization.h>
+
+#include <util/generic/xrange.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+using namespace NCB::NDataNewUT;
+
+
+Y_UNIT_TEST_SUITE(ReadAndQuantizeDataset) {
+    static TSrcData GetSrcData() {
+        TSrcData srcData;
+        srcData.CdFileData = AsStringBuf("0\tTarget\n" "3\tCateg\n");
+        srcData.DsvFileData = AsStringBuf(
+            "0\t0.1\t0.2\ta\n"
+            "1\t0.97\tnan\tb\n"
+            "0\t0.13\t0.22\ta\n"
+            "1\t0.5\t0.0\tc\n"
+            "0\t0.3\t0.7\tb\n"
+            "1\t0.97\t0.11\ta\n"
+            "0\t0.0\t0.9\tc\n"
+        );
+        return srcData;
+    }
+
+    static TQuantizedForCPUDataProviderPtr ReadAndQuantize(
+        const TReadDatasetMainParams& readDatasetMainParams,
+        ui32 bordersSampleSize,
+        EBorderSelectionType borderSelectionType,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        TQuantizationOptions quantizationOptions;
+        quantizationOptions.GpuCompatibleFormat = false;
+        quantizationOptions.MaxSubsetSizeForStreamingBuildBorders = bordersSampleSize;
+
+        TRestorableFastRng64 rand(0);
+
+        return ReadAndQuantizeDataset(
+            readDatasetMainParams.PoolPath,
+            readDatasetMainParams.PairsFilePath,
+            readDatasetMainParams.GroupWeightsFilePath,
+            readDatasetMainParams.DsvPoolFormatParams,
+            /*ignoredFeatures*/ {},
+            EObjectsOrder::Undefined,
+            quantizationOptions,
+            /*quantizedFeaturesInfo*/ nullptr,
+            NCatboostOptions::TBinarizationOptions(borderSelectionType, 4, ENanMode::Min),
+            /*initQuantizedFeaturesInfo*/ {},
+            &rand,
+            localExecutor
+        )->CastMoveTo<TQuantizedForCPUObjectsDataProvider>();
+    }
+
+    static void TestSameAsQuantize(EBorderSelectionType borderSelectionType) {
+        TReadDatasetMainParams readDatasetMainParams;
+        TVector<THolder<TTempFile>> srcDataFiles;
+        SaveSrcData(GetSrcData(), &readDatasetMainParams, &srcDataFiles);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        auto streamingQuantizedData = ReadAndQuantize(
+            readDatasetMainParams,
+            100,
+            borderSelectionType,
+            &localExecutor
+        );
+
+        TDataProviderPtr rawData = ReadDataset(
+            readDatasetMainParams.PoolPath,
+            readDatasetMainParams.PairsFilePath,
+            readDatasetMainParams.GroupWeightsFilePath,
+            readDatasetMainParams.DsvPoolFormatParams,
+            /*ignoredFeatures*/ {},
+            EObjectsOrder::Undefined,
+            &localExecutor
+        );
+
+        TQuantizationOptions quantizationOptions;
+        quantizationOptions.GpuCompatibleFormat = false;
+        auto quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+            *rawData->MetaInfo.FeaturesLayout,
+            TConstArrayRef<ui32>(),
+            NCatboostOptions::TBinarizationOptions(borderSelectionType, 4, ENanMode::Min)
+        );
+        TRestorableFastRng64 rand(0);
+        auto quantizedData = Quantize(
+            quantizationOptions,
+            rawData->CastMoveTo<TRawObjectsDataProvider>(),
+            quantizedFeaturesInfo,
+            &rand,
+            &localExecutor
+        )->CastMoveTo<TQuantizedForCPUObjectsDataProvider>();
+
+        UNIT_ASSERT_VALUES_EQUAL(
+            streamingQuantizedData->ObjectsData->GetObjectCount(),
+            quantizedData->ObjectsData->GetObjectCount()
+        );
+        UNIT_ASSERT_EQUAL(
+            streamingQuantizedData->RawTargetData.GetTarget(),
+            quantizedData->RawTargetData.GetTarget()
+        );
+
+        const auto& streamingQuantizedFeaturesInfo
+            = *streamingQuantizedData->ObjectsData->GetQuantizedFeaturesInfo();
+
+        for (auto floatFeatureIdx : xrange(2)) {
+            UNIT_ASSERT_EQUAL(
+                streamingQuantizedFeaturesInfo.GetBorders(TFloatFeatureIdx(floatFeatureIdx)),
+                quantizedFeaturesInfo->GetBorders(TFloatFeatureIdx(floatFeatureIdx))
+            );
+            UNIT_ASSERT_EQUAL(
+                streamingQuantizedFeaturesInfo.GetNanMode(TFloatFeatureIdx(floatFeatureIdx)),
+                quantizedFeaturesInfo->GetNanMode(TFloatFeatureIdx(floatFeatureIdx))
+            );
+            UNIT_ASSERT_EQUAL(
+                *(*streamingQuantizedData->ObjectsData->GetFloatFeature(floatFeatureIdx))
+                    ->ExtractValues(&localExecutor),
+                *(*quantizedData->ObjectsData->GetFloatFeature(floatFeatureIdx))->ExtractValues(&localExecutor)
+            );
+        }
+        UNIT_ASSERT_EQUAL(
+            *(*streamingQuantizedData->ObjectsData->GetCatFeature(0))->ExtractValues(&localExecutor),
+            *(*quantizedData->ObjectsData->GetCatFeature(0))->ExtractValues(&localExecutor)
+        );
+    }
+
+    Y_UNIT_TEST(SameAsQuantizeIfSampleContainsAllObjects) {
+        TestSameAsQuantize(EBorderSelectionType::GreedyLogSum);
+    }
+
+    // sketch is exact for small datasets
+    Y_UNIT_TEST(SameAsQuantizeWithQuantileSketch) {
+        TestSameAsQuantize(EBorderSelectionType::QuantileSketch);
+    }
+
+    Y_UNIT_TEST(BordersFromSample) {
+        TReadDatasetMainParams readDatasetMainParams;
+        TVector<THolder<TTempFile>> srcDataFiles;
+        SaveSrcData(GetSrcData(), &readDatasetMainParams, &srcDataFiles);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        auto quantizedData = ReadAndQuantize(
+            readDatasetMainParams,
+            3,
+            EBorderSelectionType::GreedyLogSum,
+            &localExecutor
+        );
+
+        UNIT_ASSERT_VALUES_EQUAL(quantizedData->ObjectsData->GetObjectCount(), 7);
+
+        const auto& quantizedFeaturesInfo = *quantizedData->ObjectsData->GetQuantizedFeaturesInfo();
+
+        // nan mode depends on all values, not only on the sample
+        UNIT_ASSERT_EQUAL(quantizedFeaturesInfo.GetNanMode(TFloatFeatureIdx(0)), ENanMode::Forbidden);
+        UNIT_ASSERT_EQUAL(quantizedFeaturesInfo.GetNanMode(TFloatFeatureIdx(1)), ENanMode::Min);
+
+        for (auto floatFeatureIdx : xrange(2)) {
+            const auto& borders = quantizedFeaturesInfo.GetBorders(TFloatFeatureIdx(floatFeatureIdx));
+            UNIT_ASSERT(!borders.empty());
+            UNIT_ASSERT(borders.size() <= 4);
+
+            const auto bins = (*quantizedData->ObjectsData->GetFloatFeature(floatFeatureIdx))
+                ->ExtractValues(&localExecutor);
+            UNIT_ASSERT_VALUES_EQUAL((*bins).size(), 7);
+            for (auto bin : *bins) {
+                UNIT_ASSERT(bin <= borders.size());
+            }
+        }
+    }
+}
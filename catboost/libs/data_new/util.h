@@ -6,10 +6,13 @@
 #include <util/generic/array_ref.h>
 #include <util/generic/maybe.h>
 #include <util/generic/strbuf.h>
+#include <util/generic/utility.h>
+#include <util/generic/vector.h>
 
 #include <util/system/types.h>
 
 #include <algorithm>
+#include <iterator>
 
 
 namespace NCB {
@@ -68,6 +71,29 @@ namespace NCB {
     }
 
 
+    /* resize preserving data, for building data with object count unknown in advance
+     *  if exactCapacity is false capacity grows at least by a half when reallocating
+     *   to make repeated resizing amortized O(1) per element
+     *  if exactCapacity is true data is reallocated to the exact size (used at the end of building),
+     *   so no slack from growth remains in the built data
+     */
+    template <class T>
+    void ResizeStorage(size_t size, bool exactCapacity, TVector<T>* data) {
+        if (exactCapacity) {
+            data->yresize(size);
+            // shrink_to_fit is only a non-binding request
+            if (data->capacity() > size) {
+                TVector<T>(std::make_move_iterator(data->begin()), std::make_move_iterator(data->end())).swap(*data);
+            }
+        } else {
+            if (size > data->capacity()) {
+                data->reserve(Max(size, data->capacity() + data->capacity() / 2));
+            }
+            data->yresize(size);
+        }
+    }
+
+
     template <class T>
     void PrepareForInitialization(
         bool defined,
@@ -10,6 +10,7 @@
 #include <catboost/libs/data_types/pair.h>
 #include <catboost/libs/helpers/maybe_owning_array_holder.h>
 #include <catboost/libs/helpers/resource_holder.h>
+#include <catboost/libs/helpers/sparse_array.h>
 #include <catboost/libs/helpers/vector_helpers.h>
 #include <catboost/libs/quantization_schema/schema.h>
 
@@ -71,7 +72,11 @@ namespace NCB {
         virtual void Start(
             bool inBlock, // subset processing - Start/Finish is called for each block
             const TDataMetaInfo& metaInfo,
-            ui32 objectCount,
+
+            /* if not defined (allowed only if inBlock == false) data storage grows with each StartNextBlock
+             * call, it allows to load data in one pass when object count is not known in advance
+             */
+            TMaybe<ui32> objectCount,
             EObjectsOrder objectsOrder,
 
             // keep necessary resources for data to be available (memory mapping for a file for example)
@@ -138,6 +143,8 @@ namespace NCB {
 
         // shared ownership is passed to IRawFeaturesOrderDataVisitor
         virtual void AddFloatFeature(ui32 flatFeatureIdx, TMaybeOwningConstArrayHolder<float> features) = 0;
+        // features contains values for all objects, only non-default ones are stored
+        virtual void AddFloatFeature(ui32 flatFeatureIdx, TSparseArray<float> features) = 0;
 
         virtual void AddCatFeature(ui32 flatFeatureIdx, TConstArrayRef<TString> feature) = 0;
         virtual void AddCatFeature(ui32 flatFeatureIdx, TConstArrayRef<TStringBuf> feature) = 0;
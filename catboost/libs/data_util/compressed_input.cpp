@@ -0,0 +1,199 @@
+#include "compressed_input.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <contrib/libs/zstd/zstd.h>
+
+#include <library/streams/lz/lz.h>
+
+#include <util/generic/vector.h>
+#include <util/stream/buffered.h>
+#include <util/stream/file.h>
+#include <util/stream/zlib.h>
+#include <util/system/file.h>
+#include <util/system/fs.h>
+
+#include <cstring>
+#include <utility>
+
+
+namespace NCB {
+
+    namespace {
+
+    constexpr size_t READ_BUFFER_SIZE = 1 << 20;
+
+    // non-buffered, supports concatenated frames
+    class TZstdDecompress : public IInputStream {
+    public:
+        explicit TZstdDecompress(IInputStream* input)
+            : Input(input)
+            , DStream(ZSTD_createDStream())
+            , FrameFinished(true)
+        {
+            CB_ENSURE(DStream, "Failed to create zstd decompression stream");
+            CheckResult(ZSTD_initDStream(DStream));
+            InBuffer.yresize(ZSTD_DStreamInSize());
+            In = {InBuffer.data(), 0, 0};
+        }
+
+        ~TZstdDecompress() override {
+            ZSTD_freeDStream(DStream);
+        }
+
+    private:
+        size_t DoRead(void* buf, size_t len) override {
+            ZSTD_outBuffer out = {buf, len, 0};
+            while (len && !out.pos) {
+                if (In.pos == In.size) {
+                    if (!FrameFinished) {
+                        // decoder can still hold output for the already consumed input if out was full
+                        FrameFinished = (CheckResult(ZSTD_decompressStream(DStream, &out, &In)) == 0);
+                        if (out.pos) {
+                            break;
+                        }
+                    }
+                    In.size = Input->Read(InBuffer.data(), InBuffer.size());
+                    In.pos = 0;
+                    if (!In.size) {
+                        CB_ENSURE(FrameFinished, "Unexpected end of zstd compressed data");
+                        return 0;
+                    }
+                }
+                FrameFinished = (CheckResult(ZSTD_decompressStream(DStream, &out, &In)) == 0);
+            }
+            return out.pos;
+        }
+
+        static size_t CheckResult(size_t result) {
+            CB_ENSURE(!ZSTD_isError(result), "zstd decompression error: " << ZSTD_getErrorName(result));
+            return result;
+        }
+
+    private:
+        IInputStream* Input;
+        ZSTD_DStream* DStream;
+        TVector<char> InBuffer;
+        ZSTD_inBuffer In;
+        bool FrameFinished;
+    };
+
+
+    class TDecompressingInput : public IInputStream {
+    public:
+        TDecompressingInput(THolder<IInputStream> source, EInputCompression compression)
+            : Source(std::move(source))
+        {
+            switch (compression) {
+                case EInputCompression::GZip:
+                    Decompressor = MakeHolder<TZLibDecompress>(Source.Get(), ZLib::Auto, READ_BUFFER_SIZE);
+                    break;
+                case EInputCompression::Zstd:
+                    Decompressor = MakeHolder<TZstdDecompress>(Source.Get());
+                    break;
+                case EInputCompression::Lz:
+                    Decompressor.Reset(OpenLzDecompressor(Source.Get()).Release());
+                    break;
+                default:
+                    CB_ENSURE_INTERNAL(false, "TDecompressingInput: unexpected compression type");
+            }
+            Buffered = MakeHolder<TBufferedInput>(Decompressor.Get(), READ_BUFFER_SIZE);
+        }
+
+    private:
+        size_t DoRead(void* buf, size_t len) override {
+            return Buffered->Read(buf, len);
+        }
+
+        size_t DoReadTo(TString& st, char ch) override {
+            return Buffered->ReadTo(st, ch);
+        }
+
+    private:
+        THolder<IInputStream> Source;
+        THolder<IInputStream> Decompressor;
+        THolder<TBufferedInput> Buffered;
+    };
+
+
+    EInputCompression DetectCompression(const TString& path) {
+        CB_ENSURE(NFs::Exists(path), "file '" << path << "' is not found");
+
+        ui8 magic[4] = {0};
+        const size_t readSize = TFile(path, OpenExisting | RdOnly).Read(magic, sizeof(magic));
+
+        if ((readSize >= 2) && (magic[0] == 0x1f) && (magic[1] == 0x8b)) {
+            return EInputCompression::GZip;
+        }
+        /* zlib header: deflate with 32K window (as written by all common encoders), no preset dictionary,
+         * check bits; other window sizes are not detected as their headers can be plain text like "X\t"
+         */
+        if ((readSize >= 2) && (magic[0] == 0x78) && !(magic[1] & 0x20) && ((magic[0] * 256 + magic[1]) % 31 == 0)) {
+            return EInputCompression::GZip;
+        }
+        if ((readSize == 4) && (magic[0] == 0x28) && (magic[1] == 0xb5) && (magic[2] == 0x2f) && (magic[3] == 0xfd)) {
+            return EInputCompression::Zstd;
+        }
+        return EInputCompression::None;
+    }
+
+    }
+
+
+    EInputCompression GetInputCompressionFromScheme(TStringBuf scheme) {
+        if (scheme.EndsWith("+gz")) {
+            return EInputCompression::GZip;
+        }
+        if (scheme.EndsWith("+zst")) {
+            return EInputCompression::Zstd;
+        }
+        if (scheme.EndsWith("+lz")) {
+            return EInputCompression::Lz;
+        }
+        return EInputCompression::None;
+    }
+
+    EInputCompression GetInputCompression(TStringBuf scheme, const TString& path) {
+        const EInputCompression compression = GetInputCompressionFromScheme(scheme);
+        return (compression != EInputCompression::None) ? compression : DetectCompression(path);
+    }
+
+    THolder<IInputStream> OpenFileInput(const TString& path, EInputCompression compression) {
+        if (compression == EInputCompression::None) {
+            return MakeHolder<TFileInput>(path, READ_BUFFER_SIZE);
+        }
+        return MakeHolder<TDecompressingInput>(MakeHolder<TFileInput>(path), compression);
+    }
+
+    THolder<IInputStream> OpenFileDescriptorInput(int fd, EInputCompression compression) {
+        CB_ENSURE(fd >= 0, "Invalid file descriptor " << fd);
+
+        // a duplicate is read and closed, fd itself stays open
+        const TFile file = Duplicate(fd);
+        if (compression == EInputCompression::None) {
+            return MakeHolder<TFileInput>(file, READ_BUFFER_SIZE);
+        }
+        return MakeHolder<TDecompressingInput>(MakeHolder<TFileInput>(file), compression);
+    }
+
+    ui64 CountLines(IInputStream* input) {
+        TVector<char> buffer;
+        buffer.yresize(READ_BUFFER_SIZE);
+
+        ui64 count = 0;
+        char lastChar = '\n';
+        while (size_t readSize = input->Read(buffer.data(), READ_BUFFER_SIZE)) {
+            const char* begin = buffer.data();
+            const char* end = begin + readSize;
+            while (const char* newLine = (const char*)memchr(begin, '\n', end - begin)) {
+                ++count;
+                begin = newLine + 1;
+            }
+            lastChar = *(end - 1);
+        }
+        if (lastChar != '\n') {
+            ++count;
+        }
+        return count;
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <util/generic/ptr.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/string.h>
+#include <util/stream/input.h>
+
+
+namespace NCB {
+
+    enum class EInputCompression {
+        None,
+        GZip, // gzip or zlib
+        Zstd,
+        Lz    // one of library/streams/lz formats, detected by its signature
+    };
+
+    /* scheme suffix '+gz', '+zst' or '+lz' (like in 'dsv+gz://') selects compression explicitly,
+     * otherwise gzip, zlib and zstd compression is detected by the file's magic bytes
+     */
+    EInputCompression GetInputCompression(TStringBuf scheme, const TString& path);
+
+    // only scheme suffix is used, for inputs that can't be inspected in advance (like pipes)
+    EInputCompression GetInputCompressionFromScheme(TStringBuf scheme);
+
+    // returns buffered input (ReadLine is efficient)
+    THolder<IInputStream> OpenFileInput(const TString& path, EInputCompression compression);
+
+    /* same as OpenFileInput but for already opened file descriptor (e.g. 0 for stdin),
+     * a duplicate of fd is used, so fd itself is not closed
+     */
+    THolder<IInputStream> OpenFileDescriptorInput(int fd, EInputCompression compression);
+
+    // counts lines like ReadLine does: the last line does not need to end with a newline
+    ui64 CountLines(IInputStream* input);
+
+}
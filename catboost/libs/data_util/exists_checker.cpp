@@ -1,6 +1,8 @@
 
 #include "exists_checker.h"
 
+#include <util/string/cast.h>
+
 
 namespace NCB {
 
@@ -10,9 +12,24 @@ namespace NCB {
 
     namespace {
 
+    // file descriptor is not checked to be open, reading from it will fail if it is not
+    struct TFileDescriptorExistsChecker : public IExistsChecker {
+        bool Exists(const TPathWithScheme& pathWithScheme) const override {
+            int fd = -1;
+            return TryFromString(pathWithScheme.Path, fd) && (fd >= 0);
+        }
+    };
+
     TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSExistsCheckerReg("");
     TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSFileExistsCheckerReg("file");
     TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSDsvExistsCheckerReg("dsv");
+    TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSDsvGZipExistsCheckerReg("dsv+gz");
+    TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSDsvZstdExistsCheckerReg("dsv+zst");
+    TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSDsvLzExistsCheckerReg("dsv+lz");
+    TExistsCheckerFactory::TRegistrator<TFileDescriptorExistsChecker> FdExistsCheckerReg("fd");
+    TExistsCheckerFactory::TRegistrator<TFileDescriptorExistsChecker> FdGZipExistsCheckerReg("fd+gz");
+    TExistsCheckerFactory::TRegistrator<TFileDescriptorExistsChecker> FdZstdExistsCheckerReg("fd+zst");
+    TExistsCheckerFactory::TRegistrator<TFileDescriptorExistsChecker> FdLzExistsCheckerReg("fd+lz");
 
     }
 }
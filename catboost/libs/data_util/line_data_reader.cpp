@@ -1,13 +1,21 @@
 #include "line_data_reader.h"
+#include "compressed_input.h"
 
 #include <catboost/libs/helpers/exception.h>
 
+#include <util/generic/ptr.h>
 #include <util/stream/file.h>
-#include <util/system/fs.h>
+#include <util/string/cast.h>
+
+#include <utility>
 
 
 namespace NCB {
 
+    bool IsSinglePassPath(const TPathWithScheme& pathWithScheme) {
+        return (pathWithScheme.Scheme == "fd") || pathWithScheme.Scheme.StartsWith("fd+");
+    }
+
     THolder<ILineDataReader> GetLineDataReader(const TPathWithScheme& pathWithScheme,
                                                const TDsvFormatOptions& format)
     {
@@ -19,39 +27,20 @@ namespace NCB {
 
     namespace {
 
-    template <class TStr>
-    inline int CountLines(const TStr& poolFile) {
-        CB_ENSURE(NFs::Exists(TString(poolFile)), "pool file '" << TString(poolFile) << "' is not found");
-        TIFStream reader(poolFile.c_str());
-        size_t count = 0;
-        TString buffer;
-        while (reader.ReadLine(buffer)) {
-            ++count;
-        }
-        return count;
-    }
-
-    class TFileLineDataReader : public ILineDataReader {
+    // common header handling for readers of text data from a stream
+    class TStreamLineDataReaderBase : public ILineDataReader {
     public:
-        TFileLineDataReader(const TLineDataReaderArgs& args)
+        TStreamLineDataReaderBase(const TLineDataReaderArgs& args, THolder<IInputStream> input)
             : Args(args)
-            , IFStream(args.PathWithScheme.Path)
+            , Input(std::move(input))
             , HeaderProcessed(!Args.Format.HasHeader)
         {}
 
-        ui64 GetDataLineCount() override {
-            ui64 nLines = (ui64)CountLines(Args.PathWithScheme.Path);
-            if (Args.Format.HasHeader) {
-                --nLines;
-            }
-            return nLines;
-        }
-
         TMaybe<TString> GetHeader() override {
             if (Args.Format.HasHeader) {
-                CB_ENSURE(!HeaderProcessed, "TFileLineDataReader: multiple calls to GetHeader");
+                CB_ENSURE(!HeaderProcessed, "TLineDataReader: multiple calls to GetHeader");
                 TString header;
-                CB_ENSURE(IFStream.ReadLine(header), "TFileLineDataReader: no header in file");
+                CB_ENSURE(Input->ReadLine(header), "TLineDataReader: no header in " << Args.PathWithScheme);
                 HeaderProcessed = true;
                 return header;
             }
@@ -64,19 +53,90 @@ namespace NCB {
             if (!HeaderProcessed) {
                 GetHeader();
             }
-            return IFStream.ReadLine(*line) != 0;
+            return Input->ReadLine(*line) != 0;
         }
 
-    private:
+    protected:
         TLineDataReaderArgs Args;
-        TIFStream IFStream;
+        THolder<IInputStream> Input;
         bool HeaderProcessed;
     };
 
 
+    class TFileLineDataReader : public TStreamLineDataReaderBase {
+    public:
+        TFileLineDataReader(const TLineDataReaderArgs& args)
+            : TFileLineDataReader(args, GetInputCompression(args.PathWithScheme.Scheme, args.PathWithScheme.Path))
+        {}
+
+        ui64 GetDataLineCount() override {
+            ui64 nLines = 0;
+            if (Compression == EInputCompression::None) {
+                TUnbufferedFileInput input(Args.PathWithScheme.Path);
+                nLines = CountLines(&input);
+            } else {
+                nLines = CountLines(OpenFileInput(Args.PathWithScheme.Path, Compression).Get());
+            }
+            if (Args.Format.HasHeader) {
+                --nLines;
+            }
+            return nLines;
+        }
+
+    private:
+        TFileLineDataReader(const TLineDataReaderArgs& args, EInputCompression compression)
+            : TStreamLineDataReaderBase(args, OpenFileInput(args.PathWithScheme.Path, compression))
+            , Compression(compression)
+        {}
+
+    private:
+        EInputCompression Compression;
+    };
+
+
+    /* reads data from an already opened file descriptor: 'fd://0' is stdin,
+     * so data can be piped from another process without intermediate files.
+     * Data can be read only once, so this reader can be used only where the dataset is read in a single pass.
+     */
+    class TFileDescriptorLineDataReader : public TStreamLineDataReaderBase {
+    public:
+        TFileDescriptorLineDataReader(const TLineDataReaderArgs& args)
+            : TStreamLineDataReaderBase(
+                args,
+                OpenFileDescriptorInput(
+                    ParseFileDescriptor(args.PathWithScheme),
+                    GetInputCompressionFromScheme(args.PathWithScheme.Scheme)
+                )
+            )
+        {}
+
+        ui64 GetDataLineCount() override {
+            ythrow TCatBoostException() << "Data line count is unknown in advance for " << Args.PathWithScheme;
+        }
+
+    private:
+        static int ParseFileDescriptor(const TPathWithScheme& pathWithScheme) {
+            int fd = -1;
+            CB_ENSURE(
+                TryFromString(pathWithScheme.Path, fd) && (fd >= 0),
+                "Path for scheme " << pathWithScheme.Scheme << " must be a file descriptor number, got "
+                << pathWithScheme.Path
+            );
+            return fd;
+        }
+    };
+
+
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DefLineDataReaderReg("");
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> FileLineDataReaderReg("file");
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DsvLineDataReaderReg("dsv");
+    TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DsvGZipLineDataReaderReg("dsv+gz");
+    TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DsvZstdLineDataReaderReg("dsv+zst");
+    TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DsvLzLineDataReaderReg("dsv+lz");
+    TLineDataReaderFactory::TRegistrator<TFileDescriptorLineDataReader> FdLineDataReaderReg("fd");
+    TLineDataReaderFactory::TRegistrator<TFileDescriptorLineDataReader> FdGZipLineDataReaderReg("fd+gz");
+    TLineDataReaderFactory::TRegistrator<TFileDescriptorLineDataReader> FdZstdLineDataReaderReg("fd+zst");
+    TLineDataReaderFactory::TRegistrator<TFileDescriptorLineDataReader> FdLzLineDataReaderReg("fd+lz");
 
     }
 }
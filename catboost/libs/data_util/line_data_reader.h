@@ -47,4 +47,9 @@ namespace NCB {
     THolder<ILineDataReader> GetLineDataReader(const TPathWithScheme& pathWithScheme,
                                                const TDsvFormatOptions& format = {});
 
+    /* data from such paths can be read only once (e.g. 'fd://0' - stdin),
+     * so they are not compatible with the processing that reads the dataset several times
+     */
+    bool IsSinglePassPath(const TPathWithScheme& pathWithScheme);
+
 }
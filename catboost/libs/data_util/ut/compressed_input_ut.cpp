@@ -0,0 +1,156 @@
+#include <catboost/libs/data_util/line_data_reader.h>
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <contrib/libs/zstd/zstd.h>
+
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/stream/file.h>
+#include <util/stream/zlib.h>
+#include <util/string/cast.h>
+#include <util/system/file.h>
+#include <util/system/mktemp.h>
+#include <util/system/tempfile.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+static const TString DATA = "header\n0\t1.5\ta\n1\t2.5\tb\n0\t3.5\tc";
+
+static TVector<TString> ReadLines(const TPathWithScheme& path, ui64* dataLineCount) {
+    auto reader = GetLineDataReader(path, TDsvFormatOptions{true, '\t'});
+    *dataLineCount = reader->GetDataLineCount();
+    TVector<TString> lines;
+    lines.push_back(*reader->GetHeader());
+    TString line;
+    while (reader->ReadLine(&line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static void CheckRead(const TString& path, const TVector<TString>& schemes) {
+    const TVector<TString> expectedLines = {"header", "0\t1.5\ta", "1\t2.5\tb", "0\t3.5\tc"};
+    for (const auto& scheme : schemes) {
+        ui64 dataLineCount = 0;
+        UNIT_ASSERT_EQUAL(ReadLines(TPathWithScheme(scheme + "://" + path), &dataLineCount), expectedLines);
+        UNIT_ASSERT_VALUES_EQUAL(dataLineCount, 3);
+    }
+}
+
+
+Y_UNIT_TEST_SUITE(CompressedLineDataReader) {
+    Y_UNIT_TEST(Plain) {
+        TTempFile file(MakeTempName());
+        TFileOutput(file.Name()).Write(DATA);
+        CheckRead(file.Name(), {"dsv", "file"});
+    }
+
+    Y_UNIT_TEST(GZip) {
+        TTempFile file(MakeTempName());
+        {
+            TFileOutput output(file.Name());
+            TZLibCompress compress(&output, ZLib::GZip);
+            compress.Write(DATA);
+            compress.Finish();
+        }
+        CheckRead(file.Name(), {"dsv", "dsv+gz"});
+    }
+
+    Y_UNIT_TEST(ZLib) {
+        TTempFile file(MakeTempName());
+        {
+            TFileOutput output(file.Name());
+            TZLibCompress compress(&output, ZLib::ZLib);
+            compress.Write(DATA);
+            compress.Finish();
+        }
+        CheckRead(file.Name(), {"dsv", "dsv+gz"});
+    }
+
+    Y_UNIT_TEST(Zstd) {
+        TTempFile file(MakeTempName());
+        {
+            // two concatenated frames
+            TFileOutput output(file.Name());
+            const size_t split = DATA.size() / 2;
+            for (TStringBuf part : {TStringBuf(DATA).Head(split), TStringBuf(DATA).Tail(split)}) {
+                TString compressed;
+                compressed.resize(ZSTD_compressBound(part.size()));
+                const size_t compressedSize = ZSTD_compress(
+                    compressed.begin(),
+                    compressed.size(),
+                    part.data(),
+                    part.size(),
+                    3
+                );
+                UNIT_ASSERT(!ZSTD_isError(compressedSize));
+                output.Write(compressed.data(), compressedSize);
+            }
+        }
+        CheckRead(file.Name(), {"dsv", "dsv+zst"});
+    }
+
+    Y_UNIT_TEST(ZstdHighlyCompressible) {
+        // one input chunk decompresses to much more than one output buffer
+        const size_t lineCount = 2000000;
+        TString data = "header\n";
+        for (size_t i = 0; i < lineCount; ++i) {
+            data += "0\t1.5\ta\n";
+        }
+
+        TTempFile file(MakeTempName());
+        {
+            TString compressed;
+            compressed.resize(ZSTD_compressBound(data.size()));
+            const size_t compressedSize = ZSTD_compress(
+                compressed.begin(),
+                compressed.size(),
+                data.data(),
+                data.size(),
+                3
+            );
+            UNIT_ASSERT(!ZSTD_isError(compressedSize));
+            TFileOutput(file.Name()).Write(compressed.data(), compressedSize);
+        }
+
+        auto reader = GetLineDataReader(TPathWithScheme("dsv+zst://" + file.Name()), TDsvFormatOptions{true, '\t'});
+        UNIT_ASSERT_VALUES_EQUAL(reader->GetDataLineCount(), lineCount);
+        UNIT_ASSERT_VALUES_EQUAL(*reader->GetHeader(), "header");
+        size_t readLineCount = 0;
+        TString line;
+        while (reader->ReadLine(&line)) {
+            UNIT_ASSERT_VALUES_EQUAL(line, "0\t1.5\ta");
+            ++readLineCount;
+        }
+        UNIT_ASSERT_VALUES_EQUAL(readLineCount, lineCount);
+    }
+
+    Y_UNIT_TEST(FileDescriptor) {
+        TTempFile file(MakeTempName());
+        {
+            TFileOutput output(file.Name());
+            TZLibCompress compress(&output, ZLib::GZip);
+            compress.Write(DATA);
+            compress.Finish();
+        }
+        TFile input(file.Name(), OpenExisting | RdOnly);
+        const TPathWithScheme path("fd+gz://" + ToString(input.GetHandle()));
+        UNIT_ASSERT(IsSinglePassPath(path));
+        UNIT_ASSERT(!IsSinglePassPath(TPathWithScheme("dsv+gz://" + file.Name())));
+
+        auto reader = GetLineDataReader(path, TDsvFormatOptions{true, '\t'});
+        UNIT_ASSERT_EXCEPTION(reader->GetDataLineCount(), TCatBoostException);
+        TVector<TString> lines = {*reader->GetHeader()};
+        TString line;
+        while (reader->ReadLine(&line)) {
+            lines.push_back(line);
+        }
+        const TVector<TString> expectedLines = {"header", "0\t1.5\ta", "1\t2.5\tb", "0\t3.5\tc"};
+        UNIT_ASSERT_EQUAL(lines, expectedLines);
+    }
+}
@@ -403,6 +403,7 @@ void TBucketMultiUpdater::DoMap(NPar::IUserContext* /*ctx*/, int /*hostId*/, TIn
     const auto error = BuildError(localData.Params, /*custom objective*/ Nothing());
     const auto estimationMethod = localData.Params.ObliviousTreeOptions->LeavesEstimationMethod;
 
+    TVector<TVector<TSumMulti>> blockBuckets;
     if (estimationMethod == ELeavesEstimation::Newton) {
         UpdateBucketsMulti(AddSampleToBucketNewtonMulti,
             localData.Indices,
@@ -413,6 +414,8 @@ void TBucketMultiUpdater::DoMap(NPar::IUserContext* /*ctx*/, int /*hostId*/, TIn
             *error,
             localData.Progress.AveragingFold.BodyTailArr[0].BodyFinish,
             localData.GradientIteration,
+            &NPar::LocalExecutor(),
+            &blockBuckets,
             &localData.MultiBuckets);
     } else {
         Y_ASSERT(estimationMethod == ELeavesEstimation::Gradient);
@@ -425,6 +428,8 @@ void TBucketMultiUpdater::DoMap(NPar::IUserContext* /*ctx*/, int /*hostId*/, TIn
             *error,
             localData.Progress.AveragingFold.BodyTailArr[0].BodyFinish,
             localData.GradientIteration,
+            &NPar::LocalExecutor(),
+            &blockBuckets,
             &localData.MultiBuckets);
     }
     sums->Data = std::make_pair(localData.MultiBuckets, TUnusedInitializedParam());
@@ -434,6 +439,7 @@ void TDeltaMultiUpdater::DoMap(NPar::IUserContext* /*ctx*/, int /*hostId*/, TInp
     auto& localData = TLocalTensorSearchData::GetRef();
     UpdateApproxDeltasMulti(localData.StoreExpApprox, localData.Indices,
         localData.Progress.AveragingFold.BodyTailArr[0].BodyFinish,
+        &NPar::LocalExecutor(),
         leafValues,
         &localData.ApproxDeltas);
     ++localData.GradientIteration; // gradient iteration completed
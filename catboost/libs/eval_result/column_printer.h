@@ -3,6 +3,7 @@
 #include "pool_printer.h"
 
 #include <catboost/libs/column_description/column.h>
+#include <catboost/libs/data_new/cat_feature_hash_to_string.h>
 #include <catboost/libs/data_new/weights.h>
 #include <catboost/libs/helpers/maybe_owning_array_holder.h>
 #include <catboost/libs/helpers/exception.h>
@@ -146,7 +147,7 @@ namespace NCB {
     class TCatFeaturePrinter: public IColumnPrinter {
     public:
         TCatFeaturePrinter(TVector<ui32>&& hashedValues,
-                           const THashMap<ui32, TString>& hashToString,
+                           const NCB::TCatFeatureHashToString& hashToString,
                            const TString& header)
             : HashedValues(std::move(hashedValues))
             , HashToString(hashToString)
@@ -155,7 +156,7 @@ namespace NCB {
         }
 
         void OutputValue(IOutputStream* outStream, size_t docIndex) override {
-            *outStream << HashToString.at(HashedValues[docIndex]);
+            *outStream << HashToString.At(HashedValues[docIndex]);
         }
 
         void OutputHeader(IOutputStream* outStream) override {
@@ -164,7 +165,7 @@ namespace NCB {
 
     private:
         const TVector<ui32> HashedValues;
-        const THashMap<ui32, TString>& HashToString;
+        const NCB::TCatFeatureHashToString& HashToString;
         const TString Header;
     };
 
@@ -150,7 +150,7 @@ namespace NCB {
         if (testSetPath.Inited()) {
             if (testSetPath.Scheme == "quantized") {
                 poolColumnsPrinter = TIntrusivePtr<IPoolColumnsPrinter>(new TQuantizedPoolColumnsPrinter(testSetPath));
-            } else if (testSetPath.Scheme == "dsv" || testSetPath.Scheme == "yt-dsv") {
+            } else if (testSetPath.Scheme == "dsv" || testSetPath.Scheme.StartsWith("dsv+") || testSetPath.Scheme == "yt-dsv") {
                 poolColumnsPrinter = TIntrusivePtr<IPoolColumnsPrinter>(new TDSVPoolColumnsPrinter(testSetPath, testSetFormat, columnsMetaInfo));
             }
         }
@@ -273,11 +273,8 @@ namespace NCB {
                         )
                     );
                 } else {
-                    const auto arrayData = (*rawObjectsData->GetFloatFeature(it->second.Index))->GetArrayData();
-                    TVector<float> floatFeaturesArray = GetSubset<float>(
-                        *arrayData.GetSrc(),
-                        *arrayData.GetSubsetIndexing()
-                    );
+                    TVector<float> floatFeaturesArray
+                        = (*rawObjectsData->GetFloatFeature(it->second.Index))->ExtractValues();
 
                     columnPrinter.push_back(
                         MakeHolder<TArrayPrinter<float>>(
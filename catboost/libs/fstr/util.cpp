@@ -59,7 +59,7 @@ TVector<TVector<double>> CollectLeavesStatistics(
 
     const auto documentsCount = dataset.GetObjectCount();
     for (size_t treeIdx = 0; treeIdx < treeCount; ++treeIdx) {
-        TVector<TIndexType> indices = BuildIndicesForBinTree(model, binFeatures, treeIdx);
+        TVector<ui32> indices = BuildIndicesForBinTree(model, binFeatures, treeIdx);
 
         if (indices.empty()) {
             continue;
@@ -67,12 +67,12 @@ TVector<TVector<double>> CollectLeavesStatistics(
 
         if (weights.empty()) {
             for (size_t doc = 0; doc < documentsCount; ++doc) {
-                const TIndexType valueIndex = indices[doc];
+                const ui32 valueIndex = indices[doc];
                 leavesStatistics[treeIdx][valueIndex] += 1.0;
             }
         } else {
             for (size_t doc = 0; doc < documentsCount; ++doc) {
-                const TIndexType valueIndex = indices[doc];
+                const ui32 valueIndex = indices[doc];
                 leavesStatistics[treeIdx][valueIndex] += weights[doc];
             }
         }
@@ -0,0 +1,32 @@
+#include "counter_rng.h"
+
+#include <library/fast_exp/fast_exp.h>
+#include <library/fast_log/fast_log.h>
+
+#include <util/generic/ymath.h>
+
+
+void GenerateRealPositive(ui64 seed, ui64 firstCounter, TArrayRef<double> dst) {
+    for (size_t idx = 0; idx < dst.size(); ++idx) {
+        dst[idx] = TCounterRng64::GenerateRealPositive(seed, firstCounter + idx);
+    }
+}
+
+void GenerateBayesianWeights(ui64 seed, ui64 firstCounter, float temperature, TArrayRef<float> dst) {
+    constexpr size_t batchSize = 256;
+    // -log(u) for u close to 1 goes to zero, the weight is clipped to keep log finite
+    constexpr float minExponentialWeight = 1e-20f;
+    double batch[batchSize];
+    for (size_t batchStart = 0; batchStart < dst.size(); batchStart += batchSize) {
+        const size_t batchLength = Min(batchSize, dst.size() - batchStart);
+        GenerateRealPositive(seed, firstCounter + batchStart, MakeArrayRef(batch, batchLength));
+        for (size_t idx = 0; idx < batchLength; ++idx) {
+            const float exponentialWeight = Max(-FastLogf(batch[idx]), minExponentialWeight);
+            batch[idx] = temperature * FastLogf(exponentialWeight);
+        }
+        FastExpInplace(batch, batchLength);
+        for (size_t idx = 0; idx < batchLength; ++idx) {
+            dst[batchStart + idx] = batch[idx];
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <util/generic/array_ref.h>
+#include <util/random/common_ops.h>
+#include <util/system/types.h>
+
+#include <array>
+
+
+/* Counter-based random numbers: Philox4x32-10 from
+ * J. Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11.
+ * A value depends only on the key and the counter, so a sequence indexed by document
+ * can be generated by blocks in any order, independently of thread count and block size.
+ */
+using TPhiloxCounter = std::array<ui32, 4>;
+using TPhiloxKey = std::array<ui32, 2>;
+
+inline TPhiloxCounter Philox4x32(TPhiloxCounter counter, TPhiloxKey key) noexcept {
+    constexpr ui32 multiplier0 = 0xD2511F53;
+    constexpr ui32 multiplier1 = 0xCD9E8D57;
+    constexpr ui32 weyl0 = 0x9E3779B9;
+    constexpr ui32 weyl1 = 0xBB67AE85;
+    for (int round = 0; round < 10; ++round) {
+        const ui64 product0 = (ui64)multiplier0 * counter[0];
+        const ui64 product1 = (ui64)multiplier1 * counter[2];
+        counter = {
+            (ui32)(product1 >> 32) ^ counter[1] ^ key[0],
+            (ui32)product1,
+            (ui32)(product0 >> 32) ^ counter[3] ^ key[1],
+            (ui32)product0
+        };
+        key[0] += weyl0;
+        key[1] += weyl1;
+    }
+    return counter;
+}
+
+class TCounterRng64 : public TCommonRNG<ui64, TCounterRng64> {
+public:
+    explicit TCounterRng64(ui64 seed, ui64 counter = 0) noexcept
+        : Seed(seed)
+        , Counter(counter)
+    {
+    }
+
+    // sequential interface for algorithms which consume values one by one (e.g. Shuffle)
+    ui64 GenRand() noexcept {
+        return Generate(Seed, Counter++);
+    }
+
+    static ui64 Generate(ui64 seed, ui64 counter) noexcept {
+        const TPhiloxCounter result = Philox4x32(
+            {(ui32)counter, (ui32)(counter >> 32), 0, 0},
+            {(ui32)seed, (ui32)(seed >> 32)}
+        );
+        return (ui64)result[0] | ((ui64)result[1] << 32);
+    }
+
+    // uniform in (0, 1], so that log of the value is finite
+    static double GenerateRealPositive(ui64 seed, ui64 counter) noexcept {
+        return ((Generate(seed, counter) >> 11) + 1) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    ui64 Seed;
+    ui64 Counter;
+};
+
+// values for counters [firstCounter, firstCounter + dst.size())
+void GenerateRealPositive(ui64 seed, ui64 firstCounter, TArrayRef<double> dst);
+
+// -log(u) ^ temperature for uniform u, i.e. exponential weights of Bayesian bootstrap,
+// for counters [firstCounter, firstCounter + dst.size())
+void GenerateBayesianWeights(ui64 seed, ui64 firstCounter, float temperature, TArrayRef<float> dst);
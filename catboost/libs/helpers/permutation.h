@@ -37,8 +37,8 @@ TVector<IndexType> InvertPermutation(const TVector<IndexType>& permutation) {
 }
 
 
-template <class T>
-void CreateShuffledIndices(size_t size, TRestorableFastRng64* rand, TVector<T>* result) {
+template <class T, class TRng = TRestorableFastRng64>
+void CreateShuffledIndices(size_t size, TRng* rand, TVector<T>* result) {
     static_assert(std::is_integral<T>::value);
     result->yresize(size);
     std::iota(result->begin(), result->end(), T(0));
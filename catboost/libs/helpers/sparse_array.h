@@ -0,0 +1,174 @@
+#pragma once
+
+#include "array_subset.h"
+#include "exception.h"
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/system/types.h>
+#include <util/system/yassert.h>
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace NCB {
+
+    /* Array of Size elements where most elements are equal to DefaultValue.
+     * Only the other (non-default) elements are stored, as pairs of sorted Indices and Values.
+     */
+    template <class TValue>
+    class TSparseArray {
+    public:
+        TSparseArray(
+            ui32 size,
+            TValue defaultValue,
+            TVector<ui32>&& indices,
+            TVector<TValue>&& values
+        )
+            : Size(size)
+            , DefaultValue(defaultValue)
+            , Indices(std::move(indices))
+            , Values(std::move(values))
+        {
+            CB_ENSURE_INTERNAL(
+                Indices.size() == Values.size(),
+                "TSparseArray: Indices and Values have different sizes"
+            );
+            CB_ENSURE_INTERNAL(
+                Indices.empty() || (Indices.back() < Size),
+                "TSparseArray: index is out of bounds"
+            );
+            Y_ASSERT(std::is_sorted(Indices.begin(), Indices.end()));
+        }
+
+        // stores only elements not equal to defaultValue
+        static TSparseArray FromDense(TConstArrayRef<TValue> dense, TValue defaultValue) {
+            TVector<ui32> indices;
+            TVector<TValue> values;
+            for (auto i : xrange(dense.size())) {
+                if (!IsDefault(dense[i], defaultValue)) {
+                    indices.push_back(i);
+                    values.push_back(dense[i]);
+                }
+            }
+            return TSparseArray(dense.size(), defaultValue, std::move(indices), std::move(values));
+        }
+
+        bool operator==(const TSparseArray& rhs) const {
+            return (Size == rhs.Size) && IsDefault(DefaultValue, rhs.DefaultValue) &&
+                (Indices == rhs.Indices) && (Values == rhs.Values);
+        }
+
+        ui32 GetSize() const {
+            return Size;
+        }
+
+        TValue GetDefaultValue() const {
+            return DefaultValue;
+        }
+
+        ui32 GetNonDefaultSize() const {
+            return Indices.size();
+        }
+
+        TConstArrayRef<ui32> GetIndices() const {
+            return Indices;
+        }
+
+        TConstArrayRef<TValue> GetNonDefaultValues() const {
+            return Values;
+        }
+
+        // f is called with (index, value) for each non-default element in increasing index order
+        template <class F>
+        void ForEachNonDefault(F&& f) const {
+            for (auto i : xrange(Indices.size())) {
+                f(Indices[i], Values[i]);
+            }
+        }
+
+        TValue operator[](ui32 index) const {
+            auto it = std::lower_bound(Indices.begin(), Indices.end(), index);
+            if ((it != Indices.end()) && (*it == index)) {
+                return Values[it - Indices.begin()];
+            }
+            return DefaultValue;
+        }
+
+        TVector<TValue> ExtractValues() const {
+            TVector<TValue> result(Size, DefaultValue);
+            ForEachNonDefault([&] (ui32 index, TValue value) { result[index] = value; });
+            return result;
+        }
+
+        // dst[i] = (*this)[begin + i], O(log(number of non-default elements) + dst.size())
+        void ExtractValues(ui32 begin, TArrayRef<TValue> dst) const {
+            Y_ASSERT(begin + dst.size() <= Size);
+            std::fill(dst.begin(), dst.end(), DefaultValue);
+            const ui32 end = begin + dst.size();
+            auto it = std::lower_bound(Indices.begin(), Indices.end(), begin);
+            for (; (it != Indices.end()) && (*it < end); ++it) {
+                dst[*it - begin] = Values[it - Indices.begin()];
+            }
+        }
+
+        /* result element at index i is this array's element at subsetIndexing's i-th source index
+         *
+         * complexity is O(number of non-default elements + number of blocks * log(number of non-default elements))
+         * for TFullSubset and TRangesSubset, O(subset size * log(number of non-default elements)) for TIndexedSubset
+         */
+        TSparseArray GetSubset(const TArraySubsetIndexing<ui32>& subsetIndexing) const {
+            using TSubsetVariant = typename TArraySubsetIndexing<ui32>::TBase;
+
+            TVector<ui32> dstIndices;
+            TVector<TValue> dstValues;
+
+            switch (subsetIndexing.index()) {
+                case TSubsetVariant::template TagOf<TFullSubset<ui32>>():
+                    return *this;
+                case TSubsetVariant::template TagOf<TRangesSubset<ui32>>():
+                    for (const auto& block : subsetIndexing.template Get<TRangesSubset<ui32>>().Blocks) {
+                        auto it = std::lower_bound(Indices.begin(), Indices.end(), block.SrcBegin);
+                        for (; (it != Indices.end()) && (*it < block.SrcEnd); ++it) {
+                            dstIndices.push_back(block.DstBegin + (*it - block.SrcBegin));
+                            dstValues.push_back(Values[it - Indices.begin()]);
+                        }
+                    }
+                    break;
+                case TSubsetVariant::template TagOf<TIndexedSubset<ui32>>():
+                    {
+                        const auto& srcIndices = subsetIndexing.template Get<TIndexedSubset<ui32>>();
+                        for (auto dstIdx : xrange(srcIndices.size())) {
+                            auto it = std::lower_bound(Indices.begin(), Indices.end(), srcIndices[dstIdx]);
+                            if ((it != Indices.end()) && (*it == srcIndices[dstIdx])) {
+                                dstIndices.push_back(dstIdx);
+                                dstValues.push_back(Values[it - Indices.begin()]);
+                            }
+                        }
+                    }
+                    break;
+            }
+            return TSparseArray(
+                subsetIndexing.Size(),
+                DefaultValue,
+                std::move(dstIndices),
+                std::move(dstValues)
+            );
+        }
+
+    private:
+        // bitwise for floats to treat NaN and -0.0f as non-default when DefaultValue is 0.0f
+        static bool IsDefault(TValue value, TValue defaultValue) {
+            return !std::memcmp(&value, &defaultValue, sizeof(TValue));
+        }
+
+    private:
+        ui32 Size;
+        TValue DefaultValue;
+        TVector<ui32> Indices; // sorted
+        TVector<TValue> Values;
+    };
+
+}
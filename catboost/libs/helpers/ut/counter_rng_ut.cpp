@@ -0,0 +1,59 @@
+#include <catboost/libs/helpers/counter_rng.h>
+
+#include <util/generic/vector.h>
+
+#include <library/unittest/registar.h>
+
+
+Y_UNIT_TEST_SUITE(TCounterRngTest) {
+    Y_UNIT_TEST(Philox4x32KnownAnswers) {
+        // test vectors from the Random123 distribution
+        const TPhiloxCounter zeros = Philox4x32({0, 0, 0, 0}, {0, 0});
+        UNIT_ASSERT_VALUES_EQUAL(zeros[0], 0x6627e8d5u);
+        UNIT_ASSERT_VALUES_EQUAL(zeros[1], 0xe169c58du);
+        UNIT_ASSERT_VALUES_EQUAL(zeros[2], 0xbc57ac4cu);
+        UNIT_ASSERT_VALUES_EQUAL(zeros[3], 0x9b00dbd8u);
+
+        const TPhiloxCounter pi = Philox4x32({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0});
+        UNIT_ASSERT_VALUES_EQUAL(pi[0], 0xd16cfe09u);
+        UNIT_ASSERT_VALUES_EQUAL(pi[1], 0x94fdccebu);
+        UNIT_ASSERT_VALUES_EQUAL(pi[2], 0x5001e420u);
+        UNIT_ASSERT_VALUES_EQUAL(pi[3], 0x24126ea1u);
+    }
+
+    Y_UNIT_TEST(IndependentOfBlocking) {
+        const ui64 seed = 42;
+        TVector<double> whole(1000);
+        GenerateRealPositive(seed, 0, whole);
+        TVector<double> blocked(1000);
+        for (size_t blockStart = 0; blockStart < blocked.size(); blockStart += 37) {
+            const size_t blockSize = Min<size_t>(37, blocked.size() - blockStart);
+            GenerateRealPositive(seed, blockStart, MakeArrayRef(blocked.data() + blockStart, blockSize));
+        }
+        UNIT_ASSERT_EQUAL(whole, blocked);
+
+        TCounterRng64 rng(seed);
+        for (double value : whole) {
+            UNIT_ASSERT_DOUBLES_EQUAL(value, ((rng.GenRand() >> 11) + 1) / 9007199254740992.0, 0);
+            UNIT_ASSERT(0 < value && value <= 1);
+        }
+    }
+
+    Y_UNIT_TEST(BayesianWeights) {
+        TVector<float> weights(10000);
+        GenerateBayesianWeights(/*seed*/ 0, /*firstCounter*/ 0, /*temperature*/ 1.0f, weights);
+        double sum = 0;
+        for (float weight : weights) {
+            UNIT_ASSERT(weight >= 0);
+            sum += weight;
+        }
+        // exponential distribution with mean 1
+        UNIT_ASSERT_DOUBLES_EQUAL(sum / weights.size(), 1.0, 0.05);
+
+        TVector<float> unitWeights(100);
+        GenerateBayesianWeights(/*seed*/ 0, /*firstCounter*/ 0, /*temperature*/ 0.0f, unitWeights);
+        for (float weight : unitWeights) {
+            UNIT_ASSERT_DOUBLES_EQUAL(weight, 1.0f, 1e-6);
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#include <catboost/libs/helpers/sparse_array.h>
+
+#include <util/generic/vector.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(TSparseArray) {
+    Y_UNIT_TEST(FromDense) {
+        const TVector<float> dense = {0.0f, 1.0f, 0.0f, 0.0f, -0.0f, 2.5f, 0.0f};
+        auto sparseArray = TSparseArray<float>::FromDense(dense, 0.0f);
+
+        UNIT_ASSERT_VALUES_EQUAL(sparseArray.GetSize(), 7);
+        UNIT_ASSERT_VALUES_EQUAL(sparseArray.GetNonDefaultSize(), 3);
+        UNIT_ASSERT_EQUAL(sparseArray.GetIndices(), TConstArrayRef<ui32>({1, 4, 5}));
+        UNIT_ASSERT_VALUES_EQUAL(sparseArray[0], 0.0f);
+        UNIT_ASSERT_VALUES_EQUAL(sparseArray[5], 2.5f);
+        UNIT_ASSERT_EQUAL(sparseArray.ExtractValues(), dense);
+    }
+
+    Y_UNIT_TEST(ExtractValuesRange) {
+        const TVector<ui32> dense = {7, 1, 7, 7, 2, 3, 7, 4};
+        auto sparseArray = TSparseArray<ui32>::FromDense(dense, 7);
+
+        for (ui32 begin : xrange(dense.size())) {
+            for (ui32 end : xrange(begin, (ui32)dense.size() + 1)) {
+                TVector<ui32> values(end - begin, 0);
+                sparseArray.ExtractValues(begin, values);
+                UNIT_ASSERT_EQUAL(values, TVector<ui32>(dense.begin() + begin, dense.begin() + end));
+            }
+        }
+    }
+
+    Y_UNIT_TEST(GetSubset) {
+        const TVector<ui32> dense = {7, 1, 7, 7, 2, 3, 7, 4};
+        auto sparseArray = TSparseArray<ui32>::FromDense(dense, 7);
+
+        TVector<TArraySubsetIndexing<ui32>> subsets;
+        subsets.emplace_back(TFullSubset<ui32>(dense.size()));
+        subsets.emplace_back(
+            TRangesSubset<ui32>(
+                5,
+                {TSubsetBlock<ui32>({5, 8}, 0), TSubsetBlock<ui32>({0, 2}, 3)}
+            )
+        );
+        subsets.emplace_back(TIndexedSubset<ui32>{7, 0, 4, 4, 2, 1});
+
+        for (const auto& subset : subsets) {
+            TVector<ui32> expected;
+            subset.ForEach([&] (ui32 /*idx*/, ui32 srcIdx) { expected.push_back(dense[srcIdx]); });
+
+            auto sparseSubset = sparseArray.GetSubset(subset);
+            UNIT_ASSERT_VALUES_EQUAL(sparseSubset.GetDefaultValue(), 7);
+            UNIT_ASSERT_EQUAL(sparseSubset.ExtractValues(), expected);
+            UNIT_ASSERT_EQUAL(sparseSubset, TSparseArray<ui32>::FromDense(expected, 7));
+        }
+    }
+}
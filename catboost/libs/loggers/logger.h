@@ -160,6 +160,9 @@ public:
             for (const auto& it : profileResults.OperationToTime) {
                 Stream << it.first << ": " << FloatToString(it.second, PREC_NDIGITS, 3) << " sec" << Endl;
             }
+            for (const auto& it : profileResults.CounterToValue) {
+                Stream << it.first << ": " << it.second << Endl;
+            }
             Stream << "Passed: " << FloatToString(profileResults.CurrentTime, PREC_NDIGITS, 3) << " sec" << Endl;
         }
         if (profileResults.IsIterationGood) {
@@ -194,6 +197,9 @@ public:
         for (const auto& it : profileResults.OperationToTime) {
             Stream << it.first << ": " << FloatToString(it.second, PREC_NDIGITS, 3) << " sec" << Endl;
         }
+        for (const auto& it : profileResults.CounterToValue) {
+            Stream << it.first << ": " << it.second << Endl;
+        }
         Stream << "Passed: " << FloatToString(profileResults.CurrentTime, PREC_NDIGITS, 3) << " sec" << Endl;
         if (profileResults.IsIterationGood) {
             Stream << "\ttotal: " << HumanReadable(TDuration::Seconds(profileResults.PassedTime));
@@ -249,6 +255,12 @@ public:
         for (const auto& it : profileResults.OperationToTime) {
             times[it.first] = it.second;
         }
+        if (!profileResults.CounterToValue.empty()) {
+            auto& counters = CurrentValue["counters"];
+            for (const auto& it : profileResults.CounterToValue) {
+                counters[it.first] = it.second;
+            }
+        }
 
         PassedIterations = profileResults.PassedIterations;
         OperationToTimeInAllIterations = profileResults.OperationToTimeInAllIterations;
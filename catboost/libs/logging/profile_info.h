@@ -16,7 +16,8 @@ struct TProfileResults {
         double currentTime = 0,
         int passedIterations = 0,
         TMap<TString, double> operationToTime = {},
-        TMap<TString, double> operationToTimeInAllIterations = {}
+        TMap<TString, double> operationToTimeInAllIterations = {},
+        TMap<TString, ui64> counterToValue = {}
     )
         : PassedTime(passedTime)
         , RemainingTime(remainingTime)
@@ -25,6 +26,7 @@ struct TProfileResults {
         , PassedIterations(passedIterations)
         , OperationToTime(operationToTime)
         , OperationToTimeInAllIterations(operationToTimeInAllIterations)
+        , CounterToValue(counterToValue)
     {
     }
 
@@ -35,6 +37,7 @@ struct TProfileResults {
     int PassedIterations;
     TMap<TString, double> OperationToTime;
     TMap<TString, double> OperationToTimeInAllIterations;
+    TMap<TString, ui64> CounterToValue;
 };
 
 struct TProfileInfoData {
@@ -90,6 +93,7 @@ public:
         CurrentTime = 0;
         Timer.Reset();
         OperationToTime.clear();
+        CounterToValue.clear();
     }
 
     void StartNextIteration() {
@@ -102,6 +106,10 @@ public:
         OperationToTime[operation] += passedTime; // operations can be repeated in one iteration
     }
 
+    void AddCounter(const TString& counter, ui64 value) {
+        CounterToValue[counter] += value;
+    }
+
     void FinishIterationBlock(int blockSize) {
         CurrentTime += Timer.PassedReset();
         OperationToTime["Iteration time"] = CurrentTime;
@@ -136,7 +144,8 @@ public:
             CurrentTime,
             ProfileData.PassedIterations,
             OperationToTime,
-            ProfileData.OperationToTimeInAllIterations
+            ProfileData.OperationToTimeInAllIterations,
+            CounterToValue
         };
     }
 
@@ -144,6 +153,7 @@ private:
     static constexpr int MAX_TIME_RATIO = 100;
     TProfileInfoData ProfileData;
     TMap<TString, double> OperationToTime;
+    TMap<TString, ui64> CounterToValue;
     THPTimer Timer;
     int InitIterations;
     bool IsIterationGood;
@@ -1,5 +1,6 @@
 #include "oblivious_tree_options.h"
 #include "json_helper.h"
+#include "restrictions.h"
 
 #include <catboost/libs/logging/logging_level.h>
 #include <catboost/libs/logging/logging.h>
@@ -83,8 +84,7 @@ void NCatboostOptions::TObliviousTreeLearnerOptions::Validate() const {
     BootstrapConfig.Get().Validate();
     const float rsm = Rsm.Get();
     CB_ENSURE(rsm > 0 && rsm <= 1, "Rsm should be in (0, 1]");
-    const ui32 maxModelDepth = 16;
-    CB_ENSURE(MaxDepth.Get() <= maxModelDepth, "Maximum depth is " << maxModelDepth);
+    CB_ENSURE(MaxDepth.Get() <= CB_MAX_TREE_DEPTH, "Maximum depth is " << CB_MAX_TREE_DEPTH);
     CB_ENSURE(DevScoreCalcObjBlockSize.GetUnchecked() > 0, "DevScoreCalcObjBlockSize must be > 0");
     CB_ENSURE(LeavesEstimationIterations.Get() > 0, "Leaves estimation iterations should be positive");
     CB_ENSURE(L2Reg.Get() >= 0, "L2LeafRegularizer should be >= 0, current value: " << L2Reg.Get());
@@ -53,5 +53,8 @@ constexpr ui32 GetMaxTreeCtrBinarizationForGpu() {
 
 
 //CPU restriction
-using TIndexType = ui32;
+constexpr ui32 CB_MAX_TREE_DEPTH = 16;
+// leaf index of a document during training, 2 bytes are enough for any allowed tree depth
+using TIndexType = ui16;
+static_assert(CB_MAX_TREE_DEPTH <= sizeof(TIndexType) * 8, "TIndexType is too small for CB_MAX_TREE_DEPTH");
 constexpr int CB_THREAD_LIMIT = 128;
@@ -72,6 +72,8 @@ namespace NCB {
                 return MakeHolder<TCpuGridBuilder<EBorderSelectionType::Median>>();
             case EBorderSelectionType::Uniform:
                 return MakeHolder<TCpuGridBuilder<EBorderSelectionType::Uniform>>();
+            case EBorderSelectionType::QuantileSketch:
+                return MakeHolder<TCpuGridBuilder<EBorderSelectionType::QuantileSketch>>();
         }
         ythrow yexception() << "Invalid grid builder type!";
     }
@@ -2,6 +2,7 @@
 
 #include <catboost/libs/helpers/array_subset.h>
 #include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/sparse_array.h>
 
 #include <catboost/libs/options/binarization_options.h>
 #include <catboost/libs/options/enums.h>
@@ -11,6 +12,8 @@
 #include <library/threading/local_executor/local_executor.h>
 
 #include <util/system/types.h>
+#include <util/system/yassert.h>
+#include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
 
@@ -57,6 +60,28 @@ namespace NCB {
     }
 
 
+    inline ui8 QuantizeValue(float srcValue,
+                             bool allowNans,
+                             ENanMode nanMode,
+                             ui32 featureIdx, // for error message
+                             TConstArrayRef<float> borders) {
+        if (IsNan(srcValue)) {
+            CB_ENSURE(
+                allowNans,
+                "There are NaNs in test dataset (feature number "
+                << featureIdx << ") but there were no NaNs in learn dataset"
+            );
+            return (nanMode == ENanMode::Max) ? borders.size() : 0;
+        } else {
+            size_t i = 0;
+            while (i < borders.size() && srcValue > borders[i]) {
+                ++i;
+            }
+            return (ui8)i;
+        }
+    }
+
+
     template <class TArrayLike>
     void Quantize(TArraySubset<TArrayLike, ui32> srcFeatureData,
                   bool allowNans,
@@ -71,26 +96,36 @@ namespace NCB {
         auto quantizedDataValue = *quantizedData;
         srcFeatureData.ParallelForEach(
             [=, &quantizedDataValue] (ui32 idx, float srcValue) {
-                if (IsNan(srcValue)) {
-                    CB_ENSURE(
-                        allowNans,
-                        "There are NaNs in test dataset (feature number "
-                        << featureIdx << ") but there were no NaNs in learn dataset"
-                    );
-                    quantizedDataValue[idx] = (nanMode == ENanMode::Max) ? borders.size() : 0;
-                } else {
-                    size_t i = 0;
-                    while (i < borders.size() && srcValue > borders[i]) {
-                        ++i;
-                    }
-                    quantizedDataValue[idx] = (ui8)i;
-                }
+                quantizedDataValue[idx] = QuantizeValue(srcValue, allowNans, nanMode, featureIdx, borders);
             },
             localExecutor,
             BINARIZATION_BLOCK_SIZE
         );
     }
 
+    // only non-default values are quantized one by one, the rest is filled with the default value bin
+    inline void Quantize(const TSparseArray<float>& srcFeatureData,
+                         bool allowNans,
+                         ENanMode nanMode,
+                         ui32 featureIdx, // for error message
+                         TConstArrayRef<float> borders,
+                         TArrayRef<ui8>* quantizedData) {
+        Y_ASSERT(quantizedData->size() == srcFeatureData.GetSize());
+
+        if (srcFeatureData.GetNonDefaultSize() < srcFeatureData.GetSize()) {
+            Fill(
+                quantizedData->begin(),
+                quantizedData->end(),
+                QuantizeValue(srcFeatureData.GetDefaultValue(), allowNans, nanMode, featureIdx, borders)
+            );
+        }
+        srcFeatureData.ForEachNonDefault(
+            [&] (ui32 idx, float srcValue) {
+                (*quantizedData)[idx] = QuantizeValue(srcValue, allowNans, nanMode, featureIdx, borders);
+            }
+        );
+    }
+
 
     inline ui32 GetSampleSizeForBorderSelectionType(ui32 vecSize,
                                                     EBorderSelectionType borderSelectionType,
@@ -1,9 +1,19 @@
 #include "quantized.h"
 
+#include <catboost/idl/pool/flat/quantized_chunk_t.fbs.h>
 #include <catboost/libs/column_description/column.h>
+#include <catboost/libs/data_types/groupid.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/quantization_schema/schema.h>
+#include <catboost/libs/quantization_schema/serialization.h>
+
+#include <contrib/libs/flatbuffers/include/flatbuffers/flatbuffers.h>
 
 #include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
+#include <util/generic/xrange.h>
+#include <util/memory/blob.h>
+#include <util/string/cast.h>
 
 THashMap<size_t, size_t> GetColumnIndexToFlatIndexMap(const NCB::TQuantizedPool& pool) {
     TVector<size_t> columnIndices;
@@ -129,3 +139,161 @@ TVector<ui32> GetIgnoredFlatIndices(const NCB::TQuantizedPool& pool) {
 
     return indices;
 }
+
+template <class T>
+static void AddColumnToPool(
+    EColumn columnType,
+    const TString& columnName,
+    TConstArrayRef<T> data, // empty for columns without data
+    NCB::TQuantizedPool* pool
+) {
+    constexpr size_t MAX_CHUNK_DOCUMENT_COUNT = 1 << 20;
+
+    const size_t columnIndex = pool->ColumnTypes.size();
+    pool->ColumnIndexToLocalIndex.emplace(columnIndex, columnIndex);
+    pool->ColumnTypes.push_back(columnType);
+    pool->ColumnNames.push_back(columnName);
+
+    TVector<NCB::TQuantizedPool::TChunkDescription> chunks;
+    flatbuffers::FlatBufferBuilder builder;
+    for (size_t documentOffset = 0; documentOffset < data.size(); documentOffset += MAX_CHUNK_DOCUMENT_COUNT) {
+        const size_t documentCount = Min(MAX_CHUNK_DOCUMENT_COUNT, data.size() - documentOffset);
+        builder.Clear();
+        builder.Finish(
+            NCB::NIdl::CreateTQuantizedFeatureChunk(
+                builder,
+                static_cast<NCB::NIdl::EBitsPerDocumentFeature>(sizeof(T) * 8),
+                builder.CreateVector(
+                    reinterpret_cast<const ui8*>(data.data() + documentOffset),
+                    sizeof(T) * documentCount
+                )
+            )
+        );
+        pool->Blobs.push_back(TBlob::Copy(builder.GetBufferPointer(), builder.GetSize()));
+        chunks.emplace_back(
+            documentOffset,
+            documentCount,
+            flatbuffers::GetRoot<NCB::NIdl::TQuantizedFeatureChunk>(pool->Blobs.back().AsCharPtr())
+        );
+    }
+    pool->Chunks.push_back(std::move(chunks));
+}
+
+static TVector<float> GetFloatTarget(TConstArrayRef<TString> target) {
+    TVector<float> result;
+    result.yresize(target.size());
+    for (auto i : xrange(target.size())) {
+        CB_ENSURE(
+            TryFromString(target[i], result[i]),
+            "Target value \"" << target[i] << "\" cannot be saved to quantized pool: only numeric targets are supported"
+        );
+    }
+    return result;
+}
+
+static TVector<float> GetWeights(const NCB::TWeights<float>& weights, ui32 objectCount) {
+    TVector<float> result;
+    result.yresize(objectCount);
+    for (auto i : xrange(objectCount)) {
+        result[i] = weights[i];
+    }
+    return result;
+}
+
+NCB::TQuantizedPool ConvertToQuantizedPool(
+    const NCB::TQuantizedDataProvider& dataProvider,
+    NPar::TLocalExecutor* localExecutor
+) {
+    const auto* objectsData = dynamic_cast<const NCB::TQuantizedForCPUObjectsDataProvider*>(
+        dataProvider.ObjectsData.Get()
+    );
+    CB_ENSURE(objectsData, "Only data quantized in CPU format can be saved to quantized pool");
+    CB_ENSURE(dataProvider.MetaInfo.ColumnsInfo, "Dataset has no columns information");
+
+    const ui32 objectCount = dataProvider.GetObjectCount();
+    const auto& featuresLayout = *dataProvider.MetaInfo.FeaturesLayout;
+    const auto& quantizedFeaturesInfo = *objectsData->GetQuantizedFeaturesInfo();
+    const auto& rawTargetData = dataProvider.RawTargetData;
+
+    NCB::TQuantizedPool pool;
+    pool.DocumentCount = objectCount;
+
+    NCB::TPoolQuantizationSchema quantizationSchema;
+
+    ui32 flatFeatureIdx = 0;
+    ui32 baselineIdx = 0;
+    for (const auto& column : dataProvider.MetaInfo.ColumnsInfo->Columns) {
+        switch (column.Type) {
+            case EColumn::Num: {
+                const auto floatFeatureIdx = featuresLayout.GetInternalFeatureIdx<EFeatureType::Float>(flatFeatureIdx);
+                const auto feature = objectsData->GetFloatFeature(*floatFeatureIdx);
+                if (feature) {
+                    quantizationSchema.FeatureIndices.push_back(flatFeatureIdx);
+                    quantizationSchema.Borders.push_back(quantizedFeaturesInfo.GetBorders(floatFeatureIdx));
+                    quantizationSchema.NanModes.push_back(quantizedFeaturesInfo.GetNanMode(floatFeatureIdx));
+                    const auto bins = (*feature)->ExtractValues(localExecutor);
+                    AddColumnToPool<ui8>(column.Type, column.Id, *bins, &pool);
+                } else {
+                    AddColumnToPool<ui8>(column.Type, column.Id, {}, &pool);
+                }
+                ++flatFeatureIdx;
+                break;
+            }
+            case EColumn::Categ:
+                CB_ENSURE(
+                    !featuresLayout.GetExternalFeaturesMetaInfo()[flatFeatureIdx].IsAvailable,
+                    "Categorical feature " << flatFeatureIdx << " cannot be saved: quantized pools do not "
+                    "support categorical features yet, ignore them to quantize this pool"
+                );
+                AddColumnToPool<ui8>(column.Type, column.Id, {}, &pool);
+                ++flatFeatureIdx;
+                break;
+            case EColumn::Label:
+                AddColumnToPool<float>(column.Type, column.Id, GetFloatTarget(*rawTargetData.GetTarget()), &pool);
+                break;
+            case EColumn::Baseline: {
+                const auto baseline = (*rawTargetData.GetBaseline())[baselineIdx];
+                const TVector<double> doubleBaseline(baseline.begin(), baseline.end());
+                AddColumnToPool<double>(column.Type, column.Id, doubleBaseline, &pool);
+                ++baselineIdx;
+                break;
+            }
+            case EColumn::Weight:
+                AddColumnToPool<float>(
+                    column.Type,
+                    column.Id,
+                    GetWeights(rawTargetData.GetWeights(), objectCount),
+                    &pool
+                );
+                break;
+            case EColumn::GroupWeight:
+                AddColumnToPool<float>(
+                    column.Type,
+                    column.Id,
+                    GetWeights(rawTargetData.GetGroupWeights(), objectCount),
+                    &pool
+                );
+                break;
+            case EColumn::GroupId:
+                AddColumnToPool<TGroupId>(column.Type, column.Id, *objectsData->GetGroupIds(), &pool);
+                break;
+            case EColumn::SubgroupId:
+                AddColumnToPool<TSubgroupId>(column.Type, column.Id, *objectsData->GetSubgroupIds(), &pool);
+                break;
+            case EColumn::Auxiliary:
+            case EColumn::DocId:
+                break;
+            case EColumn::Timestamp:
+                CB_ENSURE(
+                    false,
+                    "Timestamp column cannot be saved: quantized pools do not support timestamps yet, "
+                    "mark it as Auxiliary in the column description to quantize this pool"
+                );
+            default:
+                CB_ENSURE(false, "Column type " << column.Type << " cannot be saved to quantized pool");
+        }
+    }
+
+    pool.QuantizationSchema = NCB::QuantizationSchemaToProto(quantizationSchema);
+    return pool;
+}
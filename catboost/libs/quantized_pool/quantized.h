@@ -2,8 +2,11 @@
 
 #include "pool.h"
 
+#include <catboost/libs/data_new/data_provider.h>
 #include <catboost/libs/data_new/meta_info.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
 #include <util/generic/hash.h>
 #include <util/generic/vector.h>
 
@@ -29,3 +32,13 @@ TVector<int> GetCategoricalFeatureIndices(const NCB::TQuantizedPool& pool);
 // Returns flat indices of all ignored features
 // Sorted from min to max
 TVector<ui32> GetIgnoredFlatIndices(const NCB::TQuantizedPool& pool);
+
+// Converts dataset quantized in CPU format to the form that can be saved with `SaveQuantizedPool`.
+//
+// Quantized pools do not support categorical features and timestamps yet, so throws if the dataset has
+// Timestamp column or categorical features that are not ignored (ignored ones are saved as empty columns).
+// Auxiliary and DocId columns are skipped.
+NCB::TQuantizedPool ConvertToQuantizedPool(
+    const NCB::TQuantizedDataProvider& dataProvider,
+    NPar::TLocalExecutor* localExecutor
+);
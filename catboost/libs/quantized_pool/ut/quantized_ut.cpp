@@ -0,0 +1,170 @@
+#include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/data_new/load_data.h>
+#include <catboost/libs/data_new/quantization.h>
+#include <catboost/libs/data_new/ut/lib/for_loader.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/quantized_pool/quantized.h>
+#include <catboost/libs/quantized_pool/serialization.h>
+
+#include <util/generic/xrange.h>
+#include <util/stream/file.h>
+#include <util/system/mktemp.h>
+#include <util/system/tempfile.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+using namespace NCB::NDataNewUT;
+
+
+Y_UNIT_TEST_SUITE(ConvertToQuantizedPool) {
+    static const TStringBuf DSV_FILE_DATA = AsStringBuf(
+        "0\t0.1\t0.2\ta\t1\n"
+        "1\t0.97\tnan\tb\t2\n"
+        "0\t0.13\t0.22\ta\t2\n"
+        "1\t0.5\t0.0\tc\t1\n"
+        "0\t0.3\t0.7\tb\t3\n"
+        "1\t0.97\t0.11\ta\t1\n"
+        "0\t0.0\t0.9\tc\t4\n"
+    );
+
+    static const NCatboostOptions::TBinarizationOptions BINARIZATION_OPTIONS(
+        EBorderSelectionType::GreedyLogSum,
+        4,
+        ENanMode::Min
+    );
+
+    static TQuantizedDataProviderPtr ReadAndQuantize(
+        const TReadDatasetMainParams& readDatasetMainParams,
+        const TVector<ui32>& ignoredFeatures,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        TQuantizationOptions quantizationOptions;
+        quantizationOptions.GpuCompatibleFormat = false;
+
+        TRestorableFastRng64 rand(0);
+
+        return ReadAndQuantizeDataset(
+            readDatasetMainParams.PoolPath,
+            readDatasetMainParams.PairsFilePath,
+            readDatasetMainParams.GroupWeightsFilePath,
+            readDatasetMainParams.DsvPoolFormatParams,
+            ignoredFeatures,
+            EObjectsOrder::Undefined,
+            quantizationOptions,
+            /*quantizedFeaturesInfo*/ nullptr,
+            BINARIZATION_OPTIONS,
+            /*initQuantizedFeaturesInfo*/ {},
+            &rand,
+            localExecutor
+        )->CastMoveTo<TQuantizedObjectsDataProvider>();
+    }
+
+    Y_UNIT_TEST(SameAsQuantizeAfterLoading) {
+        TSrcData srcData;
+        srcData.CdFileData = AsStringBuf("0\tTarget\n" "3\tCateg\n" "4\tWeight\n");
+        srcData.DsvFileData = DSV_FILE_DATA;
+
+        TReadDatasetMainParams readDatasetMainParams;
+        TVector<THolder<TTempFile>> srcDataFiles;
+        SaveSrcData(srcData, &readDatasetMainParams, &srcDataFiles);
+
+        const TVector<ui32> ignoredFeatures = {2}; // categorical feature
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        const TQuantizedPool quantizedPool = ConvertToQuantizedPool(
+            *ReadAndQuantize(readDatasetMainParams, ignoredFeatures, &localExecutor),
+            &localExecutor
+        );
+
+        TTempFile quantizedPoolFile(MakeTempName());
+        {
+            TFileOutput output(quantizedPoolFile.Name());
+            SaveQuantizedPool(quantizedPool, &output);
+        }
+
+        auto loadedData = ReadDataset(
+            TPathWithScheme("quantized://" + quantizedPoolFile.Name()),
+            /*pairsFilePath*/ TPathWithScheme(),
+            /*groupWeightsFilePath*/ TPathWithScheme(),
+            NCatboostOptions::TDsvPoolFormatParams(),
+            /*ignoredFeatures*/ {},
+            EObjectsOrder::Undefined,
+            &localExecutor
+        )->CastMoveTo<TQuantizedForCPUObjectsDataProvider>();
+
+        // in-memory quantization of the same data as in fit
+        TDataProviderPtr rawData = ReadDataset(
+            readDatasetMainParams.PoolPath,
+            readDatasetMainParams.PairsFilePath,
+            readDatasetMainParams.GroupWeightsFilePath,
+            readDatasetMainParams.DsvPoolFormatParams,
+            ignoredFeatures,
+            EObjectsOrder::Undefined,
+            &localExecutor
+        );
+        TQuantizationOptions quantizationOptions;
+        quantizationOptions.GpuCompatibleFormat = false;
+        auto quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+            *rawData->MetaInfo.FeaturesLayout,
+            TConstArrayRef<ui32>(),
+            BINARIZATION_OPTIONS
+        );
+        TRestorableFastRng64 rand(0);
+        auto quantizedData = Quantize(
+            quantizationOptions,
+            rawData->CastMoveTo<TRawObjectsDataProvider>(),
+            quantizedFeaturesInfo,
+            &rand,
+            &localExecutor
+        )->CastMoveTo<TQuantizedForCPUObjectsDataProvider>();
+
+        UNIT_ASSERT_VALUES_EQUAL(loadedData->GetObjectCount(), quantizedData->GetObjectCount());
+        UNIT_ASSERT_EQUAL(loadedData->RawTargetData.GetTarget(), quantizedData->RawTargetData.GetTarget());
+        UNIT_ASSERT_EQUAL(loadedData->RawTargetData.GetWeights(), quantizedData->RawTargetData.GetWeights());
+
+        const auto& loadedQuantizedFeaturesInfo = *loadedData->ObjectsData->GetQuantizedFeaturesInfo();
+        for (auto floatFeatureIdx : xrange(2)) {
+            UNIT_ASSERT_EQUAL(
+                loadedQuantizedFeaturesInfo.GetBorders(TFloatFeatureIdx(floatFeatureIdx)),
+                quantizedFeaturesInfo->GetBorders(TFloatFeatureIdx(floatFeatureIdx))
+            );
+            UNIT_ASSERT_EQUAL(
+                loadedQuantizedFeaturesInfo.GetNanMode(TFloatFeatureIdx(floatFeatureIdx)),
+                quantizedFeaturesInfo->GetNanMode(TFloatFeatureIdx(floatFeatureIdx))
+            );
+            UNIT_ASSERT_EQUAL(
+                *(*loadedData->ObjectsData->GetFloatFeature(floatFeatureIdx))->ExtractValues(&localExecutor),
+                *(*quantizedData->ObjectsData->GetFloatFeature(floatFeatureIdx))->ExtractValues(&localExecutor)
+            );
+        }
+        UNIT_ASSERT(!loadedData->MetaInfo.FeaturesLayout->GetExternalFeaturesMetaInfo()[2].IsAvailable);
+    }
+
+    static void TestUnsupportedData(TStringBuf cdFileData) {
+        TSrcData srcData;
+        srcData.CdFileData = cdFileData;
+        srcData.DsvFileData = DSV_FILE_DATA;
+
+        TReadDatasetMainParams readDatasetMainParams;
+        TVector<THolder<TTempFile>> srcDataFiles;
+        SaveSrcData(srcData, &readDatasetMainParams, &srcDataFiles);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        auto quantizedData = ReadAndQuantize(readDatasetMainParams, /*ignoredFeatures*/ {}, &localExecutor);
+        UNIT_ASSERT_EXCEPTION(ConvertToQuantizedPool(*quantizedData, &localExecutor), TCatBoostException);
+    }
+
+    Y_UNIT_TEST(CatFeaturesAreNotSupported) {
+        TestUnsupportedData(AsStringBuf("0\tTarget\n" "3\tCateg\n" "4\tWeight\n"));
+    }
+
+    Y_UNIT_TEST(TimestampIsNotSupported) {
+        TestUnsupportedData(AsStringBuf("0\tTarget\n" "3\tAuxiliary\n" "4\tTimestamp\n"));
+    }
+}
@@ -44,6 +44,8 @@
 #include <util/system/hp_timer.h>
 #include <util/system/info.h>
 
+#include <functional>
+
 
 using namespace NCB;
 
@@ -258,6 +260,28 @@ static void Train(
         ); // TODO(espetrov): create only if sample rate < 1
     }
 
+    // All metrics except the error tracker one are evaluated while the next tree is built,
+    // so an iteration with such metrics is logged after the next tree is ready.
+    // Callbacks may inspect metrics of the current iteration and custom metrics may be not thread-safe.
+    THolder<TBackgroundErrorsCalcer> backgroundErrorsCalcer;
+    if (ctx->Params.SystemOptions->IsSingleHost()
+        && !onEndIterationCallback
+        && !ctx->ObjectiveDescriptor.Defined()
+        && !ctx->EvalMetricDescriptor.Defined())
+    {
+        backgroundErrorsCalcer = MakeHolder<TBackgroundErrorsCalcer>();
+    }
+    std::function<void()> logPendingIteration;
+    const auto finishPendingIteration = [&] () {
+        if (backgroundErrorsCalcer) {
+            backgroundErrorsCalcer->Finish(&ctx->LearnProgress.MetricsAndTimeHistory);
+        }
+        if (logPendingIteration) {
+            logPendingIteration();
+            logPendingIteration = nullptr;
+        }
+    };
+
     THPTimer timer;
     for (ui32 iter = ctx->LearnProgress.TreeStruct.ysize();
          continueTraining && (iter < ctx->Params.BoostingOptions->IterationCount);
@@ -273,11 +297,16 @@ static void Train(
 
         if (timer.Passed() > ctx->OutputOptions.GetSnapshotSaveInterval()) {
             profile.AddOperation("Save snapshot");
+            finishPendingIteration();
+            if (ctx->OutputOptions.SaveSnapshot()) {
+                ctx->TestApproxUpdater.UpdateAll(data.Test, ctx->LocalExecutor, &ctx->LearnProgress.TestApprox);
+            }
             ctx->SaveProgress();
             timer.Reset();
         }
 
-        TrainOneIteration(data, ctx);
+        TrainOneIteration(data, ctx, backgroundErrorsCalcer.Get());
+        finishPendingIteration();
 
         bool calcAllMetrics = DivisibleOrLastIteration(
             iter,
@@ -286,7 +315,7 @@ static void Train(
         );
         const bool calcErrorTrackerMetric = calcAllMetrics || errorTracker.IsActive();
 
-        CalcErrors(data, metrics, calcAllMetrics, calcErrorTrackerMetric, ctx);
+        CalcErrors(data, metrics, calcAllMetrics, calcErrorTrackerMetric, ctx, backgroundErrorsCalcer.Get());
 
         profile.AddOperation("Calc errors");
         if (hasTest && calcErrorTrackerMetric) {
@@ -307,19 +336,26 @@ static void Train(
         TProfileResults profileResults = profile.GetProfileResults();
         ctx->LearnProgress.MetricsAndTimeHistory.TimeHistory.push_back({profileResults.PassedTime, profileResults.RemainingTime});
 
-        Log(
-            iter,
-            GetMetricsDescription(metrics),
-            ctx->LearnProgress.MetricsAndTimeHistory.LearnMetricsHistory,
-            ctx->LearnProgress.MetricsAndTimeHistory.TestMetricsHistory,
-            errorTracker.GetBestError(),
-            errorTracker.GetBestIteration(),
-            profileResults,
-            learnToken,
-            testTokens,
-            calcAllMetrics,
-            &logger
-        );
+        logPendingIteration = [&, iter, calcAllMetrics, profileResults,
+                               bestError = errorTracker.GetBestError(),
+                               bestIteration = errorTracker.GetBestIteration()] () {
+            Log(
+                iter,
+                GetMetricsDescription(metrics),
+                ctx->LearnProgress.MetricsAndTimeHistory.LearnMetricsHistory,
+                ctx->LearnProgress.MetricsAndTimeHistory.TestMetricsHistory,
+                bestError,
+                bestIteration,
+                profileResults,
+                learnToken,
+                testTokens,
+                calcAllMetrics,
+                &logger
+            );
+        };
+        if (!backgroundErrorsCalcer || !backgroundErrorsCalcer->HasPendingErrors()) {
+            finishPendingIteration();
+        }
 
         if (HasInvalidValues(ctx->LearnProgress.LeafValues)) {
             ctx->LearnProgress.LeafValues.pop_back();
@@ -334,7 +370,11 @@ static void Train(
         }
     }
 
+    finishPendingIteration();
+
+    ctx->TestApproxUpdater.UpdateAll(data.Test, ctx->LocalExecutor, &ctx->LearnProgress.TestApprox);
     ctx->SaveProgress();
+    ctx->WaitForSavedProgress();
 
     if (hasTest) {
         (*testMultiApprox) = ctx->LearnProgress.TestApprox;
@@ -21,6 +21,8 @@
 
 using NCB::TEvalResult;
 
+class TBackgroundErrorsCalcer;
+
 // returns whether training should be continued
 using TOnEndIterationCallback = std::function<bool(const TMetricsAndTimeLeftHistory&)>;
 
@@ -64,6 +66,10 @@ void TrainModel(
     TMetricsAndTimeLeftHistory* metricsAndTimeHistory = nullptr);
 
 /// Used by cross validation, hence one test dataset.
-void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnContext* ctx);
+void TrainOneIteration(
+    const NCB::TTrainingForCPUDataProviders& data,
+    TLearnContext* ctx,
+    TBackgroundErrorsCalcer* backgroundErrorsCalcer
+);
 
 using TTrainerFactory = NObjectFactory::TParametrizedObjectFactory<IModelTrainer, ETaskType>;
@@ -281,7 +281,6 @@ cdef extern from "catboost/libs/data_new/objects.h" namespace "NCB":
         TMaybeData[TConstArrayRef[TGroupId]] GetGroupIds()
         TMaybeData[TConstArrayRef[TSubgroupId]] GetSubgroupIds()
         TMaybeData[TConstArrayRef[ui64]] GetTimestamp()
-        const THashMap[ui32, TString]& GetCatFeaturesHashToString(ui32 catFeatureIdx) except +ProcessException
 
     cdef cppclass TRawObjectsDataProvider(TObjectsDataProvider):
         void SetGroupIds(TConstArrayRef[TStringBuf] groupStringIds) except +ProcessException
@@ -401,7 +400,7 @@ cdef extern from "catboost/libs/data_new/visitor.h" namespace "NCB":
         void Start(
             bool_t inBlock,
             const TDataMetaInfo& metaInfo,
-            ui32 objectCount,
+            TMaybe[ui32] objectCount,
             EObjectsOrder objectsOrder,
             TVector[TIntrusivePtr[IResourceHolder]] resourceHolders
         ) except +ProcessException
@@ -1888,7 +1887,7 @@ cdef class _PoolBase:
         builder_visitor[0].Start(
             False,
             data_meta_info,
-            _get_object_count(data),
+            TMaybe[ui32](<ui32>_get_object_count(data)),
             EObjectsOrder_Undefined,
             resource_holders
         )
@@ -2175,22 +2174,18 @@ cdef class _PoolBase:
         -------
         hash_to_string : map
         """
-        cdef const THashMap[ui32, TString]* cat_features_hash_to_string
+        cdef THashMap[ui32, TString] cat_features_hash_to_string = MergeCatFeaturesHashToString(
+            self.__pool.Get()[0].ObjectsData.Get()[0]
+        )
 
         hash_to_string = {}
 
-        cat_feature_count = self.__pool.Get()[0].MetaInfo.FeaturesLayout.Get()[0].GetCatFeatureCount()
-        for cat_feature_idx in range(cat_feature_count):
-            cat_features_hash_to_string = &(
-                self.__pool.Get()[0].ObjectsData.Get()[0].GetCatFeaturesHashToString(cat_feature_idx)
-            )
-
-            # can't use canonical for loop here due to Cython's bugs:
-            # https://github.com/cython/cython/issues/1451
-            it = cat_features_hash_to_string[0].const_begin()
-            while it != cat_features_hash_to_string[0].const_end():
-                hash_to_string[ConvertCatFeatureHashToFloat(dereference(it).first)] = to_native_str(dereference(it).second)
-                preincrement(it)
+        # can't use canonical for loop here due to Cython's bugs:
+        # https://github.com/cython/cython/issues/1451
+        it = cat_features_hash_to_string.const_begin()
+        while it != cat_features_hash_to_string.const_end():
+            hash_to_string[ConvertCatFeatureHashToFloat(dereference(it).first)] = to_native_str(dereference(it).second)
+            preincrement(it)
 
         return hash_to_string
 
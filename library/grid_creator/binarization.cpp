@@ -1,4 +1,5 @@
 #include "binarization.h"
+#include "quantile_sketch.h"
 
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
@@ -55,6 +56,14 @@ namespace {
                                     int bordersCount,
                                     bool isSorted) const override;
     };
+
+    // Works in O(n * log(k)), values are not sorted.
+    class TQuantileSketchBinarizer: public IBinarizer {
+    public:
+        THashSet<float> BestSplit(TVector<float>& featureValues,
+                                    int bordersCount,
+                                    bool isSorted) const override;
+    };
 }
 
 namespace NSplitSelection {
@@ -72,6 +81,8 @@ namespace NSplitSelection {
                 return MakeHolder<TMedianBinarizer>();
             case EBorderSelectionType::Uniform:
                 return MakeHolder<TUniformBinarizer>();
+            case EBorderSelectionType::QuantileSketch:
+                return MakeHolder<TQuantileSketchBinarizer>();
         }
 
         ythrow yexception() << "got invalid enum value: " << static_cast<int>(type);
@@ -100,12 +111,13 @@ THashSet<float> BestSplit(TVector<float>& features,
         return {};
     }
 
-    if (!featuresAreSorted) {
+    if (!featuresAreSorted && (type != EBorderSelectionType::QuantileSketch)) {
         Sort(features.begin(), features.end());
+        featuresAreSorted = true;
     }
 
     const auto binarizer = NSplitSelection::MakeBinarizer(type);
-    return binarizer->BestSplit(features, bordersCount, true);
+    return binarizer->BestSplit(features, bordersCount, featuresAreSorted);
 }
 
 namespace {
@@ -769,6 +781,16 @@ THashSet<float> TUniformBinarizer::BestSplit(TVector<float>& featureValues,
     return borders;
 }
 
+THashSet<float> TQuantileSketchBinarizer::BestSplit(TVector<float>& featureValues,
+                                                       int bordersCount,
+                                                       bool /*isSorted*/) const {
+    NSplitSelection::TQuantileSketch sketch;
+    for (float value : featureValues) {
+        sketch.Add(value);
+    }
+    return sketch.GetBorders(bordersCount);
+}
+
 namespace {
     class TFeatureBin {
     private:
@@ -30,7 +30,8 @@ static bool TryParse(const int data, EBorderSelectionType* const borderSelection
         || data == (int)EBorderSelectionType::UniformAndQuantiles
         || data == (int)EBorderSelectionType::MinEntropy
         || data == (int)EBorderSelectionType::MaxLogSum
-        || data == (int)EBorderSelectionType::Uniform;
+        || data == (int)EBorderSelectionType::Uniform
+        || data == (int)EBorderSelectionType::QuantileSketch;
     if (!isValid) {
         return false;
     }
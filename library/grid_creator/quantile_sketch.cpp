@@ -0,0 +1,194 @@
+#include "quantile_sketch.h"
+
+#include <util/generic/algorithm.h>
+#include <util/generic/hash_set.h>
+#include <util/generic/utility.h>
+#include <util/generic/ymath.h>
+#include <util/system/yassert.h>
+
+#include <cmath>
+
+namespace {
+    // capacity of each next lower level is this fraction of the capacity of the level above it
+    constexpr double LevelCapacityDecay = 2.0 / 3.0;
+    constexpr ui32 MinLevelCapacity = 2;
+}
+
+namespace NSplitSelection {
+    TQuantileSketch::TQuantileSketch(ui32 k)
+        : K(::Max(k, MinLevelCapacity))
+        , Levels(1)
+        , Rand(/*seed*/ 0)
+    {
+        UpdateTotalCapacity();
+    }
+
+    void TQuantileSketch::Add(float value) {
+        if (IsNan(value)) {
+            ++NanCount;
+            return;
+        }
+        if (Count == 0) {
+            Min = value;
+            Max = value;
+        } else {
+            Min = ::Min(Min, value);
+            Max = ::Max(Max, value);
+        }
+        ++Count;
+
+        Levels[0].push_back(value);
+        ++Size;
+        CompressIfNeeded();
+    }
+
+    void TQuantileSketch::Merge(const TQuantileSketch& rhs) {
+        NanCount += rhs.NanCount;
+        if (rhs.Count == 0) {
+            return;
+        }
+        if (Count == 0) {
+            Min = rhs.Min;
+            Max = rhs.Max;
+        } else {
+            Min = ::Min(Min, rhs.Min);
+            Max = ::Max(Max, rhs.Max);
+        }
+        Count += rhs.Count;
+
+        if (Levels.size() < rhs.Levels.size()) {
+            Levels.resize(rhs.Levels.size());
+            UpdateTotalCapacity();
+        }
+        for (size_t level = 0; level < rhs.Levels.size(); ++level) {
+            Levels[level].insert(Levels[level].end(), rhs.Levels[level].begin(), rhs.Levels[level].end());
+            Size += rhs.Levels[level].size();
+        }
+        CompressIfNeeded();
+    }
+
+    TVector<std::pair<float, ui64>> TQuantileSketch::GetWeightedValues() const {
+        TVector<std::pair<float, ui64>> weightedValues;
+        weightedValues.reserve(Size);
+        for (size_t level = 0; level < Levels.size(); ++level) {
+            const ui64 weight = ui64(1) << level;
+            for (float value : Levels[level]) {
+                weightedValues.emplace_back(value, weight);
+            }
+        }
+        Sort(weightedValues.begin(), weightedValues.end());
+
+        // merge equal values
+        size_t dstIdx = 0;
+        for (size_t srcIdx = 0; srcIdx < weightedValues.size(); ++srcIdx) {
+            if (dstIdx && (weightedValues[dstIdx - 1].first == weightedValues[srcIdx].first)) {
+                weightedValues[dstIdx - 1].second += weightedValues[srcIdx].second;
+            } else {
+                weightedValues[dstIdx++] = weightedValues[srcIdx];
+            }
+        }
+        weightedValues.resize(dstIdx);
+        return weightedValues;
+    }
+
+    float TQuantileSketch::GetQuantile(double fraction) const {
+        Y_VERIFY(Count > 0);
+        if (fraction <= 0.0) {
+            return Min;
+        }
+        if (fraction >= 1.0) {
+            return Max;
+        }
+        const ui64 rank = ::Min<ui64>(ui64(fraction * Count), Count - 1);
+
+        ui64 cumulativeWeight = 0;
+        for (const auto& weightedValue : GetWeightedValues()) {
+            cumulativeWeight += weightedValue.second;
+            if (cumulativeWeight > rank) {
+                return weightedValue.first;
+            }
+        }
+        return Max;
+    }
+
+    THashSet<float> TQuantileSketch::GetBorders(int bordersCount) const {
+        THashSet<float> result;
+        if ((Count == 0) || (Min == Max) || (bordersCount <= 0)) {
+            return result;
+        }
+
+        const auto weightedValues = GetWeightedValues();
+
+        size_t valueIdx = 0;
+        ui64 weightBefore = 0; // total weight of values before weightedValues[valueIdx]
+        for (int i = 0; i < bordersCount; ++i) {
+            const ui64 rank = ::Min<ui64>((i + 1) * Count / (bordersCount + 1), Count - 1);
+            while (weightBefore + weightedValues[valueIdx].second <= rank) {
+                weightBefore += weightedValues[valueIdx].second;
+                ++valueIdx;
+            }
+            if (valueIdx == 0) { // border would be below all values
+                continue;
+            }
+            const float prevValue = weightedValues[valueIdx - 1].first;
+            const float value = weightedValues[valueIdx].first;
+            float border = (prevValue + value) * .5f;
+            if (border == value) { // wrong side rounding (should be very scarce)
+                border = prevValue;
+            }
+            result.insert(border);
+        }
+        return result;
+    }
+
+    ui32 TQuantileSketch::GetLevelCapacity(size_t level) const {
+        const size_t depth = Levels.size() - level - 1;
+        return ::Max<ui32>(
+            (ui32)std::ceil(K * std::pow(LevelCapacityDecay, (double)depth)),
+            MinLevelCapacity
+        );
+    }
+
+    void TQuantileSketch::UpdateTotalCapacity() {
+        TotalCapacity = 0;
+        for (size_t level = 0; level < Levels.size(); ++level) {
+            TotalCapacity += GetLevelCapacity(level);
+        }
+    }
+
+    void TQuantileSketch::CompressIfNeeded() {
+        while (Size >= TotalCapacity) {
+            for (size_t level = 0; level < Levels.size(); ++level) {
+                if (Levels[level].size() >= GetLevelCapacity(level)) {
+                    CompactLevel(level);
+                    break;
+                }
+            }
+        }
+    }
+
+    /* Sorts the level and moves every other value (starting from a random one of the first two)
+     * to the next level where its weight doubles, the other half is discarded.
+     */
+    void TQuantileSketch::CompactLevel(size_t level) {
+        if (level + 1 == Levels.size()) {
+            Levels.emplace_back();
+            UpdateTotalCapacity();
+        }
+
+        auto& values = Levels[level];
+        Sort(values.begin(), values.end());
+
+        // with odd number of values the largest one stays at this level
+        const size_t compactedSize = values.size() & ~size_t(1);
+        const size_t offset = Rand.GenRand() & 1;
+
+        auto& nextLevelValues = Levels[level + 1];
+        for (size_t i = offset; i < compactedSize; i += 2) {
+            nextLevelValues.push_back(values[i]);
+        }
+        values.erase(values.begin(), values.begin() + compactedSize);
+
+        Size -= compactedSize / 2;
+    }
+}
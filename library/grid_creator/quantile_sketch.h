@@ -0,0 +1,80 @@
+#pragma once
+
+#include <util/generic/fwd.h>
+#include <util/generic/vector.h>
+#include <util/random/fast.h>
+#include <util/system/types.h>
+
+#include <utility>
+
+namespace NSplitSelection {
+    /* Mergeable approximate quantiles summary of a stream of float values (KLL sketch, see
+     * Karnin, Lang, Liberty, "Optimal Quantile Approximation in Streams", 2016).
+     *
+     * Memory is O(K) floats regardless of the number of added values, Add is amortized O(log(K)).
+     * Rank of any value computed from the sketch differs from the exact one by at most ~1.65% of
+     * GetCount() with 99% probability for the default K = 200 (error is proportional to 1 / K).
+     * Merging does not increase the error, so sketches can be built for parts of the data (blocks,
+     * threads or hosts) independently and merged afterwards.
+     *
+     * NaNs are not included in the summary, only counted.
+     * Results are deterministic for the same sequence of Add and Merge calls.
+     */
+    class TQuantileSketch {
+    public:
+        static constexpr ui32 DefaultK = 200;
+
+    public:
+        explicit TQuantileSketch(ui32 k = DefaultK);
+
+        void Add(float value);
+        void Merge(const TQuantileSketch& rhs);
+
+        // number of non-NaN values added
+        ui64 GetCount() const {
+            return Count;
+        }
+
+        ui64 GetNanCount() const {
+            return NanCount;
+        }
+
+        // exact, defined only if GetCount() > 0
+        float GetMin() const {
+            return Min;
+        }
+        float GetMax() const {
+            return Max;
+        }
+
+        // sorted distinct values retained in the sketch with their weights, weights sum is GetCount()
+        TVector<std::pair<float, ui64>> GetWeightedValues() const;
+
+        // approximate value with rank = fraction * GetCount(), fraction is in [0, 1]
+        float GetQuantile(double fraction) const;
+
+        /* same semantics as Median border selection over all added values:
+         * borders are placed between neighbouring values at ranks i * GetCount() / (bordersCount + 1)
+         */
+        THashSet<float> GetBorders(int bordersCount) const;
+
+    private:
+        ui32 GetLevelCapacity(size_t level) const;
+        void UpdateTotalCapacity();
+        void CompressIfNeeded();
+        void CompactLevel(size_t level);
+
+    private:
+        ui32 K;
+        ui64 Count = 0;
+        ui64 NanCount = 0;
+        float Min = 0.0f;
+        float Max = 0.0f;
+
+        TVector<TVector<float>> Levels; // values at level h have weight 2^h
+        size_t Size = 0; // total number of values in Levels
+        size_t TotalCapacity = 0;
+
+        TReallyFastRng32 Rand;
+    };
+}
@@ -0,0 +1,103 @@
+#include <library/unittest/registar.h>
+
+#include <library/grid_creator/binarization.h>
+#include <library/grid_creator/quantile_sketch.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/hash_set.h>
+#include <util/generic/vector.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+
+#include <limits>
+
+using NSplitSelection::TQuantileSketch;
+
+static TVector<float> GenerateValues(size_t count, ui64 seed) {
+    TReallyFastRng32 rng(seed);
+    TVector<float> values;
+    values.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        // skewed distribution
+        values.push_back(float(rng.Uniform(1000)) * rng.GenRandReal1());
+    }
+    return values;
+}
+
+// max difference between exact and sketch ranks of the values retained in sketch divided by count
+static double CalcMaxRankError(const TQuantileSketch& sketch, TVector<float> values) {
+    Sort(values.begin(), values.end());
+
+    double maxError = 0.0;
+    ui64 sketchRank = 0;
+    for (const auto& weightedValue : sketch.GetWeightedValues()) {
+        sketchRank += weightedValue.second;
+        const ui64 exactRank = UpperBound(values.begin(), values.end(), weightedValue.first) - values.begin();
+        maxError = Max(maxError, Abs(double(exactRank) - double(sketchRank)) / values.size());
+    }
+    return maxError;
+}
+
+Y_UNIT_TEST_SUITE(QuantileSketchTests) {
+    Y_UNIT_TEST(TestExactForSmallData) {
+        auto values = GenerateValues(TQuantileSketch::DefaultK - 1, 0);
+
+        TQuantileSketch sketch;
+        for (auto value : values) {
+            sketch.Add(value);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetCount(), values.size());
+        UNIT_ASSERT_VALUES_EQUAL(CalcMaxRankError(sketch, values), 0.0);
+
+        const auto medianBorders = BestSplit(values, 16, EBorderSelectionType::Median);
+        UNIT_ASSERT_EQUAL(sketch.GetBorders(16), medianBorders);
+    }
+
+    Y_UNIT_TEST(TestRankError) {
+        const auto values = GenerateValues(300000, 0);
+
+        TQuantileSketch sketch;
+        for (auto value : values) {
+            sketch.Add(value);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetCount(), values.size());
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetMin(), *MinElement(values.begin(), values.end()));
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetMax(), *MaxElement(values.begin(), values.end()));
+        UNIT_ASSERT(sketch.GetWeightedValues().size() < 3 * TQuantileSketch::DefaultK);
+        UNIT_ASSERT(CalcMaxRankError(sketch, values) < 0.0165);
+
+        const auto borders = sketch.GetBorders(254);
+        UNIT_ASSERT(borders.size() > 200);
+        UNIT_ASSERT(borders.size() <= 254);
+    }
+
+    Y_UNIT_TEST(TestMerge) {
+        TVector<float> allValues;
+        TQuantileSketch mergedSketch;
+        for (ui64 part = 0; part < 8; ++part) {
+            const auto values = GenerateValues(10000 * (part + 1), part);
+            allValues.insert(allValues.end(), values.begin(), values.end());
+
+            TQuantileSketch sketch;
+            for (auto value : values) {
+                sketch.Add(value);
+            }
+            mergedSketch.Merge(sketch);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(mergedSketch.GetCount(), allValues.size());
+        UNIT_ASSERT(CalcMaxRankError(mergedSketch, allValues) < 0.0165);
+    }
+
+    Y_UNIT_TEST(TestNans) {
+        TQuantileSketch sketch;
+        sketch.Add(std::numeric_limits<float>::quiet_NaN());
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetCount(), 0);
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetNanCount(), 1);
+        UNIT_ASSERT(sketch.GetBorders(1).empty());
+
+        sketch.Add(1.0f);
+        sketch.Add(2.0f);
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetCount(), 2);
+        UNIT_ASSERT_EQUAL(sketch.GetBorders(1), THashSet<float>({1.5f}));
+    }
+}